@@ -41,8 +41,11 @@ function(build_erf_lib erf_lib_name)
                    ${SRC_DIR}/Particles/ERFPCEvolve.cpp
                    ${SRC_DIR}/Particles/ERFPCInitializations.cpp
                    ${SRC_DIR}/Particles/ERFPCUtils.cpp
-                   ${SRC_DIR}/Particles/ERFTracers.cpp)
+                   ${SRC_DIR}/Particles/ERFTracers.cpp
+                   ${SRC_DIR}/Microphysics/SuperDroplets/SuperDropletPC.cpp
+                   ${SRC_DIR}/Microphysics/SuperDroplets/SuperDroplets.cpp)
     target_include_directories(${erf_lib_name} PUBLIC ${SRC_DIR}/Particles)
+    target_include_directories(${erf_lib_name} PUBLIC ${SRC_DIR}/Microphysics/SuperDroplets)
     target_compile_definitions(${erf_lib_name} PUBLIC ERF_USE_PARTICLES)
   endif()
 
@@ -107,6 +110,8 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/ERF.cpp
        ${SRC_DIR}/ERF_make_new_arrays.cpp
        ${SRC_DIR}/ERF_make_new_level.cpp
+       ${SRC_DIR}/ERF_load_balance.cpp
+       ${SRC_DIR}/ERF_memory.cpp
        ${SRC_DIR}/ERF_read_waves.cpp
        ${SRC_DIR}/ERF_Tagging.cpp
        ${SRC_DIR}/Advection/AdvectionSrcForMom.cpp
@@ -149,6 +154,8 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/IO/ERF_Write1DProfiles_stag.cpp
        ${SRC_DIR}/IO/ERF_WriteScalarProfiles.cpp
        ${SRC_DIR}/IO/Plotfile.cpp
+       ${SRC_DIR}/IO/ERF_PlotRegions.cpp
+       ${SRC_DIR}/IO/ERF_Probes.cpp
        ${SRC_DIR}/IO/writeJobInfo.cpp
        ${SRC_DIR}/IO/console_io.cpp
        ${SRC_DIR}/SourceTerms/ERF_ApplySpongeZoneBCs.cpp
@@ -177,12 +184,14 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/Utils/TerrainMetrics.cpp
        ${SRC_DIR}/Utils/VelocityToMomentum.cpp
        ${SRC_DIR}/Utils/InteriorGhostCells.cpp
-       ${SRC_DIR}/Utils/Time_Avg_Vel.cpp
+       ${SRC_DIR}/Utils/FieldStatistics.cpp
+       ${SRC_DIR}/Utils/HorizontalAverages.cpp
+       ${SRC_DIR}/Utils/BoxCosts.cpp
+       ${SRC_DIR}/Utils/TileTuning.cpp
+       ${SRC_DIR}/Utils/MemoryReport.cpp
+       ${SRC_DIR}/Utils/SaturationTable.cpp
        ${SRC_DIR}/Microphysics/SAM/Init_SAM.cpp
-       ${SRC_DIR}/Microphysics/SAM/Cloud_SAM.cpp
-       ${SRC_DIR}/Microphysics/SAM/IceFall.cpp
-       ${SRC_DIR}/Microphysics/SAM/Precip.cpp
-       ${SRC_DIR}/Microphysics/SAM/PrecipFall.cpp
+       ${SRC_DIR}/Microphysics/SAM/Advance_SAM.cpp
        ${SRC_DIR}/Microphysics/SAM/Update_SAM.cpp
        ${SRC_DIR}/Microphysics/Kessler/Init_Kessler.cpp
        ${SRC_DIR}/Microphysics/Kessler/Kessler.cpp
@@ -577,8 +577,8 @@ ERF::FillCoarsePatch (int lev, Real time)
 void
 ERF::FillBdyCCVels (Vector<MultiFab>& mf_cc_vel)
 {
-    // Impose bc's at domain boundaries
-    for (int lev = 0; lev <= finest_level; ++lev)
+    // Impose bc's at domain boundaries at all levels for which mf_cc_vel is defined
+    for (int lev = 0; lev < mf_cc_vel.size(); ++lev)
     {
         Box domain(Geom(lev).Domain());
 
@@ -75,7 +75,10 @@ void ERFFillPatcher::Define (BoxArray const& fba, DistributionMapping const& fdm
     // Delete old MFs if they exist
     if (m_cf_crse_data_old) m_cf_crse_data_old.reset();
     if (m_cf_crse_data_new) m_cf_crse_data_new.reset();
+    if (m_cf_fine_data_old) m_cf_fine_data_old.reset();
+    if (m_cf_fine_data_new) m_cf_fine_data_new.reset();
     if (m_cf_mask) m_cf_mask.reset();
+    if (m_cf_weight) m_cf_weight.reset();
 
     // Index type for the BL/BA
     IndexType m_ixt = fba.ixType();
@@ -85,46 +88,91 @@ void ERFFillPatcher::Define (BoxArray const& fba, DistributionMapping const& fdm
         m_ratio[idim] = m_fgeom.Domain().length(idim) / m_cgeom.Domain().length(idim);
     }
 
+    // Only the band of width -nghost along the coarse-fine boundary of each fine
+    // grid is ever filled, so the interpolated data are only kept there.  The band
+    // of a fine grid may be several boxes; they reach one cell further in the
+    // horizontal for the stencil of the relaxation, they are aligned with the coarse
+    // cells so that the face interpolation has its coarse faces at both ends, and
+    // they are owned by the rank that owns the fine grid.
+    BoxList band_bl = BuildBand(fba, nghost);
+    Box fdomain = convert(m_fgeom.Domain(), m_ixt);
+
+    BoxList fbl;
+    fbl.set(m_ixt);
+    Vector<int> band_pmap;
+    m_band_index.clear();
+    m_band_index.resize(fba.size());
+    for (int i(0); i < fba.size(); ++i) {
+        for (auto const& b : band_bl) {
+            Box fb = fba[i] & b;
+            if (fb.ok()) {
+                fb = refine(coarsen(grow(fb, IntVect(1,1,0)), m_ratio), m_ratio) & fdomain;
+                m_band_index[i].push_back(static_cast<int>(fbl.size()));
+                fbl.push_back(fb);
+                band_pmap.push_back(fdm[i]);
+            }
+        }
+    }
+
     // Coarse box list
     // NOTE: if we use face_cons_linear_interp then CoarseBox returns the grown box
     //       so we don't need to manually grow it here
     BoxList cbl;
     cbl.set(m_ixt);
-    cbl.reserve(fba.size());
-    for (int i(0); i < fba.size(); ++i) {
-        Box coarse_box(interp->CoarseBox(fba[i], m_ratio));
+    cbl.reserve(fbl.size());
+    for (auto const& fb : fbl) {
+        Box coarse_box(interp->CoarseBox(fb, m_ratio));
         cbl.push_back(coarse_box);
     }
 
-    // Box arrays for the coarse data
-    BoxArray cf_cba(std::move(cbl));
+    if (!fbl.isEmpty()) {
+        // Box arrays for the coarse and fine data
+        BoxArray cf_cba(std::move(cbl));
+        BoxArray cf_fba(std::move(fbl));
+        DistributionMapping cf_dm(std::move(band_pmap));
 
-    // Two coarse patches to hold the data to be interpolated
-    m_cf_crse_data_old = std::make_unique<MultiFab> (cf_cba, fdm, m_ncomp, 0);
-    m_cf_crse_data_new = std::make_unique<MultiFab> (cf_cba, fdm, m_ncomp, 0);
+        // Two coarse patches to hold the data to be interpolated
+        m_cf_crse_data_old = std::make_unique<MultiFab> (cf_cba, cf_dm, m_ncomp, 0);
+        m_cf_crse_data_new = std::make_unique<MultiFab> (cf_cba, cf_dm, m_ncomp, 0);
+
+        // The same data interpolated onto the band of the fine grids
+        m_cf_fine_data_old = std::make_unique<MultiFab> (cf_fba, cf_dm, m_ncomp, 0);
+        m_cf_fine_data_new = std::make_unique<MultiFab> (cf_fba, cf_dm, m_ncomp, 0);
+    }
 
     // Integer masking array
     m_cf_mask = std::make_unique<iMultiFab> (fba, fdm, 1, 0);
 
-    // Populate mask array
+    // Populate mask array: the set zone, then the relaxation zone, and
+    // nothing deeper inside the fine grids than the band
     if (nghost_set <= 0) {
         m_cf_mask->setVal(m_set_mask);
         BuildMask(fba,nghost_set,m_set_mask-1);
+        BuildMask(fba,nghost,m_relax_mask-1);
     } else {
         m_cf_mask->setVal(m_relax_mask);
         BuildMask(fba,nghost,m_relax_mask-1);
     }
+
+    // Weights of the relaxation zone
+    BuildRelaxWeight(fba, -nghost, -nghost_set);
 }
 
-void ERFFillPatcher::BuildMask (BoxArray const& fba,
-                                int nghost,
-                                int mask_val)
+/*
+ * Boxes covering the band of width -nghost inside the fine grids along their
+ * coarse-fine boundary; they may overlap each other
+ *
+ * @param[in] fba    BoxArray of the fine grids
+ * @param[in] nghost (minus) width of the band
+ */
+BoxList ERFFillPatcher::BuildBand (BoxArray const& fba,
+                                   int nghost)
 {
     // Minimal bounding box of fine BA plus a halo cell
     Box fba_bnd = grow(fba.minimalBox(), IntVect(1,1,1));
 
-    // BoxList and BoxArray to store complement
-    BoxList com_bl; BoxArray com_ba;
+    // BoxList to store complement
+    BoxList com_bl;
 
     // Compute the complement
     fba.complementIn(com_bl,fba_bnd);
@@ -156,6 +204,19 @@ void ERFFillPatcher::BuildMask (BoxArray const& fba,
         bx &= fba_bnd;
     }
 
+    return com_bl;
+}
+
+void ERFFillPatcher::BuildMask (BoxArray const& fba,
+                                int nghost,
+                                int mask_val)
+{
+    // Minimal bounding box of fine BA plus a halo cell
+    Box fba_bnd = grow(fba.minimalBox(), IntVect(1,1,1));
+
+    // The band along the coarse-fine boundary
+    BoxList com_bl = BuildBand(fba, nghost);
+    BoxArray com_ba;
 
     // Do second complement with the grown boxes
     com_ba.define(std::move(com_bl));
@@ -177,18 +238,147 @@ void ERFFillPatcher::BuildMask (BoxArray const& fba,
 }
 
 /*
- * Register the coarse data to be used by the ERFFillPatcher
+ * Weight of the relaxation at each cell of the band.  A cell at a distance of n
+ * cells from the nearest cell outside the fine grids (n = 1 next to the
+ * coarse-fine boundary) has the weight (width - n)/(width - set_width - 1), which
+ * is one next to the set zone and falls to zero at the inner edge of the
+ * relaxation zone.  The distance is measured in the horizontal, so that it is
+ * also defined near the corners of the fine grids.
+ *
+ * @param[in] fba       BoxArray of the fine grids
+ * @param[in] width     number of cells in the set and relaxation zones
+ * @param[in] set_width number of cells in the set zone
+ */
+void ERFFillPatcher::BuildRelaxWeight (BoxArray const& fba,
+                                       int width,
+                                       int set_width)
+{
+    if (!m_cf_fine_data_old || width <= set_width) return;
+
+    BoxArray const& cf_fba = m_cf_fine_data_old->boxArray();
+    DistributionMapping const& cf_dm = m_cf_fine_data_old->DistributionMap();
+
+    // The zones of the mask on the band; the band reaches beyond the fine grids
+    iMultiFab band_mask(cf_fba, cf_dm, 1, 0);
+    band_mask.setVal(0);
+    band_mask.ParallelCopy(*m_cf_mask);
+
+    // One on the cells covered by the fine grids, within reach of the band
+    iMultiFab covered(cf_fba, cf_dm, 1, IntVect(width,width,0));
+    covered.setVal(0);
+    for (MFIter mfi(covered); mfi.isValid(); ++mfi) {
+        const Array4<int>& cov_arr = covered.array(mfi);
+        for (auto const& is : fba.intersections(mfi.fabbox())) {
+            ParallelFor(is.second, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                cov_arr(i,j,k) = 1;
+            });
+        }
+    }
+
+    m_cf_weight = std::make_unique<MultiFab>(cf_fba, cf_dm, 1, 0);
+
+    int relax_mask = m_relax_mask;
+    int relax_z    = width - set_width;
+
+    for (MFIter mfi(*m_cf_weight); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        const Array4<Real>&       wgt_arr = m_cf_weight->array(mfi);
+        const Array4<int const>& mask_arr = band_mask.const_array(mfi);
+        const Array4<int const>&  cov_arr = covered.const_array(mfi);
+
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            Real wgt = 0.0;
+            if (mask_arr(i,j,k) == relax_mask) {
+                Real dist2 = Real(width*width);
+                for (int jj(-width); jj <= width; ++jj) {
+                    for (int ii(-width); ii <= width; ++ii) {
+                        if (cov_arr(i+ii,j+jj,k) == 0) {
+                            dist2 = amrex::min(dist2, Real(ii*ii + jj*jj));
+                        }
+                    }
+                }
+                Real n_ind = std::sqrt(dist2);
+                wgt = (relax_z > 1) ? amrex::max(Real(0.0), (width - n_ind) / Real(relax_z - 1)) : Real(1.0);
+            }
+            wgt_arr(i,j,k) = wgt;
+        });
+    }
+
+    // The band boxes of a fine grid overlap, and each cell must be relaxed once: it
+    // keeps its weight only in the first band box whose target data also cover its
+    // horizontal neighbors
+    for (int i(0); i < fba.size(); ++i) {
+        if (m_fdm[i] != ParallelDescriptor::MyProc()) continue;
+
+        Vector<int> const& band = m_band_index[i];
+        for (int p(0); p < band.size(); ++p) {
+            const Array4<Real>& wgt_arr = m_cf_weight->array(band[p]);
+
+            Box inner = grow(cf_fba[band[p]], IntVect(-1,-1,0));
+            BoxList zero_bl = boxDiff(cf_fba[band[p]], inner);
+            for (int q(0); q < p; ++q) {
+                Box both = inner & grow(cf_fba[band[q]], IntVect(-1,-1,0));
+                if (both.ok()) zero_bl.push_back(both);
+            }
+
+            for (auto const& b : zero_bl) {
+                ParallelFor(b, [=] AMREX_GPU_DEVICE (int ii, int jj, int kk) noexcept
+                {
+                    wgt_arr(ii,jj,kk) = 0.0;
+                });
+            }
+        }
+    }
+}
+
+/*
+ * Bytes of the coarse and fine data, mask and weights held on this rank
+ */
+Long ERFFillPatcher::nBytes () const
+{
+    Long nbytes = 0;
+    for (auto const* mf : {m_cf_crse_data_old.get(), m_cf_crse_data_new.get(),
+                           m_cf_fine_data_old.get(), m_cf_fine_data_new.get(),
+                           m_cf_weight.get()}) {
+        if (!mf) continue;
+        for (int i : mf->IndexArray()) {
+            nbytes += mf->fabbox(i).numPts() * mf->nComp() * sizeof(Real);
+        }
+    }
+    if (m_cf_mask) {
+        for (int i : m_cf_mask->IndexArray()) {
+            nbytes += m_cf_mask->fabbox(i).numPts() * sizeof(int);
+        }
+    }
+    return nbytes;
+}
+
+/*
+ * Register the coarse data to be used by the ERFFillPatcher and interpolate
+ * it onto the fine grids; this is done once per coarse step
  *
  * @param[in] crse_data data at old and new time at coarse level
  * @param[in] crse_time times at which crse_data is defined
+ * @param[in] bcr       boundary conditions for the cell-centered interpolation
  */
 
 void ERFFillPatcher::RegisterCoarseData (Vector<MultiFab const*> const& crse_data,
-                                         Vector<Real> const& crse_time)
+                                         Vector<Real> const& crse_time,
+                                         Vector<BCRec> const& bcr)
 {
     AMREX_ALWAYS_ASSERT(crse_data.size() == 2); // old and new
     AMREX_ALWAYS_ASSERT(crse_time[1] >= crse_time[0]);
 
+    m_crse_times[0] = crse_time[0]; // time of "old" coarse data
+    m_crse_times[1] = crse_time[1]; // time of "new" coarse data
+
+    m_dt_crse = crse_time[1] - crse_time[0];
+
+    // No fine grid touches the coarse-fine boundary
+    if (!m_cf_fine_data_old) return;
+
     // NOTE: CoarseBox with CellConsLinear interpolation grows the
     //       box by 1 in all directions. This pushes the domain for
     //       m_cf_crse_data into ghost cells in the z-dir. So we need
@@ -201,15 +391,29 @@ void ERFFillPatcher::RegisterCoarseData (Vector<MultiFab const*> const& crse_dat
     m_cf_crse_data_new->ParallelCopy(*(crse_data[1]), 0, 0, m_ncomp,
                                     src_ng, dst_ng, m_cgeom.periodicity()); // new data
 
-    m_crse_times[0] = crse_time[0]; // time of "old" coarse data
-    m_crse_times[1] = crse_time[1]; // time of "new" coarse data
-
-    m_dt_crse = crse_time[1] - crse_time[0];
+    // Interpolate both snapshots in space now so that every fine stage and
+    // substep only needs to blend them in time
+    IndexType m_ixt = m_fba.ixType();
+    int ixt_sum = m_ixt[0]+m_ixt[1]+m_ixt[2];
+    if (ixt_sum == 0) {
+        InterpCell(*m_cf_fine_data_old, *m_cf_crse_data_old, bcr);
+        InterpCell(*m_cf_fine_data_new, *m_cf_crse_data_new, bcr);
+    } else if (ixt_sum == 1) {
+        InterpFace(*m_cf_fine_data_old, *m_cf_crse_data_old);
+        InterpFace(*m_cf_fine_data_new, *m_cf_crse_data_new);
+    } else {
+        amrex::Abort("ERF_FillPatcher only supports face linear and cell cons linear interp!");
+    }
 }
 
+/*
+ * Interpolate face data onto the fine faces of the band
+ *
+ * @param[out] fine fine data on the band
+ * @param[in]  crse coarse data on the coarsened band
+ */
 void ERFFillPatcher::InterpFace (MultiFab& fine,
-                                 MultiFab const& crse,
-                                 int mask_val)
+                                 MultiFab const& crse)
 {
     int ncomp = 1;
     IntVect ratio = m_ratio;
@@ -241,18 +445,15 @@ void ERFFillPatcher::InterpFace (MultiFab& fine,
         Array4<Real> const&       fine_arr = fine.array(mfi);
         Array4<Real> const&      slope_arr = slope.array();
         Array4<Real const> const& crse_arr = crse.const_array(mfi);
-        Array4<int const> const&  mask_arr = m_cf_mask->const_array(mfi);
 
         if (fbx.type(0) == IndexType::NODE) // x-faces
         {
             // Here do interpolation in the tangential directions
             AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG(RunOn::Gpu,fbx,i,j,k,
             {
-                if (mask_arr(i,j,k) == mask_val) { // x-faces
-                    const int ii = coarsen(i,ratio[0]);
-                    if (i-ii*ratio[0] == 0) {
-                        interp_face_reg(i,j,k,ratio,fine_arr,0,crse_arr,slope_arr,ncomp,per_grown_domain,0);
-                    }
+                const int ii = coarsen(i,ratio[0]);
+                if (i-ii*ratio[0] == 0) {
+                    interp_face_reg(i,j,k,ratio,fine_arr,0,crse_arr,slope_arr,ncomp,per_grown_domain,0);
                 }
             });
 
@@ -260,12 +461,10 @@ void ERFFillPatcher::InterpFace (MultiFab& fine,
             //    using the fine values that have already been filled
             AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG(RunOn::Gpu,fbx,i,j,k,
             {
-                if (mask_arr(i,j,k) == mask_val) {
-                    const int ii = coarsen(i,ratio[0]);
-                    if (i-ii*ratio[0] != 0) {
-                        Real const w = static_cast<Real>(i-ii*ratio[0]) * (Real(1.)/Real(ratio[0]));
-                        fine_arr(i,j,k,0) = (Real(1.)-w) * fine_arr(ii*ratio[0],j,k,0) + w * fine_arr((ii+1)*ratio[0],j,k,0);
-                    }
+                const int ii = coarsen(i,ratio[0]);
+                if (i-ii*ratio[0] != 0) {
+                    Real const w = static_cast<Real>(i-ii*ratio[0]) * (Real(1.)/Real(ratio[0]));
+                    fine_arr(i,j,k,0) = (Real(1.)-w) * fine_arr(ii*ratio[0],j,k,0) + w * fine_arr((ii+1)*ratio[0],j,k,0);
                 }
             });
 
@@ -275,11 +474,9 @@ void ERFFillPatcher::InterpFace (MultiFab& fine,
             // Here do interpolation in the tangential directions
             AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG(RunOn::Gpu,fbx,i,j,k,
             {
-                if (mask_arr(i,j,k) == mask_val) {
-                    const int jj = coarsen(j,ratio[1]);
-                    if (j-jj*ratio[1] == 0) {
-                        interp_face_reg(i,j,k,ratio,fine_arr,0,crse_arr,slope_arr,ncomp,per_grown_domain,1);
-                    }
+                const int jj = coarsen(j,ratio[1]);
+                if (j-jj*ratio[1] == 0) {
+                    interp_face_reg(i,j,k,ratio,fine_arr,0,crse_arr,slope_arr,ncomp,per_grown_domain,1);
                 }
             });
 
@@ -287,12 +484,10 @@ void ERFFillPatcher::InterpFace (MultiFab& fine,
             //    using the fine values that have already been filled
             AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG(RunOn::Gpu,fbx,i,j,k,
             {
-                if (mask_arr(i,j,k) == mask_val) {
-                    const int jj = coarsen(j,ratio[1]);
-                    if (j-jj*ratio[1] != 0) {
-                        Real const w = static_cast<Real>(j-jj*ratio[1]) * (Real(1.)/Real(ratio[1]));
-                        fine_arr(i,j,k,0) = (Real(1.)-w) * fine_arr(i,jj*ratio[1],k,0) + w * fine_arr(i,(jj+1)*ratio[1],k,0);
-                    }
+                const int jj = coarsen(j,ratio[1]);
+                if (j-jj*ratio[1] != 0) {
+                    Real const w = static_cast<Real>(j-jj*ratio[1]) * (Real(1.)/Real(ratio[1]));
+                    fine_arr(i,j,k,0) = (Real(1.)-w) * fine_arr(i,jj*ratio[1],k,0) + w * fine_arr(i,(jj+1)*ratio[1],k,0);
                 }
             });
         }
@@ -301,11 +496,9 @@ void ERFFillPatcher::InterpFace (MultiFab& fine,
             // Here do interpolation in the tangential directions
             AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG(RunOn::Gpu,fbx,i,j,k,
             {
-                if (mask_arr(i,j,k) == mask_val) {
-                    const int kk = coarsen(k,ratio[2]);
-                    if (k-kk*ratio[2] == 0) {
-                        interp_face_reg(i,j,k,ratio,fine_arr,0,crse_arr,slope_arr,1,per_grown_domain,2);
-                    }
+                const int kk = coarsen(k,ratio[2]);
+                if (k-kk*ratio[2] == 0) {
+                    interp_face_reg(i,j,k,ratio,fine_arr,0,crse_arr,slope_arr,1,per_grown_domain,2);
                 }
             });
 
@@ -313,22 +506,26 @@ void ERFFillPatcher::InterpFace (MultiFab& fine,
             //    using the fine values that have already been filled
             AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG(RunOn::Gpu,fbx,i,j,k,
             {
-                if (mask_arr(i,j,k) == mask_val) {
-                    const int kk = coarsen(k,ratio[2]);
-                    if (k-kk*ratio[2] != 0) {
-                        Real const w = static_cast<Real>(k-kk*ratio[2]) * (Real(1.)/Real(ratio[2]));
-                        fine_arr(i,j,k,0) = (Real(1.)-w) * fine_arr(i,j,kk*ratio[2],0) + w * fine_arr(i,j,(kk+1)*ratio[2],0);
-                    }
+                const int kk = coarsen(k,ratio[2]);
+                if (k-kk*ratio[2] != 0) {
+                    Real const w = static_cast<Real>(k-kk*ratio[2]) * (Real(1.)/Real(ratio[2]));
+                    fine_arr(i,j,k,0) = (Real(1.)-w) * fine_arr(i,j,kk*ratio[2],0) + w * fine_arr(i,j,(kk+1)*ratio[2],0);
                 }
             });
         } // IndexType::NODE
     } // MFiter
 }
 
+/*
+ * Interpolate cell-centered data onto the fine cells of the band
+ *
+ * @param[out] fine fine data on the band
+ * @param[in]  crse coarse data on the coarsened band
+ * @param[in]  bcr  boundary conditions used for the slopes
+ */
 void ERFFillPatcher::InterpCell (MultiFab& fine,
                                  MultiFab const& crse,
-                                 Vector<BCRec> const& bcr,
-                                 int mask_val)
+                                 Vector<BCRec> const& bcr)
 {
     int ncomp = m_ncomp;
     IntVect ratio = m_ratio;
@@ -340,7 +537,6 @@ void ERFFillPatcher::InterpCell (MultiFab& fine,
 
         Array4<Real> const&       fine_arr = fine.array(mfi);
         Array4<Real const> const& crse_arr = crse.const_array(mfi);
-        Array4<int const> const&  mask_arr = m_cf_mask->const_array(mfi);
 
         bool run_on_gpu = Gpu::inLaunchRegion();
         amrex::ignore_unused(run_on_gpu);
@@ -374,8 +570,7 @@ void ERFFillPatcher::InterpCell (MultiFab& fine,
 
         AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(RunOn::Gpu, fbx, ncomp, i, j, k, n,
         {
-            if (mask_arr(i,j,k) == mask_val) mf_cell_cons_lin_interp(i,j,k,n, fine_arr, 0, ctmp,
-                                                                     crse_arr, 0, ncomp, ratio);
+            mf_cell_cons_lin_interp(i,j,k,n, fine_arr, 0, ctmp, crse_arr, 0, ncomp, ratio);
         });
     } // MFIter
 }
@@ -6,6 +6,55 @@ using namespace amrex;
 
 namespace derived {
 
+namespace {
+// Note that "fused" variables must be contiguous in ERF::derived_names
+const DerivedVarInfo derived_table[] = {
+    {"vorticity_x", DerInput::CCVel | DerInput::CCVelGhost      , false},
+    {"vorticity_y", DerInput::CCVel | DerInput::CCVelGhost      , false},
+    {"vorticity_z", DerInput::CCVel | DerInput::CCVelGhost      , false},
+    {"magvel"     , DerInput::CCVel                             , false},
+    {"x_velocity" , DerInput::CCVel                             , false},
+    {"y_velocity" , DerInput::CCVel                             , false},
+    {"z_velocity" , DerInput::CCVel                             , false},
+    {"pressure"   , DerInput::Pressure                          , true },
+    {"pert_pres"  , DerInput::Pressure | DerInput::BaseState    , true },
+    {"pert_dens"  , DerInput::BaseState                         , true },
+    {"eq_pot_temp", DerInput::Pressure                          , true },
+    {"dpdx"       , DerInput::Pressure | DerInput::PressureGhost, true },
+    {"dpdy"       , DerInput::Pressure | DerInput::PressureGhost, true },
+    {"pres_hse_x" , DerInput::BaseState                         , true },
+    {"pres_hse_y" , DerInput::BaseState                         , true },
+    {"qsat"       , DerInput::Pressure                          , true }
+};
+}
+
+const DerivedVarInfo*
+find_derived (const std::string& name)
+{
+    for (const auto& info : derived_table) {
+        if (name == info.name) return &info;
+    }
+    return nullptr;
+}
+
+int
+derived_inputs (const Vector<std::string>& names)
+{
+    int inputs = DerInput::None;
+    for (const auto& name : names) {
+        const DerivedVarInfo* info = find_derived(name);
+        if (info) inputs |= info->inputs;
+    }
+    return inputs;
+}
+
+bool
+is_fused_derived (const std::string& name)
+{
+    const DerivedVarInfo* info = find_derived(name);
+    return (info && info->fused);
+}
+
 /**
  * Function to define a derived quantity by dividing by density
  * (analogous to cons_to_prim)
@@ -13,6 +13,7 @@
 
 #include <Utils.H>
 #include <TerrainMetrics.H>
+#include <TileTuning.H>
 #include <memory>
 
 #ifdef ERF_USE_MULTIBLOCK
@@ -24,7 +25,8 @@ using namespace amrex;
 Real ERF::startCPUTime        = 0.0;
 Real ERF::previousCPUTimeUsed = 0.0;
 
-Vector<AMRErrorTag> ERF::ref_tags;
+Vector<TagCriterion> ERF::ref_tags;
+Vector<TagGroup>     ERF::ref_tag_groups;
 
 SolverChoice ERF::solverChoice;
 
@@ -125,11 +127,18 @@ ERF::ERF ()
 #endif
 
 #if defined(ERF_USE_RRTMGP)
+    rad.resize(nlevs_max);
     qheating_rates.resize(nlevs_max);
     sw_lw_fluxes.resize(nlevs_max);
     solar_zenith.resize(nlevs_max);
+    rad_needs_update.resize(nlevs_max, 1);
 #endif
 
+    micro_tendency.resize(nlevs_max);
+    micro_accum_rate.resize(nlevs_max);
+    micro_step_count.resize(nlevs_max, 0);
+    micro_diag_stale.resize(nlevs_max, 0);
+
     // NOTE: size lsm before readparams (chooses the model at all levels)
     lsm.ReSize(nlevs_max);
     lsm_data.resize(nlevs_max);
@@ -144,6 +153,7 @@ ERF::ERF ()
 
     const std::string& pv1 = "plot_vars_1"; setPlotVariables(pv1,plot_var_names_1);
     const std::string& pv2 = "plot_vars_2"; setPlotVariables(pv2,plot_var_names_2);
+    ReadPlotRegions();
 
     // Initialize staggered vertical levels for grid stretching or terrain.
 
@@ -179,7 +189,11 @@ ERF::ERF ()
     istep.resize(nlevs_max, 0);
     nsubsteps.resize(nlevs_max, 1);
     for (int lev = 1; lev <= max_level; ++lev) {
-        nsubsteps[lev] = MaxRefRatio(lev-1);
+        if (subcycling_mode == "Manual") {
+            nsubsteps[lev] = subcycling_iterations[lev];
+        } else if (subcycling_mode != "None") {
+            nsubsteps[lev] = MaxRefRatio(lev-1);
+        }
     }
 
     t_new.resize(nlevs_max, 0.0);
@@ -296,10 +310,6 @@ ERF::ERF ()
     // Qv prim for MOST
     Qv_prim.resize(nlevs_max);
 
-    // Time averaged velocity field
-    vel_t_avg.resize(nlevs_max);
-    t_avg_cnt.resize(nlevs_max);
-
 #ifdef ERF_USE_NETCDF
     // Size lat long arrays if using netcdf
     lat_m.resize(nlevs_max);
@@ -374,6 +384,15 @@ ERF::Evolve ()
             last_plot_file_step_2 = step+1;
             WritePlotFile(2,plot_var_names_2);
         }
+        for (auto& reg : plot_regions) {
+            if (writeNow(cur_time, dt[0], step+1, reg.plot_int, reg.plot_per)) {
+                reg.last_plot_step = step+1;
+                WritePlotRegion(reg);
+            }
+        }
+        if (probes.active() && writeNow(cur_time, dt[0], step+1, probes.interval(), probes.period())) {
+            probes.sample(cur_time, finest_level, geom, vars_new);
+        }
 
         if (writeNow(cur_time, dt[0], step+1, m_check_int, m_check_per)) {
             last_check_file_step = step+1;
@@ -405,6 +424,14 @@ ERF::Evolve ()
     if ( (m_plot_int_2 > 0 || m_plot_per_2 > 0.) && istep[0] > last_plot_file_step_2) {
         WritePlotFile(2,plot_var_names_2);
     }
+    for (auto& reg : plot_regions) {
+        if ( (reg.plot_int > 0 || reg.plot_per > 0.) && istep[0] > reg.last_plot_step) {
+            WritePlotRegion(reg);
+        }
+    }
+
+    // Write out any probe samples still in the buffer
+    probes.flush();
 
     if ( (m_check_int > 0 || m_check_per > 0.) && istep[0] > last_check_file_step) {
 #ifdef ERF_USE_NETCDF
@@ -430,62 +457,6 @@ ERF::post_timestep (int nstep, Real time, Real dt_lev0)
     particleData.Redistribute();
 #endif
 
-    if (solverChoice.coupling_type == CouplingType::TwoWay)
-    {
-        bool use_terrain = solverChoice.use_terrain;
-        int ncomp = vars_new[0][Vars::cons].nComp();
-        for (int lev = finest_level-1; lev >= 0; lev--)
-        {
-            // The quantity that is conserved is not (rho S), but rather (rho S / m^2) where
-            // m is the map scale factor at cell centers
-            // Here we pre-divide (rho S) by m^2 before refluxing
-            for (MFIter mfi(vars_new[lev][Vars::cons], TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-                const Box& bx = mfi.tilebox();
-                const Array4<      Real>   cons_arr = vars_new[lev][Vars::cons].array(mfi);
-                const Array4<const Real> mapfac_arr = mapfac_m[lev]->const_array(mfi);
-                if (use_terrain) {
-                    const Array4<const Real>   detJ_arr = detJ_cc[lev]->const_array(mfi);
-                    ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                    {
-                        cons_arr(i,j,k,n) *= detJ_arr(i,j,k) / (mapfac_arr(i,j,0)*mapfac_arr(i,j,0));
-                    });
-                } else {
-                    ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                    {
-                        cons_arr(i,j,k,n) /= (mapfac_arr(i,j,0)*mapfac_arr(i,j,0));
-                    });
-                }
-            } // mfi
-
-            // This call refluxes from the lev/lev+1 interface onto lev
-            getAdvFluxReg(lev+1)->Reflux(vars_new[lev][Vars::cons], 0, 0, ncomp);
-
-            // Here we multiply (rho S) by m^2 after refluxing
-            for (MFIter mfi(vars_new[lev][Vars::cons], TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-                const Box& bx = mfi.tilebox();
-                const Array4<      Real>   cons_arr = vars_new[lev][Vars::cons].array(mfi);
-                const Array4<const Real> mapfac_arr = mapfac_m[lev]->const_array(mfi);
-                if (use_terrain) {
-                    const Array4<const Real>   detJ_arr = detJ_cc[lev]->const_array(mfi);
-                    ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                    {
-                        cons_arr(i,j,k,n) *= (mapfac_arr(i,j,0)*mapfac_arr(i,j,0)) / detJ_arr(i,j,k);
-                    });
-                } else {
-                    ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                    {
-                        cons_arr(i,j,k,n) *= (mapfac_arr(i,j,0)*mapfac_arr(i,j,0));
-                    });
-                }
-            } // mfi
-
-            // We need to do this before anything else because refluxing changes the
-            // values of coarse cells underneath fine grids with the assumption they'll
-            // be over-written by averaging down
-            AverageDownTo(lev,0,ncomp);
-        }
-    }
-
     if (is_it_time_for_action(nstep, time, dt_lev0, sum_interval, sum_per)) {
         sum_integrated_quantities(time);
     }
@@ -584,6 +555,11 @@ ERF::InitData ()
         Abort("We do not allow non-static terrain_type with use_terrain = false");
     }
 
+    // The particles of a Lagrangian moisture model only live on level 0
+    if (Microphysics::modelType(solverChoice.moisture_type) == MoistureModelType::Lagrangian && max_level > 0) {
+        Abort("Mesh refinement (amr.max_level > 0) with a Lagrangian moisture model is not supported yet");
+    }
+
     last_plot_file_step_1 = -1;
     last_plot_file_step_2 = -1;
     last_check_file_step  = -1;
@@ -700,6 +676,10 @@ ERF::InitData ()
 
     } else { // Restart from a checkpoint
 
+        if (Microphysics::modelType(solverChoice.moisture_type) == MoistureModelType::Lagrangian) {
+            Abort("Restarting with a Lagrangian moisture model is not supported yet");
+        }
+
         restart();
 
 
@@ -980,13 +960,14 @@ ERF::InitData ()
         for (int lev = 0; lev <= finest_level; ++lev) micro->Update_Micro_Vars_Lev(lev, vars_new[lev][Vars::cons]);
     }
 
-    // Fill time averaged velocities before first plot file
-    if (solverChoice.time_avg_vel) {
+    // Add the initial state to the statistics before first plot file
+    if (field_stats.active() && restart_chkfile.empty()) {
         for (int lev = 0; lev <= finest_level; ++lev) {
-            Time_Avg_Vel_atCC(dt[lev], t_avg_cnt[lev], vel_t_avg[lev].get(),
-                              vars_new[lev][Vars::xvel],
-                              vars_new[lev][Vars::yvel],
-                              vars_new[lev][Vars::zvel]);
+            field_stats.accumulate(lev, t_new[lev], dt[lev],
+                                   vars_new[lev][Vars::cons],
+                                   vars_new[lev][Vars::xvel],
+                                   vars_new[lev][Vars::yvel],
+                                   vars_new[lev][Vars::zvel]);
         }
     }
 
@@ -994,6 +975,9 @@ ERF::InitData ()
     // are setup.
     const std::string& pv1 = "plot_vars_1"; appendPlotVariables(pv1,plot_var_names_1);
     const std::string& pv2 = "plot_vars_2"; appendPlotVariables(pv2,plot_var_names_2);
+    for (auto& reg : plot_regions) {
+        appendPlotVariables(reg.name + ".plot_vars", reg.plot_var_names);
+    }
 
     if ( restart_chkfile.empty() && (m_check_int > 0 || m_check_per > 0.) )
     {
@@ -1021,6 +1005,12 @@ ERF::InitData ()
             WritePlotFile(2,plot_var_names_2);
             last_plot_file_step_2 = istep[0];
         }
+        for (auto& reg : plot_regions) {
+            if (reg.plot_int > 0 || reg.plot_per > 0.) {
+                WritePlotRegion(reg);
+                reg.last_plot_step = istep[0];
+            }
+        }
     }
 
     // Set these up here because we need to know which MPI rank "cell" is on...
@@ -1075,6 +1065,12 @@ ERF::InitData ()
 
     }
 
+    // Probes need the level 0 geometry to discard locations outside the domain
+    probes.init(pp_prefix, geom[0]);
+    if (probes.active() && restart_chkfile.empty()) {
+        probes.sample(t_new[0], finest_level, geom, vars_new);
+    }
+
     if (pp.contains("sample_line_log") && pp.contains("sample_line"))
     {
         int lev = 0;
@@ -1107,6 +1103,8 @@ ERF::InitData ()
 
     BL_PROFILE_VAR_STOP(InitData);
 
+    ReportMemory("initialization");
+
 #ifdef ERF_USE_EB
     bool write_eb_surface = false;
     pp.query("write_eb_surface", write_eb_surface);
@@ -1290,6 +1288,55 @@ ERF::ReadParameters ()
         pp.query("restart_type", restart_type);
 
         pp.query("regrid_int", regrid_int);
+        pp.query("static_nest", static_nest);
+        pp.query("delta_regrid", delta_regrid);
+
+        // Space-filling-curve ordering of the boxes and their distribution
+        pp.query("sfc_box_order", sfc_box_order);
+        pp.query("numa_first_touch", numa_first_touch);
+
+        pp.query("memory_report", memory_report);
+        pp.query("memory_budget_per_rank", memory_budget_per_rank);
+
+        // How many time steps each level takes per time step of the next coarser level
+        pp_amr.query("subcycling_mode", subcycling_mode);
+        if (subcycling_mode != "Auto"   && subcycling_mode != "None" &&
+            subcycling_mode != "Manual" && subcycling_mode != "Optimal") {
+            Abort("amr.subcycling_mode must be Auto, None, Manual or Optimal");
+        }
+        if (subcycling_mode == "Manual") {
+            int nvals = pp_amr.countval("subcycling_iterations");
+            if (nvals == 1) {
+                int n; pp_amr.get("subcycling_iterations", n);
+                subcycling_iterations.assign(max_level+1, n);
+            } else if (nvals == max_level+1) {
+                pp_amr.getarr("subcycling_iterations", subcycling_iterations, 0, max_level+1);
+            } else {
+                Abort("amr.subcycling_iterations must have one value or one per level");
+            }
+            for (int lev = 1; lev <= max_level; ++lev) {
+                if (subcycling_iterations[lev] < 1) {
+                    Abort("amr.subcycling_iterations must be positive");
+                }
+            }
+        }
+
+        pp.query("tag_advect", tag_advect);
+        pp.query("tag_advect_max_cells", tag_advect_max_cells);
+        if (tag_advect_max_cells < 0) {
+            Abort("erf.tag_advect_max_cells must be non-negative");
+        }
+
+        pp.query("load_balance_int", load_balance_int);
+        pp.query("load_balance_method", load_balance_method);
+        pp.query("load_balance_efficiency_ratio_threshold", load_balance_efficiency_ratio_threshold);
+        if (load_balance_method != "knapsack" && load_balance_method != "sfc") {
+            Abort("erf.load_balance_method must be knapsack or sfc");
+        }
+
+        // Tile sizes of the major kernel families, tuned during the first steps or read from a file
+        TileTuning::init(pp_prefix, max_level+1);
+
         pp.query("check_file", check_file);
         pp.query("check_type", check_type);
 
@@ -1316,6 +1363,15 @@ ERF::ReadParameters ()
 
         pp.query("pert_interval", pert_interval);
 
+#if defined(ERF_USE_RRTMGP)
+        // Frequency of radiation calls
+        pp.query("radiation_interval", rad_interval);
+        pp.query("radiation_per"     , rad_per);
+        if (rad_interval > 0 && rad_per > 0.) {
+            Abort("Must choose only one of radiation_interval or radiation_per");
+        }
+#endif
+
         // Time step controls
         pp.query("cfl", cfl);
         pp.query("init_shrink", init_shrink);
@@ -1507,6 +1563,10 @@ ERF::ReadParameters ()
 
     solverChoice.init_params(max_level);
 
+    // Which running statistics to accumulate
+    // NOTE: Must be read after init_params (time_avg_vel)
+    field_stats.init(pp_prefix, max_level+1, solverChoice.time_avg_vel);
+
     // What type of land surface model to use
     // NOTE: Must be checked after init_params
     if (solverChoice.lsm_type == LandSurfaceType::SLM) {
@@ -1544,8 +1604,8 @@ ERF::MakeHorizontalAverages ()
     }
 
     MultiFab mf(grids[lev], dmap[lev], 5, 0);
+    mf.setVal(0.0);
 
-    int zdir = 2;
     auto domain = geom[0].Domain();
 
     bool use_moisture = (solverChoice.moisture_type != MoistureType::None);
@@ -1580,31 +1640,21 @@ ERF::MakeHorizontalAverages ()
                 fab_arr(i, j, k, 4) = (ncomp > RhoQ2_comp ? cons_arr(i, j, k, RhoQ2_comp) / dens : 0.0);
             });
         }
-
-        Gpu::HostVector<Real> h_avg_qv          = sumToLine(mf,3,1,domain,zdir);
-        Gpu::HostVector<Real> h_avg_qc          = sumToLine(mf,4,1,domain,zdir);
     }
 
-    // Sum in the horizontal plane
-    Gpu::HostVector<Real> h_avg_density     = sumToLine(mf,0,1,domain,zdir);
-    Gpu::HostVector<Real> h_avg_temperature = sumToLine(mf,1,1,domain,zdir);
-    Gpu::HostVector<Real> h_avg_pressure    = sumToLine(mf,2,1,domain,zdir);
-
-    // Divide by the total number of cells we are averaging over
-    int size_z = domain.length(zdir);
-    Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
-    int klen = static_cast<int>(h_avg_density.size());
+    // Average all five quantities in the horizontal plane with one pass and one reduction
+    Gpu::HostVector<Real> h_avg = HorizontalAverages(mf, 0, 5, domain);
 
-    for (int k = 0; k < klen; ++k) {
-        h_havg_density[k]     /= area_z;
-        h_havg_temperature[k] /= area_z;
-        h_havg_pressure[k]    /= area_z;
-        if (solverChoice.moisture_type != MoistureType::None)
-        {
-            h_havg_qc[k]          /= area_z;
-            h_havg_qv[k]          /= area_z;
-        }
-    } // k
+    int size_z = domain.length(2);
+    auto profile = [&] (Vector<Real>& h_prof, int n)
+    {
+        h_prof.resize(size_z);
+        std::copy(h_avg.begin() +  n   *size_z,
+                  h_avg.begin() + (n+1)*size_z, h_prof.begin());
+    };
+    profile(h_havg_density    , 0);
+    profile(h_havg_temperature, 1);
+    profile(h_havg_pressure   , 2);
 
     // resize device vectors
     d_havg_density.resize(size_z, 0.0_rt);
@@ -1616,8 +1666,11 @@ ERF::MakeHorizontalAverages ()
     Gpu::copy(Gpu::hostToDevice, h_havg_temperature.begin(), h_havg_temperature.end(), d_havg_temperature.begin());
     Gpu::copy(Gpu::hostToDevice, h_havg_pressure.begin(), h_havg_pressure.end(), d_havg_pressure.begin());
 
-    if (solverChoice.moisture_type != MoistureType::None)
+    if (use_moisture)
     {
+        profile(h_havg_qv, 3);
+        profile(h_havg_qc, 4);
+
         d_havg_qv.resize(size_z, 0.0_rt);
         d_havg_qc.resize(size_z, 0.0_rt);
         Gpu::copy(Gpu::hostToDevice, h_havg_qv.begin(), h_havg_qv.end(), d_havg_qv.begin());
@@ -1631,47 +1684,11 @@ ERF::MakeHorizontalAverages ()
 void // NOLINTNEXTLINE
 ERF::MakeDiagnosticAverage (Vector<Real>& h_havg, MultiFab& S, int n)
 {
-    // Get the number of cells in z at level 0
-    int dir_z = AMREX_SPACEDIM-1;
     auto domain = geom[0].Domain();
-    int size_z = domain.length(dir_z);
-    int start_z = domain.smallEnd()[dir_z];
-    Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
-
-    // resize the level 0 horizontal average vectors
-    h_havg.resize(size_z, 0.0_rt);
+    Gpu::HostVector<Real> h_avg = HorizontalAverages(S, n, 1, domain);
 
-    // Get the cell centered data and construct sums
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-    for (MFIter mfi(S); mfi.isValid(); ++mfi) {
-        const Box& box = mfi.validbox();
-        const IntVect& se = box.smallEnd();
-        const IntVect& be = box.bigEnd();
-
-        auto      fab_arr = S[mfi].array();
-
-        FArrayBox fab_reduce(box, 1, The_Async_Arena());
-        auto arr_reduce   = fab_reduce.array();
-
-        ParallelFor(box, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-            arr_reduce(i, j, k, 0) = fab_arr(i,j,k,n);
-        });
-
-        for (int k=se[dir_z]; k <= be[dir_z]; ++k) {
-            Box kbox(box); kbox.setSmall(dir_z,k); kbox.setBig(dir_z,k);
-            h_havg[k-start_z] += fab_reduce.sum<RunOn::Device>(kbox,0);
-        }
-    }
-
-    // combine sums from different MPI ranks
-    ParallelDescriptor::ReduceRealSum(h_havg.dataPtr(), h_havg.size());
-
-    // divide by the total number of cells we are averaging over
-    for (int k = 0; k < size_z; ++k) {
-        h_havg[k]     /= area_z;
-    }
+    h_havg.resize(h_avg.size());
+    std::copy(h_avg.begin(), h_avg.end(), h_havg.begin());
 }
 
 // Set covered coarse cells to be the average of overlying fine cells for all levels
@@ -1687,6 +1704,73 @@ ERF::AverageDown ()
     }
 }
 
+/**
+ * Reflux the coarse level from the fluxes accumulated at its interface with the next
+ * finer level, then average the finer level down onto it.  This is called after the
+ * finer level has taken all of its substeps within a coarse step.
+ *
+ * @param[in] lev coarse level
+ */
+void
+ERF::RefluxAndAverageDown (int lev)
+{
+    AMREX_ALWAYS_ASSERT(solverChoice.coupling_type == CouplingType::TwoWay);
+
+    bool use_terrain = solverChoice.use_terrain;
+    int ncomp = vars_new[lev][Vars::cons].nComp();
+
+    // The quantity that is conserved is not (rho S), but rather (rho S / m^2) where
+    // m is the map scale factor at cell centers
+    // Here we pre-divide (rho S) by m^2 before refluxing
+    for (MFIter mfi(vars_new[lev][Vars::cons], TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.tilebox();
+        const Array4<      Real>   cons_arr = vars_new[lev][Vars::cons].array(mfi);
+        const Array4<const Real> mapfac_arr = mapfac_m[lev]->const_array(mfi);
+        if (use_terrain) {
+            const Array4<const Real>   detJ_arr = detJ_cc[lev]->const_array(mfi);
+            ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                cons_arr(i,j,k,n) *= detJ_arr(i,j,k) / (mapfac_arr(i,j,0)*mapfac_arr(i,j,0));
+            });
+        } else {
+            ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                cons_arr(i,j,k,n) /= (mapfac_arr(i,j,0)*mapfac_arr(i,j,0));
+            });
+        }
+    } // mfi
+
+    // This call refluxes from the lev/lev+1 interface onto lev
+    getAdvFluxReg(lev+1)->Reflux(vars_new[lev][Vars::cons], 0, 0, ncomp);
+
+    // The fluxes have been used; start the next coarse step from an empty register
+    getAdvFluxReg(lev+1)->reset();
+
+    // Here we multiply (rho S) by m^2 after refluxing
+    for (MFIter mfi(vars_new[lev][Vars::cons], TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.tilebox();
+        const Array4<      Real>   cons_arr = vars_new[lev][Vars::cons].array(mfi);
+        const Array4<const Real> mapfac_arr = mapfac_m[lev]->const_array(mfi);
+        if (use_terrain) {
+            const Array4<const Real>   detJ_arr = detJ_cc[lev]->const_array(mfi);
+            ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                cons_arr(i,j,k,n) *= (mapfac_arr(i,j,0)*mapfac_arr(i,j,0)) / detJ_arr(i,j,k);
+            });
+        } else {
+            ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                cons_arr(i,j,k,n) *= (mapfac_arr(i,j,0)*mapfac_arr(i,j,0));
+            });
+        }
+    } // mfi
+
+    // We need to do this before anything else because refluxing changes the
+    // values of coarse cells underneath fine grids with the assumption they'll
+    // be over-written by averaging down
+    AverageDownTo(lev,0,ncomp);
+}
+
 // Set covered coarse cells to be the average of overlying fine cells at level crse_lev
 void
 ERF::AverageDownTo (int crse_lev, int scomp, int ncomp) // NOLINT
@@ -1874,11 +1958,18 @@ ERF::ERF (const RealBox& rb, int max_level_in,
 #endif
 
 #if defined(ERF_USE_RRTMGP)
+    rad.resize(nlevs_max);
     qheating_rates.resize(nlevs_max);
     sw_lw_fluxes.resize(nlevs_max);
     solar_zenith.resize(nlevs_max);
+    rad_needs_update.resize(nlevs_max, 1);
 #endif
 
+    micro_tendency.resize(nlevs_max);
+    micro_accum_rate.resize(nlevs_max);
+    micro_step_count.resize(nlevs_max, 0);
+    micro_diag_stale.resize(nlevs_max, 0);
+
     // NOTE: size micro before readparams (chooses the model at all levels)
     lsm.ReSize(nlevs_max);
     lsm_data.resize(nlevs_max);
@@ -1889,6 +1980,7 @@ ERF::ERF (const RealBox& rb, int max_level_in,
 
     const std::string& pv1 = "plot_vars_1"; setPlotVariables(pv1,plot_var_names_1);
     const std::string& pv2 = "plot_vars_2"; setPlotVariables(pv2,plot_var_names_2);
+    ReadPlotRegions();
 
     prob = amrex_probinit(geom[0].ProbLo(), geom[0].ProbHi());
 
@@ -1900,7 +1992,11 @@ ERF::ERF (const RealBox& rb, int max_level_in,
     istep.resize(nlevs_max, 0);
     nsubsteps.resize(nlevs_max, 1);
     for (int lev = 1; lev <= max_level; ++lev) {
-        nsubsteps[lev] = MaxRefRatio(lev-1);
+        if (subcycling_mode == "Manual") {
+            nsubsteps[lev] = subcycling_iterations[lev];
+        } else if (subcycling_mode != "None") {
+            nsubsteps[lev] = MaxRefRatio(lev-1);
+        }
     }
 
     t_new.resize(nlevs_max, 0.0);
@@ -1986,10 +2082,6 @@ ERF::ERF (const RealBox& rb, int max_level_in,
     // Theta prim for MOST
     Theta_prim.resize(nlevs_max);
 
-    // Time averaged velocity field
-    vel_t_avg.resize(nlevs_max);
-    t_avg_cnt.resize(nlevs_max);
-
     // Initialize tagging criteria for mesh refinement
     refinement_criteria_setup();
 
@@ -2053,6 +2145,15 @@ ERF::Evolve_MB (int MBstep, int max_block_step)
             last_plot_file_step_2 = step+1;
             WritePlotFile(2,plot_var_names_2);
         }
+        for (auto& reg : plot_regions) {
+            if (writeNow(cur_time, dt[0], step+1, reg.plot_int, reg.plot_per)) {
+                reg.last_plot_step = step+1;
+                WritePlotRegion(reg);
+            }
+        }
+        if (probes.active() && writeNow(cur_time, dt[0], step+1, probes.interval(), probes.period())) {
+            probes.sample(cur_time, finest_level, geom, vars_new);
+        }
 
         if (writeNow(cur_time, dt[0], step+1, m_check_int, m_check_per)) {
             last_check_file_step = step+1;
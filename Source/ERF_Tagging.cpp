@@ -1,11 +1,15 @@
+#include <algorithm>
+
 #include <ERF.H>
-#include <Derive.H>
 
 using namespace amrex;
 
 /**
  * Function to tag cells for refinement -- this overrides the pure virtual function in AmrCore
  *
+ * All criteria are evaluated in a single kernel per tile that reads the state once and
+ * derives the tested quantities on the fly; only particle counts are computed beforehand.
+ *
  * @param[in] levc level of refinement at which we tag cells (0 is coarsest level)
  * @param[out] tags array of tagged cells
  * @param[in] time current time
@@ -14,89 +18,330 @@ using namespace amrex;
 void
 ERF::ErrorEst (int levc, TagBoxArray& tags, Real time, int /*ngrow*/)
 {
-    const int clearval = TagBox::CLEAR;
-    const int   tagval = TagBox::SET;
+    const int ncrit = ref_tags.size();
+    if (ncrit == 0) return;
 
-    for (int j=0; j < ref_tags.size(); ++j)
-    {
-        std::unique_ptr<MultiFab> mf = std::make_unique<MultiFab>(grids[levc], dmap[levc], 1, 0);
+    MultiFab& S_new = vars_new[levc][Vars::cons];
+    MultiFab& U_new = vars_new[levc][Vars::xvel];
+    MultiFab& V_new = vars_new[levc][Vars::yvel];
+    MultiFab& W_new = vars_new[levc][Vars::zvel];
 
-        // This allows dynamic refinement based on the value of the density
-        if (ref_tags[j].Field() == "density")
-        {
-            MultiFab::Copy(*mf,vars_new[levc][Vars::cons],Rho_comp,0,1,0);
+    // Criteria at this level and time; criterion c sets bit c of the hits in the kernel
+    Vector<TagTest> h_tests(ncrit);
+    Vector<TagMask> h_masks;
+    Vector<std::string> aux_names;
 
-        // This allows dynamic refinement based on the value of qv
-        } else if ( ref_tags[j].Field() == "qv" ) {
-            MultiFab qv(vars_new[levc][Vars::cons],make_alias,0,RhoQ1_comp+1);
-            MultiFab::Copy(  *mf, qv, RhoQ1_comp, 0, 1, 0);
-            MultiFab::Divide(*mf, qv, Rho_comp  , 0, 1, 0);
+    bool any_active = false;
+    bool need_cons_ghosts = false;
+    bool need_vel_ghosts  = false;
 
+    for (int c = 0; c < ncrit; ++c)
+    {
+        const TagCriterion& crit = ref_tags[c];
+        TagTest& t = h_tests[c];
+
+        t.field  = static_cast<int>(crit.field);
+        t.test   = static_cast<int>(crit.test);
+        t.active = (levc < crit.max_level && time >= crit.min_time && time <= crit.max_time);
+        t.value  = (crit.value.empty()) ? 0.0 : crit.value[std::min(levc, static_cast<int>(crit.value.size())-1)];
+
+        t.use_box = crit.realbox.ok();
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+            t.box_lo[dir] = crit.realbox.lo(dir);
+            t.box_hi[dir] = crit.realbox.hi(dir);
+        }
 
-        // This allows dynamic refinement based on the value of qc
-        } else if (ref_tags[j].Field() == "qc" ) {
-            MultiFab qc(vars_new[levc][Vars::cons],make_alias,0,RhoQ2_comp+1);
-            MultiFab::Copy(  *mf, qc, RhoQ2_comp, 0, 1, 0);
-            MultiFab::Divide(*mf, qc, Rho_comp  , 0, 1, 0);
+        t.aux_comp = -1;
+        if (crit.field == TagCriterion::Field::Aux) {
+            auto it = std::find(aux_names.begin(), aux_names.end(), crit.field_name);
+            t.aux_comp = static_cast<int>(it - aux_names.begin());
+            if (it == aux_names.end()) aux_names.push_back(crit.field_name);
+        }
 
+        if (crit.field == TagCriterion::Field::Qv || crit.field == TagCriterion::Field::Qc) {
+            if (S_new.nComp() <= RhoQ2_comp) {
+                Abort("Refinement indicator " + crit.name + " tests " + crit.field_name + " but there is no moisture");
+            }
+        }
 
-        // This allows dynamic refinement based on the value of the scalar/pressure/theta
-        } else if ( (ref_tags[j].Field() == "scalar"  ) ||
-                    (ref_tags[j].Field() == "pressure") ||
-                    (ref_tags[j].Field() == "theta"   ) )
-        {
-            for (MFIter mfi(*mf, TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.tilebox();
-                auto& dfab = (*mf)[mfi];
-                auto& sfab = vars_new[levc][Vars::cons][mfi];
-                if (ref_tags[j].Field() == "scalar") {
-                    derived::erf_derscalar(bx, dfab, 0, 1, sfab, Geom(levc), time, nullptr, levc);
-                } else if (ref_tags[j].Field() == "theta") {
-                    derived::erf_dertheta(bx, dfab, 0, 1, sfab, Geom(levc), time, nullptr, levc);
-                }
-            } // mfi
+        if (t.active) {
+            any_active = true;
+            if (crit.test  == TagCriterion::Test::Grad     ) need_cons_ghosts = true;
+            if (crit.field == TagCriterion::Field::Vorticity) need_vel_ghosts  = true;
+        }
+
+        if (!crit.member) {
+            h_masks.push_back({std::uint64_t(1) << c, 0, crit.test != TagCriterion::Test::Box});
+        }
+    }
+
+    for (const auto& grp : ref_tag_groups) {
+        TagMask m{0, grp.all, 0};
+        for (int c : grp.members) {
+            m.mask |= std::uint64_t(1) << c;
+            if (ref_tags[c].test != TagCriterion::Test::Box) m.moving = 1;
+        }
+        h_masks.push_back(m);
+    }
+
+    if (!any_active) return;
+
+    // Only the ghost cells shared with other grids are read; outside the domain the
+    // kernel falls back on one-sided differences
+    if (need_cons_ghosts) {
+        S_new.FillBoundary(geom[levc].periodicity());
+    }
+    if (need_vel_ghosts) {
+        U_new.FillBoundary(geom[levc].periodicity());
+        V_new.FillBoundary(geom[levc].periodicity());
+        W_new.FillBoundary(geom[levc].periodicity());
+    }
+
+    // Particle counts per cell
+    MultiFab aux;
+    if (!aux_names.empty())
+    {
+        aux.define(grids[levc], dmap[levc], aux_names.size(), 1);
+        aux.setVal(0.0);
 #ifdef ERF_USE_PARTICLES
-        } else {
-            //
-            // This allows dynamic refinement based on the number of particles per cell
-            //
-            // Note that we must count all the particles in levels both at and above the current,
-            //      since otherwise, e.g., if the particles are all at level 1, counting particles at
-            //      level 0 will not trigger refinement when regridding so level 1 will disappear,
-            //      then come back at the next regridding
-            //
-            const auto& particles_namelist( particleData.getNames() );
-            mf->setVal(0.0);
+        //
+        // Note that we must count all the particles in levels both at and above the current,
+        //      since otherwise, e.g., if the particles are all at level 1, counting particles at
+        //      level 0 will not trigger refinement when regridding so level 1 will disappear,
+        //      then come back at the next regridding
+        //
+        const auto& particles_namelist( particleData.getNames() );
+        MultiFab temp_dat_crse(grids[levc], dmap[levc], 1, 0);
+        for (int n = 0; n < aux_names.size(); ++n)
+        {
             for (ParticlesNamesVector::size_type i = 0; i < particles_namelist.size(); i++)
             {
-                std::string tmp_string(particles_namelist[i]+"_count");
+                if (aux_names[n] != particles_namelist[i]+"_count") continue;
+
                 IntVect rr = IntVect::TheUnitVector();
-                if (ref_tags[j].Field() == tmp_string) {
-                    for (int lev = levc; lev <= finest_level; lev++)
-                    {
-                        MultiFab temp_dat(grids[lev], dmap[lev], 1, 0); temp_dat.setVal(0);
-                        particleData[particles_namelist[i]]->IncrementWithTotal(temp_dat, lev);
-
-                        MultiFab temp_dat_crse(grids[levc], dmap[levc], 1, 0); temp_dat_crse.setVal(0);
-
-                        if (lev == levc) {
-                            MultiFab::Copy(*mf, temp_dat, 0, 0, 1, 0);
-                        } else {
-                            for (int d = 0; d < AMREX_SPACEDIM; d++) {
-                                rr[d] *= ref_ratio[levc][d];
-                            }
-                            average_down(temp_dat, temp_dat_crse, 0, 1, rr);
-                            MultiFab::Add(*mf, temp_dat_crse, 0, 0, 1, 0);
+                for (int lev = levc; lev <= finest_level; lev++)
+                {
+                    MultiFab temp_dat(grids[lev], dmap[lev], 1, 0); temp_dat.setVal(0);
+                    particleData[particles_namelist[i]]->IncrementWithTotal(temp_dat, lev);
+
+                    if (lev == levc) {
+                        MultiFab::Copy(aux, temp_dat, 0, n, 1, 0);
+                    } else {
+                        for (int d = 0; d < AMREX_SPACEDIM; d++) {
+                            rr[d] *= ref_ratio[lev-1][d];
                         }
+                        temp_dat_crse.setVal(0);
+                        average_down(temp_dat, temp_dat_crse, 0, 1, rr);
+                        MultiFab::Add(aux, temp_dat_crse, 0, n, 1, 0);
                     }
                 }
             }
+        }
+#endif
+        aux.FillBoundary(geom[levc].periodicity());
+    }
+
+    Gpu::DeviceVector<TagTest> d_tests(ncrit);
+    Gpu::DeviceVector<TagMask> d_masks(h_masks.size());
+    Gpu::copy(Gpu::hostToDevice, h_tests.begin(), h_tests.end(), d_tests.begin());
+    Gpu::copy(Gpu::hostToDevice, h_masks.begin(), h_masks.end(), d_masks.begin());
+    const TagTest* tests = d_tests.data();
+    const TagMask* masks = d_masks.data();
+    const int nmasks = h_masks.size();
+
+    TagState st_lev;
+    st_lev.plo   = geom[levc].ProbLoArray();
+    st_lev.dx    = geom[levc].CellSizeArray();
+    st_lev.dxInv = geom[levc].InvCellSizeArray();
+    const Box& domain = geom[levc].Domain();
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+        st_lev.dlo[dir]      = domain.smallEnd(dir);
+        st_lev.dhi[dir]      = domain.bigEnd(dir);
+        st_lev.periodic[dir] = geom[levc].isPeriodic(dir);
+    }
+
+    const auto tagval = static_cast<TagBox::TagType>(TagBox::SET);
+
+    // Tags of criteria that follow the flow are collected separately and swept
+    // forward by AdvectTags; tags of fixed boxes are set directly
+    iMultiFab moving;
+    if (tag_advect) {
+        moving.define(grids[levc], dmap[levc], 1, 0);
+        moving.setVal(0);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
+    for (MFIter mfi(tags, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& tag = tags.array(mfi);
+
+        TagState st = st_lev;
+        st.cons = S_new.const_array(mfi);
+        st.u    = U_new.const_array(mfi);
+        st.v    = V_new.const_array(mfi);
+        st.w    = W_new.const_array(mfi);
+        if (!aux_names.empty()) st.aux = aux.const_array(mfi);
+
+        const auto& mov = (tag_advect) ? moving.array(mfi) : Array4<int>{};
+
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            std::uint64_t hits = 0;
+            for (int c = 0; c < ncrit; ++c) {
+                if (tag_test(tests[c], i, j, k, st)) hits |= std::uint64_t(1) << c;
+            }
+            for (int m = 0; m < nmasks; ++m) {
+                const std::uint64_t mask = masks[m].mask;
+                if ( (masks[m].all) ? ((hits & mask) == mask) : ((hits & mask) != 0) ) {
+                    if (mov && masks[m].moving) {
+                        mov(i,j,k) = 1;
+                    } else {
+                        tag(i,j,k) = tagval;
+                    }
+                }
+            }
+        });
+    }
+
+    if (tag_advect) {
+        AdvectTags(levc, tags, moving);
+    }
+}
+
+/**
+ * Sweep the tags of moving features along the flow until the next regrid, so that
+ * the fine grids lead the features instead of trailing them
+ *
+ * The tags in each grid are displaced by the mean velocity of its tagged cells times
+ * regrid_int time steps of this level, and every cell along the way is tagged.
+ *
+ * @param[in] levc level of refinement at which we tag cells
+ * @param[inout] tags array of tagged cells
+ * @param[in] moving cells tagged by criteria that follow the flow
+ */
+void
+ERF::AdvectTags (int levc, TagBoxArray& tags, const iMultiFab& moving)
+{
+    MultiFab& U_new = vars_new[levc][Vars::xvel];
+    MultiFab& V_new = vars_new[levc][Vars::yvel];
+    MultiFab& W_new = vars_new[levc][Vars::zvel];
+
+    // There is no time step yet when the initial grids are built
+    const Real horizon = (regrid_int > 0 && dt[levc] < 1.e100) ? regrid_int * dt[levc] : 0.0;
+    const auto dxInv = geom[levc].InvCellSizeArray();
+
+    // With terrain (which includes stretched grids) the cells do not all have the same height
+    const MultiFab* z_nd = (solverChoice.use_terrain) ? z_phys_nd[levc].get() : nullptr;
+
+    // Displacement in cells of the tags in each grid
+    LayoutData<IntVect> shift(grids[levc], dmap[levc]);
+    int max_shift = 0;
+
+    for (MFIter mfi(moving); mfi.isValid(); ++mfi)
+    {
+        shift[mfi] = IntVect::TheZeroVector();
+        if (horizon <= 0.0) continue;
+
+        const Box& bx = mfi.validbox();
+        const auto& mov = moving.const_array(mfi);
+        const auto& u   = U_new.const_array(mfi);
+        const auto& v   = V_new.const_array(mfi);
+        const auto& w   = W_new.const_array(mfi);
+        const auto& z   = (z_nd) ? z_nd->const_array(mfi) : Array4<const Real>{};
+        const bool has_z = (z_nd != nullptr);
+        const Real dzInv = dxInv[2];
+
+        ReduceOps<ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum> reduce_op;
+        ReduceData<Real,Real,Real,Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        reduce_op.eval(bx, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+        {
+            if (mov(i,j,k) == 0) return {0.0, 0.0, 0.0, 0.0};
+            // The vertical velocity is measured in cells of the local height
+            Real dzInv_loc = dzInv;
+            if (has_z) {
+                dzInv_loc = 4.0 / ( z(i,j  ,k+1) - z(i,j  ,k) + z(i+1,j  ,k+1) - z(i+1,j  ,k)
+                                  + z(i,j+1,k+1) - z(i,j+1,k) + z(i+1,j+1,k+1) - z(i+1,j+1,k) );
+            }
+            return { 0.5 * (u(i,j,k) + u(i+1,j,k)) * dxInv[0],
+                     0.5 * (v(i,j,k) + v(i,j+1,k)) * dxInv[1],
+                     0.5 * (w(i,j,k) + w(i,j,k+1)) * dzInv_loc,
+                     1.0 };
+        });
+        ReduceTuple hv = reduce_data.value(reduce_op);
+
+        const Real ntagged = amrex::get<3>(hv);
+        if (ntagged > 0.0) {
+            // Mean velocity of the tagged cells, in cells per unit time
+            const Real vel[3] = {amrex::get<0>(hv), amrex::get<1>(hv), amrex::get<2>(hv)};
+            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                int s = static_cast<int>(std::round(vel[dir] / ntagged * horizon));
+                s = amrex::max(-tag_advect_max_cells, amrex::min(tag_advect_max_cells, s));
+                shift[mfi][dir] = s;
+                max_shift = amrex::max(max_shift, std::abs(s));
+            }
         }
+    }
+    ParallelDescriptor::ReduceIntMax(max_shift);
+
+    // Sweep the tags into a copy with enough ghost cells to hold the largest displacement,
+    // then add the parts that landed in neighboring grids back into them.  Every cell of
+    // the grown tile gathers from the tagged cells of the grid that sweep over it, so that
+    // no two threads write the same cell
+    iMultiFab swept(grids[levc], dmap[levc], 1, max_shift);
+    swept.setVal(0);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(swept, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& gbx = mfi.growntilebox();
+        const Box& vbx = mfi.validbox();
+        const auto& mov = moving.const_array(mfi);
+        const auto& sw  = swept.array(mfi);
+
+        const IntVect s = shift[mfi];
+        const int nsteps = amrex::max(1, s.max(), -s.min());
+
+        ParallelFor(gbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            for (int m = 0; m <= nsteps; ++m) {
+                const IntVect src(i - static_cast<int>(std::round(Real(m * s[0]) / nsteps)),
+                                  j - static_cast<int>(std::round(Real(m * s[1]) / nsteps)),
+                                  k - static_cast<int>(std::round(Real(m * s[2]) / nsteps)));
+                if (vbx.contains(src) && mov(src) != 0) {
+                    sw(i,j,k) = 1;
+                    return;
+                }
+            }
+        });
+    }
+
+    if (max_shift > 0) {
+        swept.SumBoundary(geom[levc].periodicity());
+    }
 
-        ref_tags[j](tags,mf.get(),clearval,tagval,time,levc,geom[levc]);
-    } // loop over j
+    const auto tagval = static_cast<TagBox::TagType>(TagBox::SET);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(tags, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& tag = tags.array(mfi);
+        const auto& sw  = swept.const_array(mfi);
+
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            if (sw(i,j,k) > 0) tag(i,j,k) = tagval;
+        });
+    }
 }
 
 /**
@@ -117,6 +362,15 @@ ERF::refinement_criteria_setup ()
             std::string ref_prefix = pp_prefix + "." + refinement_indicators[i];
 
             ParmParse ppr(ref_prefix);
+
+            // Combinations of other criteria are resolved once all criteria are read
+            if (ppr.contains("all_of") || ppr.contains("any_of")) {
+                if (ppr.contains("all_of") && ppr.contains("any_of")) {
+                    Abort("Refinement indicator " + refinement_indicators[i] + ": must choose only one of all_of or any_of");
+                }
+                continue;
+            }
+
             RealBox realbox;
             int lev_for_box;
 
@@ -208,51 +462,122 @@ ERF::refinement_criteria_setup ()
                 }
             }
 
-            AMRErrorTagInfo info;
+            TagCriterion crit;
+            crit.name = refinement_indicators[i];
 
             if (realbox.ok()) {
-                info.SetRealBox(realbox);
+                crit.realbox = realbox;
             }
             if (ppr.countval("start_time") > 0) {
-                Real ref_min_time; ppr.get("start_time",ref_min_time);
-                info.SetMinTime(ref_min_time);
+                ppr.get("start_time",crit.min_time);
             }
             if (ppr.countval("end_time") > 0) {
-                Real ref_max_time; ppr.get("end_time",ref_max_time);
-                info.SetMaxTime(ref_max_time);
+                ppr.get("end_time",crit.max_time);
             }
             if (ppr.countval("max_level") > 0) {
-                int ref_max_level; ppr.get("max_level",ref_max_level);
-                info.SetMaxLevel(ref_max_level);
+                ppr.get("max_level",crit.max_level);
             }
 
             if (ppr.countval("value_greater")) {
-                int num_val = ppr.countval("value_greater");
-                Vector<Real> value(num_val);
-                ppr.getarr("value_greater",value,0,num_val);
-                std::string field; ppr.get("field_name",field);
-                ref_tags.push_back(AMRErrorTag(value,AMRErrorTag::GREATER,field,info));
+                crit.test = TagCriterion::Test::Greater;
+                ppr.getarr("value_greater",crit.value,0,ppr.countval("value_greater"));
             }
             else if (ppr.countval("value_less")) {
-                int num_val = ppr.countval("value_less");
-                Vector<Real> value(num_val);
-                ppr.getarr("value_less",value,0,num_val);
-                std::string field; ppr.get("field_name",field);
-                ref_tags.push_back(AMRErrorTag(value,AMRErrorTag::LESS,field,info));
+                crit.test = TagCriterion::Test::Less;
+                ppr.getarr("value_less",crit.value,0,ppr.countval("value_less"));
             }
             else if (ppr.countval("adjacent_difference_greater")) {
-                int num_val = ppr.countval("adjacent_difference_greater");
-                Vector<Real> value(num_val);
-                ppr.getarr("adjacent_difference_greater",value,0,num_val);
-                std::string field; ppr.get("field_name",field);
-                ref_tags.push_back(AMRErrorTag(value,AMRErrorTag::GRAD,field,info));
+                crit.test = TagCriterion::Test::Grad;
+                ppr.getarr("adjacent_difference_greater",crit.value,0,ppr.countval("adjacent_difference_greater"));
             }
             else if (realbox.ok())
             {
-                ref_tags.push_back(AMRErrorTag(info));
+                crit.test = TagCriterion::Test::Box;
             } else {
                 Abort(std::string("Unrecognized refinement indicator for " + refinement_indicators[i]).c_str());
             }
+
+            if (crit.test != TagCriterion::Test::Box)
+            {
+                ppr.get("field_name",crit.field_name);
+                crit.field = tag_field_from_name(crit.field_name);
+                if (crit.field == TagCriterion::Field::None) {
+                    Abort("Refinement indicator " + crit.name + ": unknown field_name " + crit.field_name);
+                }
+                // The kernel only has the ghost cells of the face velocities to difference velocities with
+                if (crit.test == TagCriterion::Test::Grad &&
+                    crit.field >= TagCriterion::Field::XVel && crit.field <= TagCriterion::Field::Vorticity) {
+                    Abort("Refinement indicator " + crit.name + ": adjacent_difference_greater is not available for " + crit.field_name);
+                }
+            }
+
+            ref_tags.push_back(crit);
         } // loop over criteria
+
+        for (const auto& name : refinement_indicators)
+        {
+            ParmParse ppr(pp_prefix + "." + name);
+            if (!ppr.contains("all_of") && !ppr.contains("any_of")) continue;
+
+            TagGroup grp;
+            grp.name = name;
+            grp.all  = ppr.contains("all_of");
+
+            Vector<std::string> member_names;
+            ppr.getarr((grp.all) ? "all_of" : "any_of", member_names);
+            for (const auto& mname : member_names) {
+                auto it = std::find_if(ref_tags.begin(), ref_tags.end(),
+                                       [&] (const TagCriterion& c) { return c.name == mname; });
+                if (it == ref_tags.end()) {
+                    Abort("Refinement indicator " + name + ": " + mname + " is not a refinement indicator");
+                }
+                it->member = true;
+                grp.members.push_back(static_cast<int>(it - ref_tags.begin()));
+            }
+            ref_tag_groups.push_back(grp);
+        }
+
+        // The kernel keeps one bit per criterion
+        if (ref_tags.size() > 64) {
+            Abort("At most 64 refinement indicators are supported");
+        }
+
+        // A static nest is never regridded, so its grids can only come from fixed boxes
+        if (static_nest) {
+            for (const auto& crit : ref_tags) {
+                if (crit.test != TagCriterion::Test::Box) {
+                    Abort("Refinement indicator " + crit.name + ": erf.static_nest only allows boxes");
+                }
+            }
+        }
     } // if max_level > 0
 }
+
+/**
+ * Quantity a refinement criterion tests, from its field_name
+ *
+ * @param[in] name field name given in the inputs
+ */
+TagCriterion::Field
+ERF::tag_field_from_name (const std::string& name)
+{
+    using F = TagCriterion::Field;
+    if (name == "density"   ) return F::Density;
+    if (name == "rhotheta"  ) return F::RhoTheta;
+    if (name == "theta"     ) return F::Theta;
+    if (name == "rhoadv_0"  ) return F::RhoScalar;
+    if (name == "scalar"    ) return F::Scalar;
+    if (name == "qv"        ) return F::Qv;
+    if (name == "qc"        ) return F::Qc;
+    if (name == "pressure"  ) return F::Pressure;
+    if (name == "x_velocity") return F::XVel;
+    if (name == "y_velocity") return F::YVel;
+    if (name == "z_velocity") return F::ZVel;
+    if (name == "magvel"    ) return F::MagVel;
+    if (name == "vorticity" ) return F::Vorticity;
+#ifdef ERF_USE_PARTICLES
+    // Particle counts per cell, <particle container name>_count
+    if (name.size() > 6 && name.substr(name.size()-6) == "_count") return F::Aux;
+#endif
+    return F::None;
+}
@@ -0,0 +1,180 @@
+#include <ERF.H>
+#include <BoxCosts.H>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+using namespace amrex;
+
+/**
+ * Redistribute the grids of every level according to the box costs measured
+ * since the last call (see BoxCosts.H).  A level is only migrated when the
+ * proposed distribution improves the efficiency (mean over maximum rank cost)
+ * by more than erf.load_balance_efficiency_ratio_threshold; the grids themselves
+ * are unchanged.
+ */
+void
+ERF::LoadBalance ()
+{
+    BL_PROFILE("ERF::LoadBalance()");
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        LayoutData<Real>* costs = BoxCosts::get(lev);
+        if (!costs) continue;
+
+        // Nothing has been measured since the level was (re)made
+        Real total_cost = 0.0;
+        for (MFIter mfi(*costs); mfi.isValid(); ++mfi) {
+            total_cost += (*costs)[mfi];
+        }
+        ParallelDescriptor::ReduceRealSum(total_cost);
+        if (total_cost <= 0.0) continue;
+
+        Real current_eff  = 0.0;
+        Real proposed_eff = 0.0;
+        DistributionMapping dm_new = (load_balance_method == "sfc") ?
+            DistributionMapping::makeSFC     (*costs, current_eff, proposed_eff) :
+            DistributionMapping::makeKnapSack(*costs, current_eff, proposed_eff);
+
+        bool do_migrate = (proposed_eff > load_balance_efficiency_ratio_threshold * current_eff);
+
+        if (verbose > 0) {
+            Print() << "Load balance at level " << lev << ": efficiency " << current_eff
+                    << " -> " << proposed_eff << (do_migrate ? " (redistributing)" : " (keeping)")
+                    << std::endl;
+        }
+
+        if (do_migrate)
+        {
+            // Same grids on new ranks; this also zeroes the costs of the level
+            RemakeLevel(lev, t_new[lev], grids[lev], dm_new);
+            SetDistributionMap(lev, dm_new);
+
+            // The next finer level refers to this level's distribution
+            if (lev < finest_level) {
+                if (cf_width >= 0) {
+                    Define_ERFFillPatchers(lev+1);
+                }
+                if (solverChoice.coupling_type == CouplingType::TwoWay) {
+                    int ncomp_reflux = vars_new[0][Vars::cons].nComp();
+                    delete advflux_reg[lev+1];
+                    advflux_reg[lev+1] = new YAFluxRegister(grids[lev+1], grids[lev],
+                                                            dmap[lev+1] ,  dmap[lev],
+                                                            geom[lev+1] ,  geom[lev],
+                                                            ref_ratio[lev], lev+1, ncomp_reflux);
+                }
+            }
+        }
+        else
+        {
+            BoxCosts::reset(lev);
+        }
+    }
+}
+
+/**
+ * Distribution of the grids of a level that is made or remade by regrid.  When
+ * an existing level is regridded with erf.delta_regrid, every box that is
+ * identical to a box of the old grids stays on the rank that holds its data,
+ * so that copying it to the new grids needs no communication; the other boxes
+ * are given, largest first, to the rank with the fewest cells.  Otherwise the
+ * grids are distributed along a space-filling curve with erf.sfc_box_order and
+ * with the default AMReX strategy without it.
+ */
+DistributionMapping
+ERF::MakeDistributionMap (int lev, BoxArray const& ba)
+{
+    if (!delta_regrid || lev > finest_level || grids[lev].empty()) {
+        if (sfc_box_order) {
+            Vector<Real> cost(ba.size());
+            for (int i = 0; i < ba.size(); ++i) {
+                cost[i] = static_cast<Real>(ba[i].numPts());
+            }
+            return DistributionMapping::makeSFC(cost, ba);
+        }
+        return AmrCore::MakeDistributionMap(lev, ba);
+    }
+
+    const BoxArray&            ba_old = grids[lev];
+    const DistributionMapping& dm_old = dmap[lev];
+
+    Vector<int>  pmap(ba.size(), -1);
+    Vector<Long> ncells(ParallelDescriptor::NProcs(), 0);
+    Vector<int>  fresh;
+
+    for (int i = 0; i < ba.size(); ++i) {
+        for (const auto& isect : ba_old.intersections(ba[i])) {
+            if (ba_old[isect.first] == ba[i]) {
+                pmap[i] = dm_old[isect.first];
+                ncells[pmap[i]] += ba[i].numPts();
+                break;
+            }
+        }
+        if (pmap[i] < 0) fresh.push_back(i);
+    }
+
+    std::stable_sort(fresh.begin(), fresh.end(),
+                     [&] (int a, int b) { return ba[a].numPts() > ba[b].numPts(); });
+
+    for (int i : fresh) {
+        int proc = static_cast<int>(std::min_element(ncells.begin(), ncells.end()) - ncells.begin());
+        pmap[i] = proc;
+        ncells[proc] += ba[i].numPts();
+    }
+
+    if (verbose > 0) {
+        Print() << "Regrid at level " << lev << ": " << ba.size() - fresh.size() << " of "
+                << ba.size() << " boxes unchanged" << std::endl;
+    }
+
+    return DistributionMapping(std::move(pmap));
+}
+
+/**
+ * With erf.sfc_box_order, sort the level 0 boxes along a Morton curve through
+ * their low corners.  MFIter visits the local boxes of a rank in BoxArray order,
+ * and the SFC distribution gives each rank a contiguous piece of the curve, so
+ * consecutive boxes of a rank are neighbors in space and share their ghost data.
+ */
+void
+ERF::PostProcessBaseGrids (BoxArray& ba0) const
+{
+    if (!sfc_box_order || ba0.size() < 2) return;
+
+    const IntVect dlo = geom[0].Domain().smallEnd();
+
+    // Boxes are compared in units of the smallest box so that the keys stay small
+    IntVect unit(std::numeric_limits<int>::max());
+    for (int i = 0; i < ba0.size(); ++i) {
+        unit.min(ba0[i].length());
+    }
+
+    // Interleave the bits of the three indices, 21 bits each
+    auto morton = [] (std::uint64_t x)
+    {
+        x &= 0x1fffff;
+        x = (x | x << 32) & 0x1f00000000ffff;
+        x = (x | x << 16) & 0x1f0000ff0000ff;
+        x = (x | x <<  8) & 0x100f00f00f00f00f;
+        x = (x | x <<  4) & 0x10c30c30c30c30c3;
+        x = (x | x <<  2) & 0x1249249249249249;
+        return x;
+    };
+
+    Vector<std::pair<std::uint64_t,int>> keys(ba0.size());
+    for (int i = 0; i < ba0.size(); ++i) {
+        const IntVect c = (ba0[i].smallEnd() - dlo) / unit;
+        keys[i] = {morton(c[0]) | morton(c[1]) << 1 | morton(c[2]) << 2, i};
+    }
+    std::sort(keys.begin(), keys.end());
+
+    BoxList bl(ba0.ixType());
+    bl.reserve(ba0.size());
+    for (const auto& key : keys) {
+        bl.push_back(ba0[key.second]);
+    }
+    ba0 = BoxArray(std::move(bl));
+}
@@ -13,6 +13,7 @@
 #include <AMReX_buildInfo.H>
 
 #include <Utils.H>
+#include <BoxCosts.H>
 #include <TerrainMetrics.H>
 #include <Utils/ParFunctions.H>
 #include <memory>
@@ -41,6 +42,9 @@ ERF::init_stuff (int lev, const BoxArray& ba, const DistributionMapping& dm,
         }
     }
 
+    // Abort before allocating if the level would not fit in erf.memory_budget_per_rank
+    ProjectMemory(lev, ba, dm);
+
     // ********************************************************************************************
     // Base state holds r_0, pres_0, pi_0 (in that order)
     // ********************************************************************************************
@@ -159,6 +163,18 @@ ERF::init_stuff (int lev, const BoxArray& ba, const DistributionMapping& dm,
     rW_old[lev].define(convert(ba, IntVect(0,0,1)), dm, 1, ngrow_vels);
     rW_new[lev].define(convert(ba, IntVect(0,0,1)), dm, 1, ngrow_vels);
 
+    // ********************************************************************************************
+    // With OpenMP, write the level data first with the same tiles and threads as the
+    //     MFIter loops that compute on it, so that its pages are placed on their NUMA node
+    // ********************************************************************************************
+    if (numa_first_touch) {
+        for (int ivar = 0; ivar < Vars::NumTypes; ++ivar) {
+            lev_new[ivar].setVal(0.0);
+            lev_old[ivar].setVal(0.0);
+        }
+        rU_old[lev].setVal(0.0); rV_old[lev].setVal(0.0); rW_old[lev].setVal(0.0);
+    }
+
     // We do this here just so they won't be undefined in the initial FillPatch
     rU_new[lev].setVal(1.2e21);
     rV_new[lev].setVal(3.4e22);
@@ -172,11 +188,15 @@ ERF::init_stuff (int lev, const BoxArray& ba, const DistributionMapping& dm,
     //       which would copy on intersection and interpolate from coarse.
     //       Therefore, we are restarting the averaging when the ba changes,
     //       this may give poor statistics for dynamic mesh refinement.
-    vel_t_avg[lev] = nullptr;
-    if (solverChoice.time_avg_vel) {
-        vel_t_avg[lev] = std::make_unique<MultiFab>(ba, dm, 4, 0); // Each vel comp and the mag
-        vel_t_avg[lev]->setVal(0.0);
-        t_avg_cnt[lev] = 0.0;
+    if (field_stats.active()) {
+        field_stats.define(lev, ba, dm);
+    }
+
+    // ********************************************************************************************
+    // Measured box costs for load balancing; these restart whenever the level is (re)made
+    // ********************************************************************************************
+    if (load_balance_int > 0) {
+        BoxCosts::define(lev, ba, dm);
     }
 
     // ********************************************************************************************
@@ -250,6 +270,26 @@ ERF::init_stuff (int lev, const BoxArray& ba, const DistributionMapping& dm,
     }
 #endif
 
+    //*********************************************************
+    // Microphysics tendencies if it is not called every step
+    //*********************************************************
+    if (solverChoice.moisture_type != MoistureType::None && solverChoice.micro_int[lev] > 1) {
+        int n_qstate = micro->Get_Qstate_Size();
+        int n_accum  = Microphysics::precipAccumIndices(solverChoice.moisture_type).size();
+        micro_tendency[lev] = std::make_unique<MultiFab>(ba, dm, 1+n_qstate, 0); // rho theta, rho q
+        micro_tendency[lev]->setVal(0.);
+        if (n_accum > 0) {
+            micro_accum_rate[lev] = std::make_unique<MultiFab>(ba, dm, n_accum, 0);
+            micro_accum_rate[lev]->setVal(0.);
+        }
+        // The tendencies are not carried over; call the model on the next step
+        micro_step_count[lev] = solverChoice.micro_int[lev];
+        micro_diag_stale[lev] = 1;
+    } else {
+        micro_tendency[lev]   = nullptr;
+        micro_accum_rate[lev] = nullptr;
+    }
+
 
 #ifdef ERF_USE_WW3_COUPLING
     // create a new BoxArray and DistributionMapping for a MultiFab with 1 box
@@ -290,6 +330,9 @@ ERF::init_stuff (int lev, const BoxArray& ba, const DistributionMapping& dm,
     qheating_rates[lev] = std::make_unique<MultiFab>(ba, dm, 2, ngrow_state);
     qheating_rates[lev]->setVal(0.);
 
+    // The next step must call the radiation to fill them
+    rad_needs_update[lev] = 1;
+
     //*********************************************************
     // Radiation fluxes for coupling to LSM
     //*********************************************************
@@ -429,51 +472,139 @@ void
 ERF::update_terrain_arrays (int lev, Real time)
 {
     if (solverChoice.use_terrain) {
+        make_terrain_arrays(lev, time, z_phys_nd[lev], detJ_cc[lev],
+                            ax[lev], ay[lev], az[lev], z_phys_cc[lev]);
+    }
+}
 
+/**
+ * Compute the terrain height at the nodes and the metric terms derived from it
+ * on the grids of the MultiFabs passed in, which may cover only part of the level.
+ */
+void
+ERF::make_terrain_arrays (int lev, Real time,
+                          std::unique_ptr<MultiFab>& z_nd,
+                          std::unique_ptr<MultiFab>& detJ,
+                          std::unique_ptr<MultiFab>& a_x,
+                          std::unique_ptr<MultiFab>& a_y,
+                          std::unique_ptr<MultiFab>& a_z,
+                          std::unique_ptr<MultiFab>& z_cc)
+{
+    //
+    // First interpolate from coarser level if there is one
+    //
+    if (lev > 0) {
         //
-        // First interpolate from coarser level if there is one
+        // First we fill z_phys_nd at lev>0 through interpolation
         //
-        if (lev > 0) {
-            Vector<MultiFab*> fmf = {z_phys_nd[lev].get(), z_phys_nd[lev].get()};
-            Vector<Real> ftime    = {t_old[lev], t_new[lev]};
-            Vector<MultiFab*> cmf = {z_phys_nd[lev-1].get(), z_phys_nd[lev-1].get()};
-            Vector<Real> ctime    = {t_old[lev-1], t_new[lev-1]};
-
-            //
-            // First we fill z_phys_nd at lev>0 through interpolation
-            //
-            Interpolater* mapper = &node_bilinear_interp;
-            PhysBCFunctNoOp null_bc;
-            InterpFromCoarseLevel(*z_phys_nd[lev], time, *z_phys_nd[lev-1],
-                                  0, 0, 1,
-                                  geom[lev-1], geom[lev],
-                                  null_bc, 0, null_bc, 0, refRatio(lev-1),
-                                  mapper, domain_bcs_type, 0);
+        Interpolater* mapper = &node_bilinear_interp;
+        PhysBCFunctNoOp null_bc;
+        InterpFromCoarseLevel(*z_nd, time, *z_phys_nd[lev-1],
+                              0, 0, 1,
+                              geom[lev-1], geom[lev],
+                              null_bc, 0, null_bc, 0, refRatio(lev-1),
+                              mapper, domain_bcs_type, 0);
+    }
+
+    //
+    // Then, if not using real/metgrid data,
+    // 1) redefine the terrain at k=0 for every fine box which includes k=0
+    // 2) recreate z_phys_nd at every fine node using
+    // the data at the bottom of each fine grid
+    // which has been either been interpolated from the coarse grid (k>0)
+    // or set in init_custom_terrain (k=0)
+    //
+    if (init_type != "real" && init_type != "metgrid") {
+        prob->init_custom_terrain(geom[lev],*z_nd,time);
+
+        Vector<Real> zmax(1); // only reduce at k==0
+        reduce_to_max_per_level(zmax, z_nd);
+        amrex::Print() << "Max terrain elevation = " << zmax[0] << std::endl;
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(zlevels_stag[zlevels_stag.size()-1] > zmax[0],
+            "Terrain is taller than domain top!");
+
+        init_terrain_grid(lev,geom[lev],*z_nd,zlevels_stag,phys_bc_type);
+    }
+
+    make_J(geom[lev],*z_nd,*detJ);
+    make_areas(geom[lev],*z_nd,*a_x,*a_y,*a_z);
+    make_zcc(geom[lev],*z_nd,*z_cc);
+}
+
+/**
+ * Rebuild the static terrain arrays of a remade level.  The boxes that are
+ * unchanged and still on the same rank copy their data from the old arrays;
+ * the terrain and metrics are only computed on the remaining boxes.  Every box
+ * is filled from the one fab that holds it, ghost cells included, and the ghost
+ * cells inside the domain are then filled from the valid data of the neighbors.
+ *
+ * @param[in] lev         level of refinement
+ * @param[in] time        current time
+ * @param[in] old_terrain z_phys_nd, detJ_cc, ax, ay, az and z_phys_cc on the old grids
+ */
+void
+ERF::remake_terrain_arrays (int lev, Real time, Vector<std::unique_ptr<MultiFab>>& old_terrain)
+{
+    AMREX_ALWAYS_ASSERT(solverChoice.use_terrain && solverChoice.terrain_type == TerrainType::Static);
+
+    const BoxArray&            ba     = detJ_cc[lev]->boxArray();
+    const DistributionMapping& dm     = detJ_cc[lev]->DistributionMap();
+    const BoxArray&            ba_old = old_terrain[1]->boxArray();
+    const DistributionMapping& dm_old = old_terrain[1]->DistributionMap();
+
+    // Index of every box in the old grids if it is unchanged, or else in the fresh grids
+    Vector<int> old_index(ba.size(), -1);
+    Vector<int> fresh_index(ba.size(), -1);
+    BoxList     bl_fresh;
+    Vector<int> pmap_fresh;
+    for (int i = 0; i < ba.size(); ++i) {
+        for (const auto& isect : ba_old.intersections(ba[i])) {
+            if (ba_old[isect.first] == ba[i] && dm_old[isect.first] == dm[i]) {
+                old_index[i] = isect.first;
+                break;
+            }
+        }
+        if (old_index[i] < 0) {
+            fresh_index[i] = static_cast<int>(pmap_fresh.size());
+            bl_fresh.push_back(ba[i]);
+            pmap_fresh.push_back(dm[i]);
         }
+    }
 
-        //
-        // Then, if not using real/metgrid data,
-        // 1) redefine the terrain at k=0 for every fine box which includes k=0
-        // 2) recreate z_phys_nd at every fine node using
-        // the data at the bottom of each fine grid
-        // which has been either been interpolated from the coarse grid (k>0)
-        // or set in init_custom_terrain (k=0)
-        //
-        if (init_type != "real" && init_type != "metgrid") {
-            prob->init_custom_terrain(geom[lev],*z_phys_nd[lev],time);
+    Vector<MultiFab*> new_terrain = {z_phys_nd[lev].get(), detJ_cc[lev].get(),
+                                     ax[lev].get(), ay[lev].get(), az[lev].get(),
+                                     z_phys_cc[lev].get()};
 
-            Vector<Real> zmax(1); // only reduce at k==0
-            reduce_to_max_per_level(zmax, z_phys_nd[lev]);
-            amrex::Print() << "Max terrain elevation = " << zmax[0] << std::endl;
-            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(zlevels_stag[zlevels_stag.size()-1] > zmax[0],
-                "Terrain is taller than domain top!");
+    // Compute on the new boxes only, on the ranks they were assigned to
+    Vector<std::unique_ptr<MultiFab>> fresh(new_terrain.size());
+    if (!bl_fresh.isEmpty()) {
+        BoxArray ba_fresh(std::move(bl_fresh));
+        DistributionMapping dm_fresh(std::move(pmap_fresh));
 
-            init_terrain_grid(lev,geom[lev],*z_phys_nd[lev],zlevels_stag,phys_bc_type);
+        for (int n = 0; n < new_terrain.size(); ++n) {
+            fresh[n] = std::make_unique<MultiFab>(convert(ba_fresh, new_terrain[n]->ixType()), dm_fresh,
+                                                  1, new_terrain[n]->nGrowVect());
         }
 
-        make_J(geom[lev],*z_phys_nd[lev],*detJ_cc[lev]);
-        make_areas(geom[lev],*z_phys_nd[lev],*ax[lev],*ay[lev],*az[lev]);
-        make_zcc(geom[lev],*z_phys_nd[lev],*z_phys_cc[lev]);
+        make_terrain_arrays(lev, time, fresh[0], fresh[1], fresh[2], fresh[3], fresh[4], fresh[5]);
+    }
+
+    // Both the old and the fresh fab of a box live on its rank, so this needs no communication
+    for (int n = 0; n < new_terrain.size(); ++n) {
+        for (MFIter mfi(*new_terrain[n]); mfi.isValid(); ++mfi) {
+            const int i = mfi.index();
+            const MultiFab& src_mf = (old_index[i] >= 0) ? *old_terrain[n] : *fresh[n];
+            const int       src_i  = (old_index[i] >= 0) ? old_index[i] : fresh_index[i];
+
+            const Box bx = mfi.fabbox() & src_mf.fabbox(src_i);
+            const Array4<Real      >& dst = new_terrain[n]->array(mfi);
+            const Array4<Real const>& src = src_mf.const_array(src_i);
+            ParallelFor(bx, [=] AMREX_GPU_DEVICE (int ii, int jj, int kk) noexcept
+            {
+                dst(ii,jj,kk) = src(ii,jj,kk);
+            });
+        }
+        new_terrain[n]->FillBoundary(geom[lev].periodicity());
     }
 }
 
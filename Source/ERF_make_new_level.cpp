@@ -11,6 +11,7 @@
 #include <ERF.H>
 #include <AMReX_buildInfo.H>
 #include <Utils.H>
+#include <BoxCosts.H>
 #include <memory>
 
 #ifdef ERF_USE_MULTIBLOCK
@@ -381,6 +382,22 @@ ERF::RemakeLevel (int lev, Real time, const BoxArray& ba, const DistributionMapp
     Vector<MultiFab> temp_lev_new(Vars::NumTypes);
     Vector<MultiFab> temp_lev_old(Vars::NumTypes);
 
+    // ********************************************************************************************
+    // Static terrain does not change, so keep the old terrain arrays to copy from
+    //      instead of recomputing them on the boxes that are unchanged
+    // ********************************************************************************************
+    bool delta_terrain = delta_regrid && solverChoice.use_terrain &&
+                         solverChoice.terrain_type == TerrainType::Static;
+    Vector<std::unique_ptr<MultiFab>> old_terrain;
+    if (delta_terrain) {
+        old_terrain.push_back(std::move(z_phys_nd[lev]));
+        old_terrain.push_back(std::move(detJ_cc[lev]));
+        old_terrain.push_back(std::move(ax[lev]));
+        old_terrain.push_back(std::move(ay[lev]));
+        old_terrain.push_back(std::move(az[lev]));
+        old_terrain.push_back(std::move(z_phys_cc[lev]));
+    }
+
     //********************************************************************************************
     // This allocates all kinds of things, including but not limited to: solution arrays,
     //      terrain arrays and metrics, and base state.
@@ -393,7 +410,9 @@ ERF::RemakeLevel (int lev, Real time, const BoxArray& ba, const DistributionMapp
     initialize_bcs(lev);
 
     // ********************************************************************************************
-    // This will fill the temporary MultiFabs with data from vars_new
+    // This will fill the temporary MultiFabs with data from vars_new; only the regions not
+    //      covered by the old grids are interpolated from the coarser level, and the
+    //      boxes that kept their rank (see MakeDistributionMap) are copied locally
     // ********************************************************************************************
     FillPatch(lev, time, {&temp_lev_new[Vars::cons],&temp_lev_new[Vars::xvel],
                           &temp_lev_new[Vars::yvel],&temp_lev_new[Vars::zvel]},
@@ -427,7 +446,12 @@ ERF::RemakeLevel (int lev, Real time, const BoxArray& ba, const DistributionMapp
     // ********************************************************************************************
     // Build the data structures for terrain-related quantities
     // ********************************************************************************************
-    update_terrain_arrays(lev, time);
+    if (delta_terrain) {
+        remake_terrain_arrays(lev, time, old_terrain);
+        old_terrain.clear();
+    } else {
+        update_terrain_arrays(lev, time);
+    }
 
     //
     // Make sure that detJ and z_phys_cc are the average of the data on a finer level if there is one
@@ -517,4 +541,6 @@ ERF::ClearLevel (int lev)
 
     // Clears the flux register array
     advflux_reg[lev]->reset();
+
+    BoxCosts::clear(lev);
 }
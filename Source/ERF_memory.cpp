@@ -0,0 +1,195 @@
+#include <ERF.H>
+#include <MemoryReport.H>
+
+using namespace amrex;
+
+/**
+ * Project the memory a rank will hold once level lev is made on ba and dm, from the
+ * sizes of the boxes it owns and the component and ghost cell counts of the state,
+ * integrator scratch, base state and metric data that init_stuff allocates, and abort
+ * if it exceeds erf.memory_budget_per_rank (in GB).  This is called before anything
+ * is allocated for the level, so that a level that does not fit fails without first
+ * running out of memory; the physics packages are not included in the projection.
+ *
+ * @param[in] lev level about to be made
+ * @param[in] ba  grids of the level
+ * @param[in] dm  distribution of the grids
+ */
+void
+ERF::ProjectMemory (int lev, const BoxArray& ba, const DistributionMapping& dm)
+{
+    if (memory_budget_per_rank <= 0.0) return;
+
+    // Components and ghost cells as they are defined in init_stuff
+    int ncomp;
+    if (lev > 0) {
+        ncomp = vars_new[lev-1][Vars::cons].nComp();
+    } else {
+        int n_qstate = micro->Get_Qstate_Size();
+        ncomp = NVAR_max - (NMOIST_max - n_qstate);
+    }
+    const int ngrow_state = ComputeGhostCells(solverChoice.advChoice, solverChoice.use_NumDiff) + 1;
+    const int ngrow_vels  = ComputeGhostCells(solverChoice.advChoice, solverChoice.use_NumDiff);
+
+    const BoxArray ba_x = convert(ba, IntVect(1,0,0));
+    const BoxArray ba_y = convert(ba, IntVect(0,1,0));
+    const BoxArray ba_z = convert(ba, IntVect(0,0,1));
+    const IntVect ng_vels(ngrow_vels);
+
+    // The old and new state and the momenta of the integrator
+    Long nbytes = 2 * MemoryReport::projected_bytes(ba, dm, ncomp, IntVect(ngrow_state));
+    nbytes += 4 * MemoryReport::projected_bytes(ba_x, dm, 1, ng_vels);
+    nbytes += 4 * MemoryReport::projected_bytes(ba_y, dm, 1, ng_vels);
+    nbytes += 2 * MemoryReport::projected_bytes(ba_z, dm, 1, IntVect(ngrow_vels,ngrow_vels,0));
+    nbytes += 2 * MemoryReport::projected_bytes(ba_z, dm, 1, ng_vels);
+
+    // Base state and metrics
+    nbytes += MemoryReport::projected_bytes(ba, dm, 3+1, IntVect(1));
+    nbytes += MemoryReport::projected_bytes(ba_x, dm, 1, IntVect(1));
+    nbytes += MemoryReport::projected_bytes(ba_y, dm, 1, IntVect(1));
+    nbytes += MemoryReport::projected_bytes(ba_z, dm, 1, IntVect(1));
+    if (solverChoice.use_terrain) {
+        const int ngrow_nd = ngrow_vels + 2;
+        const int nz_nd = (solverChoice.terrain_type != TerrainType::Static) ? 3 : 1;
+        nbytes += MemoryReport::projected_bytes(ba, dm, 1, IntVect(1));
+        nbytes += MemoryReport::projected_bytes(convert(ba, IntVect(1)), dm, nz_nd,
+                                                IntVect(ngrow_nd,ngrow_nd,1));
+    }
+
+    // What this rank holds already; the old grids of a level being remade are still allocated
+    nbytes += TotalBytesAllocatedInFabs();
+    ParallelDescriptor::ReduceLongMax(nbytes);
+
+    const Real ngb = static_cast<Real>(nbytes) / (1024.0*1024.0*1024.0);
+    if (ngb > memory_budget_per_rank) {
+        Abort("Making level " + std::to_string(lev) + " would put at least " + std::to_string(ngb) +
+              " GB of fab data on a rank, more than erf.memory_budget_per_rank = " +
+              std::to_string(memory_budget_per_rank) + " GB");
+    }
+}
+
+/**
+ * Add up the persistent data of every level by owning subsystem, print the table
+ * if erf.memory_report is set, and abort if the memory allocated in fabs on any
+ * rank exceeds erf.memory_budget_per_rank (in GB).  This is called once the
+ * initial levels are made and after every regrid, to catch what ProjectMemory
+ * does not project before the run starts (or continues) time stepping.
+ *
+ * @param[in] when what has just happened, for the printout
+ */
+void
+ERF::ReportMemory (const std::string& when)
+{
+    if (!memory_report && memory_budget_per_rank <= 0.0) return;
+
+    BL_PROFILE("ERF::ReportMemory()");
+
+    MemoryReport report(finest_level+1);
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        for (int ivar = 0; ivar < Vars::NumTypes; ++ivar) {
+            report.add("state", lev, &vars_new[lev][ivar]);
+            report.add("state", lev, &vars_old[lev][ivar]);
+        }
+
+        for (auto* mf : {&rU_old[lev], &rU_new[lev], &rV_old[lev], &rV_new[lev], &rW_old[lev], &rW_new[lev]}) {
+            report.add("integrator scratch", lev, mf);
+        }
+#ifdef ERF_USE_POISSON_SOLVE
+        report.add("integrator scratch", lev, &pp_inc[lev]);
+#endif
+
+        report.add("base state", lev, &base_state[lev]);
+        report.add("base state", lev, &base_state_new[lev]);
+
+        for (auto* v : {&z_phys_nd, &z_phys_cc, &detJ_cc, &ax, &ay, &az,
+                        &z_phys_nd_src, &detJ_cc_src, &ax_src, &ay_src, &az_src,
+                        &z_phys_nd_new, &detJ_cc_new, &ax_new, &ay_new, &az_new, &z_t_rk}) {
+            report.add("terrain", lev, (*v)[lev].get());
+        }
+
+        for (auto* v : {&mapfac_m, &mapfac_u, &mapfac_v}) {
+            report.add("map factors", lev, (*v)[lev].get());
+        }
+
+        for (auto* v : {&Tau11_lev, &Tau22_lev, &Tau33_lev, &Tau12_lev, &Tau21_lev,
+                        &Tau13_lev, &Tau31_lev, &Tau23_lev, &Tau32_lev,
+                        &eddyDiffs_lev, &SmnSmn_lev,
+                        &SFS_hfx1_lev, &SFS_hfx2_lev, &SFS_hfx3_lev,
+                        &SFS_diss_lev, &SFS_q1fx3_lev, &SFS_q2fx3_lev}) {
+            report.add("diffusion", lev, (*v)[lev].get());
+        }
+
+        report.add("surface layer", lev, Theta_prim[lev].get());
+        report.add("surface layer", lev, Qv_prim[lev].get());
+        for (const auto& mf : sst_lev[lev])   report.add("surface layer", lev, mf.get());
+        for (const auto& mf : lmask_lev[lev]) report.add("surface layer", lev, mf.get());
+
+        for (auto* mf : qmoist[lev])   report.add("microphysics", lev, mf);
+        report.add("microphysics", lev, micro_tendency[lev].get());
+        report.add("microphysics", lev, micro_accum_rate[lev].get());
+        for (auto* mf : lsm_data[lev]) report.add("land surface", lev, mf);
+        for (auto* mf : lsm_flux[lev]) report.add("land surface", lev, mf);
+
+#ifdef ERF_USE_WINDFARM
+        report.add("wind farm", lev, &Nturb[lev]);
+        report.add("wind farm", lev, &vars_windfarm[lev]);
+#endif
+
+#if defined(ERF_USE_RRTMGP)
+        report.add("radiation", lev, qheating_rates[lev].get());
+        report.add("radiation", lev, sw_lw_fluxes[lev].get());
+        report.add("radiation", lev, solar_zenith[lev].get());
+#endif
+
+        for (auto* v : {&Hwave, &Lwave, &Hwave_onegrid, &Lwave_onegrid}) {
+            report.add("wave coupling", lev, (*v)[lev].get());
+        }
+
+        for (auto* v : {&xflux_imask, &yflux_imask, &zflux_imask}) {
+            report.add("thin body", lev, (*v)[lev].get());
+        }
+        for (auto* v : {&thin_xforce, &thin_yforce, &thin_zforce}) {
+            report.add("thin body", lev, (*v)[lev].get());
+        }
+
+#ifdef ERF_USE_NETCDF
+        if (lev == 0) {
+            for (auto* bdy : {&bdy_data_xlo, &bdy_data_xhi, &bdy_data_ylo, &bdy_data_yhi}) {
+                for (const auto& fabs : *bdy) {
+                    for (const auto& fab : fabs) report.add("real boundary", lev, fab);
+                }
+            }
+        }
+        if (lev < lat_m.size()) report.add("real boundary", lev, lat_m[lev].get());
+        if (lev < lon_m.size()) report.add("real boundary", lev, lon_m[lev].get());
+#endif
+
+        if (lev > 0 && cf_width >= 0 && lev-1 < FPr_c.size()) {
+            for (auto* fpr : {&FPr_c, &FPr_u, &FPr_v, &FPr_w}) {
+                report.add_bytes("coarse-fine patchers", lev, (*fpr)[lev-1].nBytes());
+            }
+        }
+
+        if (field_stats.active()) {
+            report.add("statistics", lev, field_stats.stats(lev));
+        }
+    }
+
+    if (memory_report) {
+        Print() << "Memory after " << when << ":";
+        report.print();
+    }
+
+    if (memory_budget_per_rank > 0.0)
+    {
+        const Long nbytes = report.max_rank_bytes();
+        const Real ngb    = static_cast<Real>(nbytes) / (1024.0*1024.0*1024.0);
+        if (ngb > memory_budget_per_rank) {
+            Abort("After " + when + " a rank holds " + std::to_string(ngb) +
+                  " GB of fab data, more than erf.memory_budget_per_rank = " +
+                  std::to_string(memory_budget_per_rank) + " GB");
+        }
+    }
+}
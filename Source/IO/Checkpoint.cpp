@@ -216,6 +216,9 @@ ERF::WriteCheckpointFile () const
         MultiFab mf_v(convert(ba2d,IntVect(0,1,0)),dmap[lev],1,ng);
         MultiFab::Copy(mf_v,*mapfac_v[lev],0,0,1,ng);
         VisMF::Write(mf_v, MultiFabFileFullPrefix(lev, checkpointname, "Level_", "MapFactor_v"));
+
+        // Running statistics and their accumulated weight
+        field_stats.WriteCheckpoint(lev, checkpointname);
     }
 
 #ifdef ERF_USE_PARTICLES
@@ -348,7 +351,7 @@ ERF::ReadCheckpointFile ()
         GotoNextLine(is);
 
         // create a distribution mapping
-        DistributionMapping dm { ba, ParallelDescriptor::NProcs() };
+        DistributionMapping dm = MakeDistributionMap(lev, ba);
 
         MakeNewLevelFromScratch (lev, t_new[lev], ba, dm);
     }
@@ -469,6 +472,9 @@ ERF::ReadCheckpointFile ()
         MultiFab mf_v(convert(ba2d,IntVect(0,1,0)),dmap[lev],1,ng);
         VisMF::Read(mf_v, MultiFabFileFullPrefix(lev, restart_chkfile, "Level_", "MapFactor_v"));
         MultiFab::Copy(*mapfac_v[lev],mf_v,0,0,1,ng);
+
+        // Running statistics and their accumulated weight
+        field_stats.ReadCheckpoint(lev, restart_chkfile);
     }
 
 #ifdef ERF_USE_PARTICLES
@@ -0,0 +1,188 @@
+#include <ERF.H>
+#include "AMReX_PlotFileUtil.H"
+
+using namespace amrex;
+
+/**
+ * Read the named plotfile output regions (see ERF_PlotRegion.H)
+ */
+void
+ERF::ReadPlotRegions ()
+{
+    ParmParse pp(pp_prefix);
+
+    Vector<std::string> region_names;
+    pp.queryarr("plot_regions", region_names);
+
+    plot_regions.clear();
+
+    for (const auto& name : region_names)
+    {
+        ParmParse ppr(pp_prefix + "." + name);
+
+        PlotRegion reg;
+        reg.name = name;
+
+        std::string region_type;
+        ppr.get("region_type", region_type);
+        if (region_type == "plane") {
+            reg.type = PlotRegion::Type::Plane;
+            ppr.get("normal"  , reg.normal);
+            ppr.get("location", reg.location);
+            if (reg.normal < 0 || reg.normal >= AMREX_SPACEDIM) {
+                Abort("Plot region " + name + ": normal must be 0, 1 or 2");
+            }
+        } else if (region_type == "box") {
+            reg.type = PlotRegion::Type::Box;
+            ppr.getarr("box_lo", reg.box_lo, 0, AMREX_SPACEDIM);
+            ppr.getarr("box_hi", reg.box_hi, 0, AMREX_SPACEDIM);
+        } else if (region_type == "coarsened") {
+            reg.type = PlotRegion::Type::Coarsened;
+            Vector<int> crse(AMREX_SPACEDIM,1);
+            ppr.queryarr("coarsen_ratio", crse, 0, AMREX_SPACEDIM);
+            reg.coarsen_ratio = IntVect(crse);
+            if (reg.coarsen_ratio.min() < 1) {
+                Abort("Plot region " + name + ": coarsen_ratio must be positive");
+            }
+        } else {
+            Abort("Plot region " + name + ": region_type must be plane, box or coarsened");
+        }
+
+        ppr.query("level", reg.level);
+        if (reg.level < 0 || reg.level > max_level) {
+            Abort("Plot region " + name + ": level must be between 0 and max_level");
+        }
+
+        reg.plot_file = "plt_" + name + "_";
+        ppr.query("plot_file", reg.plot_file);
+        ppr.query("plot_int" , reg.plot_int);
+        ppr.query("plot_per" , reg.plot_per);
+        if (reg.plot_int > 0 && reg.plot_per > 0.) {
+            Abort("Plot region " + name + ": must choose only one of plot_int or plot_per");
+        }
+
+        // Same variable selection as plot_vars_1 and plot_vars_2, read from erf.<name>.plot_vars
+        setPlotVariables(name + ".plot_vars", reg.plot_var_names);
+
+        plot_regions.push_back(reg);
+    }
+}
+
+/**
+ * Write a single plot region to disk.  Plane and box regions are cut out of the
+ * existing grids at the region's level and stay on the ranks that own the data;
+ * coarsened regions are averaged down onto the coarsened grids with the same
+ * distribution.  Either way no data is communicated before the write.
+ */
+void
+ERF::WritePlotRegion (PlotRegion& reg)
+{
+    const int lev = reg.level;
+
+    // The level may not have been created yet
+    if (lev > finest_level) return;
+
+    const Vector<std::string> varnames = PlotFileVarNames(reg.plot_var_names);
+    const int ncomp_mf = varnames.size();
+
+    if (ncomp_mf == 0) return;
+
+    if (plotfile_type != "amrex") {
+        Warning("Plot region " + reg.name + " is only written as a native plotfile");
+    }
+
+    // Derived quantities at lev need the coarser levels to fill ghost cells
+    Vector<MultiFab> mf(lev+1);
+    ComputePlotData(reg.plot_var_names, mf, lev);
+
+    const Geometry& gm  = geom[lev];
+    const auto      dx  = gm.CellSizeArray();
+    const Real*     plo = gm.ProbLo();
+
+    MultiFab mf_out;
+    Geometry geom_out;
+
+    if (reg.type == PlotRegion::Type::Coarsened)
+    {
+        const IntVect& crse = reg.coarsen_ratio;
+        if (!grids[lev].coarsenable(crse)) {
+            Abort("Plot region " + reg.name + ": grids are not coarsenable by coarsen_ratio");
+        }
+
+        BoxArray ba_crse(grids[lev]);
+        ba_crse.coarsen(crse);
+        mf_out.define(ba_crse, dmap[lev], ncomp_mf, 0);
+        average_down(mf[lev], mf_out, 0, ncomp_mf, crse);
+
+        geom_out.define(amrex::coarsen(gm.Domain(), crse), gm.ProbDomain(), gm.Coord(), gm.isPeriodic());
+    }
+    else
+    {
+        // Index box of the region at this level
+        Box region(gm.Domain());
+        Real rlo[AMREX_SPACEDIM];
+        Real rhi[AMREX_SPACEDIM];
+        if (reg.type == PlotRegion::Type::Plane) {
+            const int dir = reg.normal;
+            int index = static_cast<int>(std::floor((reg.location - plo[dir]) / dx[dir]));
+            index = amrex::max(region.smallEnd(dir), amrex::min(region.bigEnd(dir), index));
+            region.setSmall(dir, index);
+            region.setBig  (dir, index);
+        } else {
+            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                int ilo = static_cast<int>(std::floor((reg.box_lo[dir] - plo[dir]) / dx[dir]));
+                int ihi = static_cast<int>(std::ceil ((reg.box_hi[dir] - plo[dir]) / dx[dir])) - 1;
+                region.setSmall(dir, amrex::max(ilo, region.smallEnd(dir)));
+                region.setBig  (dir, amrex::min(ihi, region.bigEnd(dir)));
+            }
+        }
+        if (!region.ok()) {
+            Abort("Plot region " + reg.name + " does not intersect the domain");
+        }
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+            rlo[dir] = plo[dir] +  region.smallEnd(dir)      * dx[dir];
+            rhi[dir] = plo[dir] + (region.bigEnd(dir) + 1) * dx[dir];
+        }
+
+        // Intersect the grids at this level with the region, keeping each piece
+        // on the rank that owns the grid it came from
+        BoxList bl_region;
+        Vector<int> procs;
+        Vector<int> src_index;
+        for (int i = 0; i < grids[lev].size(); ++i) {
+            Box bx = grids[lev][i] & region;
+            if (bx.ok()) {
+                bl_region.push_back(bx);
+                procs.push_back(dmap[lev][i]);
+                src_index.push_back(i);
+            }
+        }
+
+        // The region may lie outside the grids of a refined level
+        if (bl_region.isEmpty()) return;
+
+        BoxArray ba_region(std::move(bl_region));
+        DistributionMapping dm_region(std::move(procs));
+        mf_out.define(ba_region, dm_region, ncomp_mf, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf_out, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const Array4<Real      >& dst = mf_out.array(mfi);
+            const Array4<Real const>& src = mf[lev].const_array(src_index[mfi.index()]);
+            ParallelFor(bx, ncomp_mf, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                dst(i,j,k,n) = src(i,j,k,n);
+            });
+        }
+
+        geom_out.define(region, RealBox(rlo,rhi), gm.Coord(), gm.isPeriodic());
+    }
+
+    const std::string plotfilename = Concatenate(reg.plot_file, istep[0], 5);
+    Print() << "Writing plot region " << reg.name << " to " << plotfilename << "\n";
+    WriteSingleLevelPlotfile(plotfilename, mf_out, varnames, geom_out, t_new[lev], istep[0]);
+}
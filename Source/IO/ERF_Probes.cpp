@@ -0,0 +1,402 @@
+#include <ERF_Probes.H>
+#include <IndexDefines.H>
+#include <EOS.H>
+
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace amrex;
+
+namespace {
+    const char* probe_var_names[] = {"density", "theta", "scalar", "qv", "qc", "pressure", "temp",
+                                     "x_velocity", "y_velocity", "z_velocity"};
+    constexpr int n_probe_vars = sizeof(probe_var_names) / sizeof(probe_var_names[0]);
+
+    /**
+     * Base index and weight of a linear interpolation at index-space coordinate r,
+     * clamped so that the stencil stays within [l,h]
+     */
+    AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+    int
+    probe_base (Real r, int l, int h, Real& w, int& ip)
+    {
+        if (h <= l) {
+            w = 0.0; ip = l;
+            return l;
+        }
+        int i = amrex::max(l, amrex::min(h-1, static_cast<int>(std::floor(r))));
+        w  = amrex::max(Real(0.0), amrex::min(Real(1.0), r - i));
+        ip = i + 1;
+        return i;
+    }
+
+    AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+    Real
+    probe_interp (const Array4<Real const>& a, int n, Real rx, Real ry, Real rz,
+                  const Dim3& lo, const Dim3& hi)
+    {
+        Real wx, wy, wz;
+        int ip, jp, kp;
+        int i = probe_base(rx, lo.x, hi.x, wx, ip);
+        int j = probe_base(ry, lo.y, hi.y, wy, jp);
+        int k = probe_base(rz, lo.z, hi.z, wz, kp);
+        return (1.0-wx) * (1.0-wy) * (1.0-wz) * a(i ,j ,k ,n)
+             +      wx  * (1.0-wy) * (1.0-wz) * a(ip,j ,k ,n)
+             + (1.0-wx) *      wy  * (1.0-wz) * a(i ,jp,k ,n)
+             +      wx  *      wy  * (1.0-wz) * a(ip,jp,k ,n)
+             + (1.0-wx) * (1.0-wy) *      wz  * a(i ,j ,kp,n)
+             +      wx  * (1.0-wy) *      wz  * a(ip,j ,kp,n)
+             + (1.0-wx) *      wy  *      wz  * a(i ,jp,kp,n)
+             +      wx  *      wy  *      wz  * a(ip,jp,kp,n);
+    }
+}
+
+/**
+ * Read the probe locations and sampling controls
+ *
+ * @param[in] pp_prefix ParmParse prefix
+ * @param[in] geom0     level 0 geometry, probes outside the domain are dropped
+ */
+void
+ProbeSampler::init (const std::string& pp_prefix, const Geometry& geom0)
+{
+    ParmParse pp(pp_prefix);
+
+    std::string probe_file;
+    if (!pp.query("probe_file", probe_file)) return;
+
+    pp.query("probe_int", m_int);
+    pp.query("probe_per", m_per);
+    if ( (m_int > 0 && m_per > 0.) || (m_int <= 0 && m_per <= 0.) ) {
+        Abort("Must choose exactly one of probe_int or probe_per");
+    }
+    pp.query("probe_output", m_output);
+    pp.query("probe_flush_int", m_flush_int);
+
+    Vector<std::string> vars {"x_velocity", "y_velocity", "z_velocity", "theta"};
+    pp.queryarr("probe_vars", vars);
+    for (const auto& v : vars) {
+        if (std::find(m_vars.begin(), m_vars.end(), v) != m_vars.end()) continue;
+        int isrc = 0;
+        while (isrc < n_probe_vars && v != probe_var_names[isrc]) ++isrc;
+        if (isrc == n_probe_vars) {
+            Abort("Probes can not sample variable " + v);
+        }
+        m_vars.push_back(v);
+        m_var_src.push_back(isrc);
+    }
+
+    auto add_probe = [&] (const std::string& name, const RealVect& x)
+    {
+        if (geom0.ProbDomain().contains(x.dataPtr())) {
+            m_names.push_back(name);
+            m_locs.push_back(x);
+        } else {
+            Warning("Probe " + name + " is outside the domain and is ignored");
+        }
+    };
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(probe_file, fileCharPtr);
+    std::istringstream is(fileCharPtr.dataPtr(), std::istringstream::in);
+
+    std::string line;
+    while (std::getline(is, line))
+    {
+        line = line.substr(0, line.find('#'));
+        std::istringstream ls(line);
+
+        std::string type, name;
+        if (!(ls >> type)) continue;
+        ls >> name;
+
+        if (type == "point") {
+            RealVect x;
+            ls >> x[0] >> x[1] >> x[2];
+            if (ls.fail()) Abort("Could not read probe " + name);
+            add_probe(name, x);
+        } else if (type == "line") {
+            RealVect x0, x1;
+            int n;
+            ls >> x0[0] >> x0[1] >> x0[2] >> x1[0] >> x1[1] >> x1[2] >> n;
+            if (ls.fail() || n < 1) Abort("Could not read probe " + name);
+            for (int i = 0; i < n; ++i) {
+                Real s = (n > 1) ? Real(i) / Real(n-1) : 0.0;
+                add_probe(name + "_" + std::to_string(i), x0 + s*(x1-x0));
+            }
+        } else if (type == "plane") {
+            RealVect x0, x1, x2;
+            int n1, n2;
+            ls >> x0[0] >> x0[1] >> x0[2] >> x1[0] >> x1[1] >> x1[2]
+               >> x2[0] >> x2[1] >> x2[2] >> n1 >> n2;
+            if (ls.fail() || n1 < 1 || n2 < 1) Abort("Could not read probe " + name);
+            for (int j = 0; j < n2; ++j) {
+                for (int i = 0; i < n1; ++i) {
+                    Real s = (n1 > 1) ? Real(i) / Real(n1-1) : 0.0;
+                    Real t = (n2 > 1) ? Real(j) / Real(n2-1) : 0.0;
+                    add_probe(name + "_" + std::to_string(i) + "_" + std::to_string(j),
+                              x0 + s*(x1-x0) + t*(x2-x0));
+                }
+            }
+        } else {
+            Abort("Unknown probe type " + type + "; must be point, line or plane");
+        }
+    }
+
+    Print() << "Read " << m_locs.size() << " probe locations from " << probe_file << "\n";
+
+    write_header();
+}
+
+/**
+ * Find the finest level covering the interpolation stencil of each probe and,
+ * for the probes owned by this rank, store their locations grouped by box
+ */
+void
+ProbeSampler::build_stencils (int finest_level, const Vector<Geometry>& geom,
+                              const Vector<Vector<MultiFab>>& vars_new)
+{
+    BL_PROFILE("ProbeSampler::build_stencils()");
+
+    const int nlevs  = finest_level+1;
+    const int myproc = ParallelDescriptor::MyProc();
+
+    m_ba.resize(nlevs);
+    m_dm.resize(nlevs);
+    for (int lev = 0; lev < nlevs; ++lev) {
+        m_ba[lev] = vars_new[lev][Vars::cons].boxArray();
+        m_dm[lev] = vars_new[lev][Vars::cons].DistributionMap();
+    }
+
+    m_nprobes_lev.assign(nlevs, 0);
+    Vector<Vector<std::pair<int,ProbeLoc>>> local(nlevs);
+
+    for (int p = 0; p < m_locs.size(); ++p)
+    {
+        for (int lev = finest_level; lev >= 0; --lev)
+        {
+            const Real* plo   = geom[lev].ProbLo();
+            const auto  dxinv = geom[lev].InvCellSizeArray();
+
+            Real r[AMREX_SPACEDIM];
+            IntVect iv;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                r[d]  = (m_locs[p][d] - plo[d]) * dxinv[d];
+                iv[d] = static_cast<int>(std::floor(r[d]));
+            }
+            iv.min(geom[lev].Domain().bigEnd());
+            iv.max(geom[lev].Domain().smallEnd());
+
+            // On refined levels the whole stencil must be covered by valid data
+            Box stencil(iv - IntVect(1), iv + IntVect(1));
+            stencil &= geom[lev].Domain();
+            if (lev > 0 && !m_ba[lev].contains(stencil)) continue;
+
+            auto isects = m_ba[lev].intersections(Box(iv,iv), true, 0);
+            if (isects.empty()) continue;
+
+            const int box = isects[0].first;
+            m_nprobes_lev[lev]++;
+            if (m_dm[lev][box] == myproc) {
+                local[lev].emplace_back(box, ProbeLoc{p, r[0], r[1], r[2]});
+            }
+            break;
+        }
+    }
+
+    m_stencils.resize(nlevs);
+    m_box_range.resize(nlevs);
+    for (int lev = 0; lev < nlevs; ++lev)
+    {
+        auto& loc = local[lev];
+        std::stable_sort(loc.begin(), loc.end(),
+                         [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+        m_box_range[lev].clear();
+        Vector<ProbeLoc> h_loc(loc.size());
+        for (int n = 0; n < loc.size(); ++n) {
+            h_loc[n] = loc[n].second;
+            auto it = m_box_range[lev].find(loc[n].first);
+            if (it == m_box_range[lev].end()) {
+                m_box_range[lev][loc[n].first] = std::make_pair(n, 1);
+            } else {
+                it->second.second++;
+            }
+        }
+
+        m_stencils[lev].resize(h_loc.size());
+        Gpu::copyAsync(Gpu::hostToDevice, h_loc.begin(), h_loc.end(), m_stencils[lev].begin());
+    }
+    Gpu::streamSynchronize();
+}
+
+/**
+ * Sample all probes at the current time.  The values of the probes owned by each
+ * rank are combined on the I/O rank with a single reduction and buffered.
+ */
+void
+ProbeSampler::sample (Real time, int finest_level, const Vector<Geometry>& geom,
+                      Vector<Vector<MultiFab>>& vars_new)
+{
+    if (!active()) return;
+
+    BL_PROFILE("ProbeSampler::sample()");
+
+    // Only rebuild the stencils when the grids have changed
+    bool regridded = (m_ba.size() != finest_level+1);
+    for (int lev = 0; lev <= finest_level && !regridded; ++lev) {
+        regridded = (m_ba[lev] != vars_new[lev][Vars::cons].boxArray()) ||
+                    (m_dm[lev] != vars_new[lev][Vars::cons].DistributionMap());
+    }
+    if (regridded) {
+        build_stencils(finest_level, geom, vars_new);
+    }
+
+    const int nprobes = m_locs.size();
+    const int nvars   = m_vars.size();
+
+    Gpu::DeviceVector<Real> d_vals(nprobes*nvars, 0.0);
+    Real* vals = d_vals.data();
+
+    GpuArray<int,n_probe_vars> src;
+    for (int n = 0; n < nvars; ++n) {
+        src[n] = m_var_src[n];
+    }
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        if (m_nprobes_lev[lev] == 0) continue;
+
+        MultiFab& cons = vars_new[lev][Vars::cons];
+        MultiFab& xvel = vars_new[lev][Vars::xvel];
+        MultiFab& yvel = vars_new[lev][Vars::yvel];
+        MultiFab& zvel = vars_new[lev][Vars::zvel];
+
+        // The stencils may reach one cell into a neighboring box
+        cons.FillBoundary(geom[lev].periodicity());
+        xvel.FillBoundary(geom[lev].periodicity());
+        yvel.FillBoundary(geom[lev].periodicity());
+        zvel.FillBoundary(geom[lev].periodicity());
+
+        const Box& domain = geom[lev].Domain();
+        const Dim3 lo   = lbound(domain);
+        const Dim3 hi   = ubound(domain);
+        const Dim3 hi_x = {hi.x+1, hi.y  , hi.z  };
+        const Dim3 hi_y = {hi.x  , hi.y+1, hi.z  };
+        const Dim3 hi_z = {hi.x  , hi.y  , hi.z+1};
+
+        const int ncomp_cons = cons.nComp();
+
+        for (MFIter mfi(cons); mfi.isValid(); ++mfi)
+        {
+            auto it = m_box_range[lev].find(mfi.index());
+            if (it == m_box_range[lev].end()) continue;
+
+            const ProbeLoc* locs = m_stencils[lev].data() + it->second.first;
+            const int       nloc = it->second.second;
+
+            const Array4<Real const>& c = cons.const_array(mfi);
+            const Array4<Real const>& u = xvel.const_array(mfi);
+            const Array4<Real const>& v = yvel.const_array(mfi);
+            const Array4<Real const>& w = zvel.const_array(mfi);
+
+            ParallelFor(nloc, [=] AMREX_GPU_DEVICE (int p) noexcept
+            {
+                const ProbeLoc& L = locs[p];
+                const Real cx = L.rx - 0.5;
+                const Real cy = L.ry - 0.5;
+                const Real cz = L.rz - 0.5;
+
+                const Real rho      = probe_interp(c, Rho_comp     , cx, cy, cz, lo, hi);
+                const Real rhotheta = probe_interp(c, RhoTheta_comp, cx, cy, cz, lo, hi);
+                const Real qv = (ncomp_cons > RhoQ1_comp) ? probe_interp(c, RhoQ1_comp, cx, cy, cz, lo, hi) / rho : 0.0;
+
+                // Cases follow the order of probe_var_names
+                for (int n = 0; n < nvars; ++n) {
+                    Real val;
+                    switch (src[n]) {
+                        case 0: val = rho;            break;
+                        case 1: val = rhotheta / rho; break;
+                        case 2: val = probe_interp(c, RhoScalar_comp, cx, cy, cz, lo, hi) / rho; break;
+                        case 3: val = qv;             break;
+                        case 4: val = (ncomp_cons > RhoQ2_comp) ?
+                                      probe_interp(c, RhoQ2_comp, cx, cy, cz, lo, hi) / rho : 0.0;
+                                break;
+                        case 5: val = getPgivenRTh(rhotheta, qv);          break;
+                        case 6: val = getTgivenRandRTh(rho, rhotheta, qv); break;
+                        case 7: val = probe_interp(u, 0, L.rx, cy, cz, lo, hi_x); break;
+                        case 8: val = probe_interp(v, 0, cx, L.ry, cz, lo, hi_y); break;
+                        default: val = probe_interp(w, 0, cx, cy, L.rz, lo, hi_z);
+                    }
+                    vals[L.probe*nvars + n] = val;
+                }
+            });
+        }
+    }
+
+    // Each probe is owned by exactly one rank, so a sum gathers all the values
+    Vector<Real> h_vals(nprobes*nvars);
+    Gpu::copyAsync(Gpu::deviceToHost, d_vals.begin(), d_vals.end(), h_vals.begin());
+    Gpu::streamSynchronize();
+    ParallelDescriptor::ReduceRealSum(h_vals.data(), h_vals.size(), ParallelDescriptor::IOProcessorNumber());
+
+    if (ParallelDescriptor::IOProcessor()) {
+        m_buffer.push_back(time);
+        m_buffer.insert(m_buffer.end(), h_vals.begin(), h_vals.end());
+        m_nbuffered++;
+    }
+
+    if (m_nbuffered >= m_flush_int) {
+        flush();
+    }
+}
+
+/**
+ * Append the buffered samples to <probe_output>.bin; each record is the time
+ * followed by the values of all variables at all probes
+ */
+void
+ProbeSampler::flush ()
+{
+    if (m_nbuffered == 0 || !ParallelDescriptor::IOProcessor()) return;
+
+    BL_PROFILE("ProbeSampler::flush()");
+
+    std::ofstream ofs(m_output + ".bin", std::ios::out | std::ios::app | std::ios::binary);
+    if (!ofs.good()) {
+        FileOpenFailed(m_output + ".bin");
+    }
+    ofs.write(reinterpret_cast<const char*>(m_buffer.data()),
+              static_cast<std::streamsize>(m_buffer.size()*sizeof(Real)));
+
+    m_buffer.clear();
+    m_nbuffered = 0;
+}
+
+/**
+ * Describe the layout of the binary file in <probe_output>.hdr
+ */
+void
+ProbeSampler::write_header () const
+{
+    if (!ParallelDescriptor::IOProcessor()) return;
+
+    std::ofstream hdr(m_output + ".hdr");
+    if (!hdr.good()) {
+        FileOpenFailed(m_output + ".hdr");
+    }
+    hdr.precision(17);
+    hdr << "ERF probes\n";
+    hdr << sizeof(Real) << "\n";
+    hdr << m_locs.size() << " " << m_vars.size() << "\n";
+    for (const auto& v : m_vars) {
+        hdr << v << " ";
+    }
+    hdr << "\n";
+    for (int p = 0; p < m_locs.size(); ++p) {
+        hdr << m_names[p] << " " << m_locs[p][0] << " " << m_locs[p][1] << " " << m_locs[p][2] << "\n";
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "ERF.H"
 #include "EOS.H"
+#include "Utils.H"
 
 using namespace amrex;
 
@@ -215,11 +216,13 @@ ERF::derive_diag_profiles(Real /*time*/,
     //                  0      1     2      3   4   5   6   7   8   9   10   11   12
     //                thth, uiuiu, uiuiv, uiuiw, p, pu, pv, pw, qv, qc, qr, wqv, wqc, wqr,
     //                  13     14     15     16 17  18  19  20  21  22  23   24   25   26
-    //                qi, qs, qg, wthv
-    //                27  28  29    30
-    MultiFab mf_out(grids[lev], dmap[lev], 31, 0);
+    //                qi, qs, qg, wthv, u, v, w
+    //                27  28  29    30 31 32 33
+    MultiFab mf_out(grids[lev], dmap[lev], 34, 0);
 
-    MultiFab mf_vels(grids[lev], dmap[lev], AMREX_SPACEDIM, 0);
+    // The cell-centered velocities live in the last three components so that all
+    // profiles are averaged together below
+    MultiFab mf_vels(mf_out, make_alias, 31, AMREX_SPACEDIM);
 
     MultiFab  u_cc(mf_vels, make_alias, 0, 1); // u at cell centers
     MultiFab  v_cc(mf_vels, make_alias, 1, 1); // v at cell centers
@@ -228,36 +231,14 @@ ERF::derive_diag_profiles(Real /*time*/,
     average_face_to_cellcenter(mf_vels,0,
         Array<const MultiFab*,3>{&vars_new[lev][Vars::xvel],&vars_new[lev][Vars::yvel],&vars_new[lev][Vars::zvel]});
 
-    int zdir = 2;
     auto domain = geom[0].Domain();
 
-    // Sum in the horizontal plane
-    h_avg_u  = sumToLine(mf_vels ,0,1,domain,zdir);
-    h_avg_v  = sumToLine(mf_vels ,1,1,domain,zdir);
-    h_avg_w  = sumToLine(mf_vels ,2,1,domain,zdir);
-
-    int hu_size =  h_avg_u.size();
-
-    // Divide by the total number of cells we are averaging over
-    Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
-    for (int k = 0; k < hu_size; ++k) {
-        h_avg_u[k] /= area_z; h_avg_v[k] /= area_z; h_avg_w[k] /= area_z;
-    }
-
-    Gpu::DeviceVector<Real> d_avg_u(hu_size, Real(0.0));
-    Gpu::DeviceVector<Real> d_avg_v(hu_size, Real(0.0));
-    Gpu::DeviceVector<Real> d_avg_w(hu_size, Real(0.0));
-
 #if 0
     auto* avg_u_ptr = d_avg_u.data();
     auto* avg_v_ptr = d_avg_v.data();
     auto* avg_w_ptr = d_avg_w.data();
 #endif
 
-    Gpu::copy(Gpu::hostToDevice, h_avg_u.begin(), h_avg_u.end(), d_avg_u.begin());
-    Gpu::copy(Gpu::hostToDevice, h_avg_v.begin(), h_avg_v.end(), d_avg_v.begin());
-    Gpu::copy(Gpu::hostToDevice, h_avg_w.begin(), h_avg_w.end(), d_avg_w.begin());
-
     int nvars = vars_new[lev][Vars::cons].nComp();
     MultiFab mf_cons(vars_new[lev][Vars::cons], make_alias, 0, nvars);
 
@@ -392,56 +373,51 @@ ERF::derive_diag_profiles(Real /*time*/,
         } // mfi
     } // use_moisture
 
-    h_avg_rho   = sumToLine(mf_out, 0,1,domain,zdir);
-    h_avg_th    = sumToLine(mf_out, 1,1,domain,zdir);
-    h_avg_ksgs  = sumToLine(mf_out, 2,1,domain,zdir);
-    h_avg_kturb = sumToLine(mf_out, 3,1,domain,zdir);
-    h_avg_uu    = sumToLine(mf_out, 4,1,domain,zdir);
-    h_avg_uv    = sumToLine(mf_out, 5,1,domain,zdir);
-    h_avg_uw    = sumToLine(mf_out, 6,1,domain,zdir);
-    h_avg_vv    = sumToLine(mf_out, 7,1,domain,zdir);
-    h_avg_vw    = sumToLine(mf_out, 8,1,domain,zdir);
-    h_avg_ww    = sumToLine(mf_out, 9,1,domain,zdir);
-    h_avg_uth   = sumToLine(mf_out,10,1,domain,zdir);
-    h_avg_vth   = sumToLine(mf_out,11,1,domain,zdir);
-    h_avg_wth   = sumToLine(mf_out,12,1,domain,zdir);
-    h_avg_thth  = sumToLine(mf_out,13,1,domain,zdir);
-    h_avg_uiuiu = sumToLine(mf_out,14,1,domain,zdir);
-    h_avg_uiuiv = sumToLine(mf_out,15,1,domain,zdir);
-    h_avg_uiuiw = sumToLine(mf_out,16,1,domain,zdir);
-    h_avg_p     = sumToLine(mf_out,17,1,domain,zdir);
-    h_avg_pu    = sumToLine(mf_out,18,1,domain,zdir);
-    h_avg_pv    = sumToLine(mf_out,19,1,domain,zdir);
-    h_avg_pw    = sumToLine(mf_out,20,1,domain,zdir);
-    h_avg_qv    = sumToLine(mf_out,21,1,domain,zdir);
-    h_avg_qc    = sumToLine(mf_out,22,1,domain,zdir);
-    h_avg_qr    = sumToLine(mf_out,23,1,domain,zdir);
-    h_avg_wqv   = sumToLine(mf_out,24,1,domain,zdir);
-    h_avg_wqc   = sumToLine(mf_out,25,1,domain,zdir);
-    h_avg_wqr   = sumToLine(mf_out,26,1,domain,zdir);
-    h_avg_qi    = sumToLine(mf_out,27,1,domain,zdir);
-    h_avg_qs    = sumToLine(mf_out,28,1,domain,zdir);
-    h_avg_qg    = sumToLine(mf_out,29,1,domain,zdir);
-    h_avg_wthv  = sumToLine(mf_out,30,1,domain,zdir);
-
-    // Divide by the total number of cells we are averaging over
-    int h_avg_u_size = static_cast<int>(h_avg_u.size());
-    for (int k = 0; k < h_avg_u_size; ++k) {
-        h_avg_rho[k] /= area_z;  h_avg_ksgs[k] /= area_z; h_avg_kturb[k] /= area_z;
-        h_avg_th[k]  /= area_z;  h_avg_thth[k] /= area_z;
-        h_avg_uu[k]  /= area_z;  h_avg_uv[k]   /= area_z;  h_avg_uw[k]  /= area_z;
-        h_avg_vv[k]  /= area_z;  h_avg_vw[k]   /= area_z;  h_avg_ww[k]  /= area_z;
-        h_avg_uth[k] /= area_z;  h_avg_vth[k]  /= area_z;  h_avg_wth[k] /= area_z;
-        h_avg_uiuiu[k] /= area_z;
-        h_avg_uiuiv[k] /= area_z;
-        h_avg_uiuiw[k] /= area_z;
-        h_avg_p[k]   /= area_z;
-        h_avg_pu[k]  /= area_z;  h_avg_pv[k]   /= area_z;  h_avg_pw[k]  /= area_z;
-        h_avg_qv[k]  /= area_z;  h_avg_qc[k]   /= area_z;  h_avg_qr[k]  /= area_z;
-        h_avg_wqv[k] /= area_z;  h_avg_wqc[k]  /= area_z;  h_avg_wqr[k] /= area_z;
-        h_avg_qi[k]  /= area_z;  h_avg_qs[k]   /= area_z;  h_avg_qg[k]  /= area_z;
-        h_avg_wthv[k] /= area_z;
-    }
+    // Average all profiles in the horizontal plane with one pass and one reduction
+    Gpu::HostVector<Real> h_avg = HorizontalAverages(mf_out, 0, mf_out.nComp(), domain);
+
+    const int h_avg_u_size = domain.length(2);
+    auto profile = [&] (Gpu::HostVector<Real>& h_prof, int n)
+    {
+        h_prof.resize(h_avg_u_size);
+        std::copy(h_avg.begin() +  n   *h_avg_u_size,
+                  h_avg.begin() + (n+1)*h_avg_u_size, h_prof.begin());
+    };
+
+    profile(h_avg_rho,   0);
+    profile(h_avg_th,    1);
+    profile(h_avg_ksgs,  2);
+    profile(h_avg_kturb, 3);
+    profile(h_avg_uu,    4);
+    profile(h_avg_uv,    5);
+    profile(h_avg_uw,    6);
+    profile(h_avg_vv,    7);
+    profile(h_avg_vw,    8);
+    profile(h_avg_ww,    9);
+    profile(h_avg_uth,  10);
+    profile(h_avg_vth,  11);
+    profile(h_avg_wth,  12);
+    profile(h_avg_thth, 13);
+    profile(h_avg_uiuiu,14);
+    profile(h_avg_uiuiv,15);
+    profile(h_avg_uiuiw,16);
+    profile(h_avg_p,    17);
+    profile(h_avg_pu,   18);
+    profile(h_avg_pv,   19);
+    profile(h_avg_pw,   20);
+    profile(h_avg_qv,   21);
+    profile(h_avg_qc,   22);
+    profile(h_avg_qr,   23);
+    profile(h_avg_wqv,  24);
+    profile(h_avg_wqc,  25);
+    profile(h_avg_wqr,  26);
+    profile(h_avg_qi,   27);
+    profile(h_avg_qs,   28);
+    profile(h_avg_qg,   29);
+    profile(h_avg_wthv, 30);
+    profile(h_avg_u,    31);
+    profile(h_avg_v,    32);
+    profile(h_avg_w,    33);
 
 #if 0
     // Here we print the integrated total kinetic energy as computed in the 1D profile above
@@ -510,30 +486,27 @@ ERF::derive_stress_profiles (Gpu::HostVector<Real>& h_avg_tau11, Gpu::HostVector
         });
     }
 
-    int zdir = 2;
     auto domain = geom[0].Domain();
 
-    h_avg_tau11 = sumToLine(mf_out,0,1,domain,zdir);
-    h_avg_tau12 = sumToLine(mf_out,1,1,domain,zdir);
-    h_avg_tau13 = sumToLine(mf_out,2,1,domain,zdir);
-    h_avg_tau22 = sumToLine(mf_out,3,1,domain,zdir);
-    h_avg_tau23 = sumToLine(mf_out,4,1,domain,zdir);
-    h_avg_tau33 = sumToLine(mf_out,5,1,domain,zdir);
-    h_avg_hfx3  = sumToLine(mf_out,6,1,domain,zdir);
-    h_avg_q1fx3 = sumToLine(mf_out,7,1,domain,zdir);
-    h_avg_q2fx3 = sumToLine(mf_out,8,1,domain,zdir);
-    h_avg_diss  = sumToLine(mf_out,9,1,domain,zdir);
-
-    int ht_size =  h_avg_tau11.size();
-
-    // Divide by the total number of cells we are averaging over
-    Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
-    for (int k = 0; k < ht_size; ++k) {
-        h_avg_tau11[k] /= area_z; h_avg_tau12[k] /= area_z; h_avg_tau13[k] /= area_z;
-        h_avg_tau22[k] /= area_z; h_avg_tau23[k] /= area_z;
-        h_avg_tau33[k] /= area_z;
-        h_avg_hfx3[k] /= area_z;
-        h_avg_q1fx3[k] /= area_z; h_avg_q2fx3[k] /= area_z;
-        h_avg_diss[k] /= area_z;
-    }
+    // Average all profiles in the horizontal plane with one pass and one reduction
+    Gpu::HostVector<Real> h_avg = HorizontalAverages(mf_out, 0, mf_out.nComp(), domain);
+
+    const int ht_size = domain.length(2);
+    auto profile = [&] (Gpu::HostVector<Real>& h_prof, int n)
+    {
+        h_prof.resize(ht_size);
+        std::copy(h_avg.begin() +  n   *ht_size,
+                  h_avg.begin() + (n+1)*ht_size, h_prof.begin());
+    };
+
+    profile(h_avg_tau11, 0);
+    profile(h_avg_tau12, 1);
+    profile(h_avg_tau13, 2);
+    profile(h_avg_tau22, 3);
+    profile(h_avg_tau23, 4);
+    profile(h_avg_tau33, 5);
+    profile(h_avg_hfx3,  6);
+    profile(h_avg_q1fx3, 7);
+    profile(h_avg_q2fx3, 8);
+    profile(h_avg_diss,  9);
 }
@@ -2,6 +2,7 @@
 
 #include "ERF.H"
 #include "EOS.H"
+#include "Utils.H"
 
 using namespace amrex;
 
@@ -320,22 +321,22 @@ ERF::derive_diag_profiles_stag (Real /*time*/,
     // Note: "uiui" == u_i*u_i = u*u + v*v + w*w
     // This will hold rho, theta, ksgs, kturb, uu, uv, vv, uth, vth,
     //       indices:   0      1     2      3   4   5   6    7    8
-    //                thth, uiuiu, uiuiv, p, pu, pv, qv, qc, qr, qi, qs, qg
-    //                   9     10     11 12  13  14  15  16  17  18  19  20
-    MultiFab mf_out(grids[lev], dmap[lev], 21, 0);
+    //                thth, uiuiu, uiuiv, p, pu, pv, qv, qc, qr, qi, qs, qg, u, v
+    //                   9     10     11 12  13  14  15  16  17  18  19  20 21 22
+    MultiFab mf_out(grids[lev], dmap[lev], 23, 0);
 
-    // This will hold uw, vw, ww, wth, uiuiw, pw, wqv, wqc, wqr, wthv
-    //       indices:  0   1   2    3      4   5    6    7    8     9
-    MultiFab mf_out_stag(convert(grids[lev], IntVect(0,0,1)), dmap[lev], 10, 0);
+    // This will hold uw, vw, ww, wth, uiuiw, pw, wqv, wqc, wqr, wthv, w
+    //       indices:  0   1   2    3      4   5    6    7    8     9 10
+    MultiFab mf_out_stag(convert(grids[lev], IntVect(0,0,1)), dmap[lev], 11, 0);
 
-    // This is only used to average u and v; w is not averaged to cell centers
-    MultiFab mf_vels(grids[lev], dmap[lev], 2, 0);
+    // This is only used to average u and v; w is not averaged to cell centers.
+    // The velocities live in the last components so that all profiles are averaged together.
+    MultiFab mf_vels(mf_out, make_alias, 21, 2);
 
     MultiFab  u_cc(mf_vels, make_alias, 0, 1); // u at cell centers
     MultiFab  v_cc(mf_vels, make_alias, 1, 1); // v at cell centers
     MultiFab  w_fc(vars_new[lev][Vars::zvel], make_alias, 0, 1); // w at face centers (staggered)
 
-    int zdir = 2;
     auto domain = geom[0].Domain();
     Box stag_domain = domain;
     stag_domain.convert(IntVect(0,0,1));
@@ -427,6 +428,7 @@ ERF::derive_diag_profiles_stag (Real /*time*/,
             fab_arr_stag(i,j,k,3) =          thface * w_fc_arr(i,j,k); // th*w
             Real uiui = uface*uface + vface*vface + fab_arr_stag(i,j,k,2);
             fab_arr_stag(i,j,k,4) = uiui * w_fc_arr(i,j,k); // (ui*ui)*w
+            fab_arr_stag(i,j,k,10) = w_fc_arr(i,j,k);       // w
             if (!use_moisture) {
                 Real p0 = getPgivenRTh(cons_arr(i, j, k  , RhoTheta_comp)) - p0_arr(i,j,k  );
                 Real p1 = getPgivenRTh(cons_arr(i, j, k-1, RhoTheta_comp)) - p0_arr(i,j,k-1);
@@ -517,86 +519,54 @@ ERF::derive_diag_profiles_stag (Real /*time*/,
         } // mfi
     } // use_moisture
 
-    // Sum in the horizontal plane
-    h_avg_u = sumToLine(u_cc,0,1,     domain,zdir);
-    h_avg_v = sumToLine(v_cc,0,1,     domain,zdir);
-    h_avg_w = sumToLine(w_fc,0,1,stag_domain,zdir);
-
-    h_avg_rho   = sumToLine(mf_out, 0,1,domain,zdir);
-    h_avg_th    = sumToLine(mf_out, 1,1,domain,zdir);
-    h_avg_ksgs  = sumToLine(mf_out, 2,1,domain,zdir);
-    h_avg_kturb = sumToLine(mf_out, 3,1,domain,zdir);
-    h_avg_uu    = sumToLine(mf_out, 4,1,domain,zdir);
-    h_avg_uv    = sumToLine(mf_out, 5,1,domain,zdir);
-    h_avg_vv    = sumToLine(mf_out, 6,1,domain,zdir);
-    h_avg_uth   = sumToLine(mf_out, 7,1,domain,zdir);
-    h_avg_vth   = sumToLine(mf_out, 8,1,domain,zdir);
-    h_avg_thth  = sumToLine(mf_out, 9,1,domain,zdir);
-    h_avg_uiuiu = sumToLine(mf_out,10,1,domain,zdir);
-    h_avg_uiuiv = sumToLine(mf_out,11,1,domain,zdir);
-    h_avg_p     = sumToLine(mf_out,12,1,domain,zdir);
-    h_avg_pu    = sumToLine(mf_out,13,1,domain,zdir);
-    h_avg_pv    = sumToLine(mf_out,14,1,domain,zdir);
-    h_avg_qv    = sumToLine(mf_out,15,1,domain,zdir);
-    h_avg_qc    = sumToLine(mf_out,16,1,domain,zdir);
-    h_avg_qr    = sumToLine(mf_out,17,1,domain,zdir);
-    h_avg_qi    = sumToLine(mf_out,18,1,domain,zdir);
-    h_avg_qs    = sumToLine(mf_out,19,1,domain,zdir);
-    h_avg_qg    = sumToLine(mf_out,20,1,domain,zdir);
-
-    h_avg_uw    = sumToLine(mf_out_stag,0,1,stag_domain,zdir);
-    h_avg_vw    = sumToLine(mf_out_stag,1,1,stag_domain,zdir);
-    h_avg_ww    = sumToLine(mf_out_stag,2,1,stag_domain,zdir);
-    h_avg_wth   = sumToLine(mf_out_stag,3,1,stag_domain,zdir);
-    h_avg_uiuiw = sumToLine(mf_out_stag,4,1,stag_domain,zdir);
-    h_avg_pw    = sumToLine(mf_out_stag,5,1,stag_domain,zdir);
-    h_avg_wqv   = sumToLine(mf_out_stag,6,1,stag_domain,zdir);
-    h_avg_wqc   = sumToLine(mf_out_stag,7,1,stag_domain,zdir);
-    h_avg_wqr   = sumToLine(mf_out_stag,8,1,stag_domain,zdir);
-    h_avg_wthv  = sumToLine(mf_out_stag,9,1,stag_domain,zdir);
-
-    // Divide by the total number of cells we are averaging over
-    Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
-    int unstag_size = h_avg_w.size() - 1; // _un_staggered heights
-    for (int k = 0; k < unstag_size; ++k) {
-        h_avg_u[k]     /= area_z;
-        h_avg_v[k]     /= area_z;
-        h_avg_rho[k]   /= area_z;
-        h_avg_ksgs[k]  /= area_z;
-        h_avg_kturb[k] /= area_z;
-        h_avg_th[k]    /= area_z;
-        h_avg_thth[k]  /= area_z;
-        h_avg_uu[k]    /= area_z;
-        h_avg_uv[k]    /= area_z;
-        h_avg_vv[k]    /= area_z;
-        h_avg_uth[k]   /= area_z;
-        h_avg_vth[k]   /= area_z;
-        h_avg_uiuiu[k] /= area_z;
-        h_avg_uiuiv[k] /= area_z;
-        h_avg_p[k]     /= area_z;
-        h_avg_pu[k]    /= area_z;
-        h_avg_pv[k]    /= area_z;
-        h_avg_qv[k]    /= area_z;
-        h_avg_qc[k]    /= area_z;
-        h_avg_qr[k]    /= area_z;
-        h_avg_qi[k]    /= area_z;
-        h_avg_qs[k]    /= area_z;
-        h_avg_qg[k]    /= area_z;
-    }
+    // Average all profiles in the horizontal plane with one pass and one reduction
+    // for the cell-centered and one for the staggered quantities
+    Gpu::HostVector<Real> h_avg      = HorizontalAverages(mf_out     , 0, mf_out.nComp()     ,      domain);
+    Gpu::HostVector<Real> h_avg_stag = HorizontalAverages(mf_out_stag, 0, mf_out_stag.nComp(), stag_domain);
 
-    for (int k = 0; k < unstag_size+1; ++k) { // staggered heights
-        h_avg_w[k]     /= area_z;
-        h_avg_uw[k]    /= area_z;
-        h_avg_vw[k]    /= area_z;
-        h_avg_ww[k]    /= area_z;
-        h_avg_wth[k]   /= area_z;
-        h_avg_uiuiw[k] /= area_z;
-        h_avg_pw[k]    /= area_z;
-        h_avg_wqv[k]   /= area_z;
-        h_avg_wqc[k]   /= area_z;
-        h_avg_wqr[k]   /= area_z;
-        h_avg_wthv[k]  /= area_z;
-    }
+    auto profile = [] (const Gpu::HostVector<Real>& h_all, int nz, Gpu::HostVector<Real>& h_prof, int n)
+    {
+        h_prof.resize(nz);
+        std::copy(h_all.begin() +  n   *nz,
+                  h_all.begin() + (n+1)*nz, h_prof.begin());
+    };
+
+    const int unstag_size = domain.length(2); // _un_staggered heights
+    profile(h_avg     , unstag_size  , h_avg_rho,   0);
+    profile(h_avg     , unstag_size  , h_avg_th,    1);
+    profile(h_avg     , unstag_size  , h_avg_ksgs,  2);
+    profile(h_avg     , unstag_size  , h_avg_kturb, 3);
+    profile(h_avg     , unstag_size  , h_avg_uu,    4);
+    profile(h_avg     , unstag_size  , h_avg_uv,    5);
+    profile(h_avg     , unstag_size  , h_avg_vv,    6);
+    profile(h_avg     , unstag_size  , h_avg_uth,   7);
+    profile(h_avg     , unstag_size  , h_avg_vth,   8);
+    profile(h_avg     , unstag_size  , h_avg_thth,  9);
+    profile(h_avg     , unstag_size  , h_avg_uiuiu,10);
+    profile(h_avg     , unstag_size  , h_avg_uiuiv,11);
+    profile(h_avg     , unstag_size  , h_avg_p,    12);
+    profile(h_avg     , unstag_size  , h_avg_pu,   13);
+    profile(h_avg     , unstag_size  , h_avg_pv,   14);
+    profile(h_avg     , unstag_size  , h_avg_qv,   15);
+    profile(h_avg     , unstag_size  , h_avg_qc,   16);
+    profile(h_avg     , unstag_size  , h_avg_qr,   17);
+    profile(h_avg     , unstag_size  , h_avg_qi,   18);
+    profile(h_avg     , unstag_size  , h_avg_qs,   19);
+    profile(h_avg     , unstag_size  , h_avg_qg,   20);
+    profile(h_avg     , unstag_size  , h_avg_u,    21);
+    profile(h_avg     , unstag_size  , h_avg_v,    22);
+
+    profile(h_avg_stag, unstag_size+1, h_avg_uw,    0);
+    profile(h_avg_stag, unstag_size+1, h_avg_vw,    1);
+    profile(h_avg_stag, unstag_size+1, h_avg_ww,    2);
+    profile(h_avg_stag, unstag_size+1, h_avg_wth,   3);
+    profile(h_avg_stag, unstag_size+1, h_avg_uiuiw, 4);
+    profile(h_avg_stag, unstag_size+1, h_avg_pw,    5);
+    profile(h_avg_stag, unstag_size+1, h_avg_wqv,   6);
+    profile(h_avg_stag, unstag_size+1, h_avg_wqc,   7);
+    profile(h_avg_stag, unstag_size+1, h_avg_wqr,   8);
+    profile(h_avg_stag, unstag_size+1, h_avg_wthv,  9);
+    profile(h_avg_stag, unstag_size+1, h_avg_w,    10);
 }
 
 void
@@ -671,42 +641,34 @@ ERF::derive_stress_profiles_stag (Gpu::HostVector<Real>& h_avg_tau11, Gpu::HostV
         });
     }
 
-    int zdir = 2;
     auto domain = geom[0].Domain();
     Box stag_domain = domain;
     stag_domain.convert(IntVect(0,0,1));
 
-    h_avg_tau11 = sumToLine(mf_out,0,1,domain,zdir);
-    h_avg_tau12 = sumToLine(mf_out,1,1,domain,zdir);
-//  h_avg_tau13 = sumToLine(mf_out,2,1,domain,zdir);
-    h_avg_tau22 = sumToLine(mf_out,3,1,domain,zdir);
-//  h_avg_tau23 = sumToLine(mf_out,4,1,domain,zdir);
-    h_avg_tau33 = sumToLine(mf_out,5,1,domain,zdir);
-//  h_avg_hfx3  = sumToLine(mf_out,6,1,domain,zdir);
-//  h_avg_q1fx3 = sumToLine(mf_out,7,1,domain,zdir);
-//  h_avg_q2fx3 = sumToLine(mf_out,8,1,domain,zdir);
-    h_avg_diss  = sumToLine(mf_out,9,1,domain,zdir);
-
-    h_avg_tau13 = sumToLine(mf_out_stag,0,1,stag_domain,zdir);
-    h_avg_tau23 = sumToLine(mf_out_stag,1,1,stag_domain,zdir);
-    h_avg_hfx3  = sumToLine(mf_out_stag,2,1,stag_domain,zdir);
-    h_avg_q1fx3 = sumToLine(mf_out_stag,3,1,stag_domain,zdir);
-    h_avg_q2fx3 = sumToLine(mf_out_stag,4,1,stag_domain,zdir);
-
-    int ht_size =  h_avg_tau11.size(); // _un_staggered
-
-    // Divide by the total number of cells we are averaging over
-    Real area_z = static_cast<Real>(domain.length(0)*domain.length(1));
-    for (int k = 0; k < ht_size; ++k) {
-        h_avg_tau11[k] /= area_z; h_avg_tau12[k] /= area_z;
-        h_avg_tau22[k] /= area_z;
-        h_avg_tau33[k] /= area_z;
-        h_avg_diss[k] /= area_z;
-    }
-    for (int k = 0; k < ht_size+1; ++k) { // staggered heights
-        h_avg_tau13[k] /= area_z;
-        h_avg_tau23[k] /= area_z;
-        h_avg_hfx3[k] /= area_z;
-        h_avg_q1fx3[k] /= area_z; h_avg_q2fx3[k] /= area_z;
-    }
+    // Average all profiles in the horizontal plane with one pass and one reduction
+    // for the cell-centered and one for the staggered quantities
+    Gpu::HostVector<Real> h_avg      = HorizontalAverages(mf_out     , 0, mf_out.nComp()     ,      domain);
+    Gpu::HostVector<Real> h_avg_stag = HorizontalAverages(mf_out_stag, 0, mf_out_stag.nComp(), stag_domain);
+
+    auto profile = [] (const Gpu::HostVector<Real>& h_all, int nz, Gpu::HostVector<Real>& h_prof, int n)
+    {
+        h_prof.resize(nz);
+        std::copy(h_all.begin() +  n   *nz,
+                  h_all.begin() + (n+1)*nz, h_prof.begin());
+    };
+
+    const int ht_size = domain.length(2); // _un_staggered
+
+    // Components 2, 4, 6, 7 and 8 of mf_out are superseded by the staggered ones
+    profile(h_avg     , ht_size  , h_avg_tau11, 0);
+    profile(h_avg     , ht_size  , h_avg_tau12, 1);
+    profile(h_avg     , ht_size  , h_avg_tau22, 3);
+    profile(h_avg     , ht_size  , h_avg_tau33, 5);
+    profile(h_avg     , ht_size  , h_avg_diss , 9);
+
+    profile(h_avg_stag, ht_size+1, h_avg_tau13, 0);
+    profile(h_avg_stag, ht_size+1, h_avg_tau23, 1);
+    profile(h_avg_stag, ht_size+1, h_avg_hfx3 , 2);
+    profile(h_avg_stag, ht_size+1, h_avg_q1fx3, 3);
+    profile(h_avg_stag, ht_size+1, h_avg_q2fx3, 4);
 }
@@ -21,6 +21,9 @@ ERF::sum_integrated_quantities (Real time)
     int datwidth = 14;
     int datprecision = 6;
 
+    // The sums are printed to full precision so that their conservation can be checked
+    int datprecision_sum = 17;
+
     // Single level sum
     Real mass_sl;
 
@@ -107,20 +110,20 @@ ERF::sum_integrated_quantities (Real time)
         Print() << '\n';
         if (finest_level ==  0) {
 #if 1
-           Print() << "TIME= " << time << "     MASS          = " << mass_sl << '\n';
+           Print().SetPrecision(datprecision_sum) << "TIME= " << time << "     MASS          = " << mass_sl << '\n';
 #else
-           Print() << "TIME= " << time << " PERT MASS         = " << mass_sl << '\n';
+           Print().SetPrecision(datprecision_sum) << "TIME= " << time << " PERT MASS         = " << mass_sl << '\n';
 #endif
-           Print() << "TIME= " << time << " RHO THETA         = " << rhth_sl << '\n';
-           Print() << "TIME= " << time << " RHO SCALAR        = " << scal_sl << '\n';
+           Print().SetPrecision(datprecision_sum) << "TIME= " << time << " RHO THETA         = " << rhth_sl << '\n';
+           Print().SetPrecision(datprecision_sum) << "TIME= " << time << " RHO SCALAR        = " << scal_sl << '\n';
         } else {
 #if 1
-           Print() << "TIME= " << time << "      MASS   SL/ML = " << mass_sl << " " << mass_ml << '\n';
+           Print().SetPrecision(datprecision_sum) << "TIME= " << time << "      MASS   SL/ML = " << mass_sl << " " << mass_ml << '\n';
 #else
-           Print() << "TIME= " << time << " PERT MASS   SL/ML = " << mass_sl << " " << mass_ml << '\n';
+           Print().SetPrecision(datprecision_sum) << "TIME= " << time << " PERT MASS   SL/ML = " << mass_sl << " " << mass_ml << '\n';
 #endif
-           Print() << "TIME= " << time << " RHO THETA   SL/ML = " << rhth_sl << " " << rhth_ml << '\n';
-           Print() << "TIME= " << time << " RHO SCALAR  SL/ML = " << scal_sl << " " << scal_ml << '\n';
+           Print().SetPrecision(datprecision_sum) << "TIME= " << time << " RHO THETA   SL/ML = " << rhth_sl << " " << rhth_ml << '\n';
+           Print().SetPrecision(datprecision_sum) << "TIME= " << time << " RHO SCALAR  SL/ML = " << scal_sl << " " << scal_ml << '\n';
         }
 
         // The first data log only holds scalars
@@ -269,7 +272,7 @@ ERF::sample_points (int /*lev*/, Real time, IntVect cell, MultiFab& mf)
           {
               sample_log << std::setw(datwidth) << my_point[i];
           }
-          sample_log << std::endl;
+          sample_log << '\n';
         } // if good
     } // only write from processor that holds the cell
 }
@@ -289,6 +292,9 @@ ERF::sample_lines (int lev, Real time, IntVect cell, MultiFab& mf)
     int datwidth = 14;
     int datprecision = 6;
 
+    // The sums are printed to full precision so that their conservation can be checked
+    int datprecision_sum = 17;
+
     int ifile = 0;
 
     const int ncomp = mf.nComp(); // cell-centered state vars
@@ -360,7 +366,7 @@ ERF::sample_lines (int lev, Real time, IntVect cell, MultiFab& mf)
           for (int k = klo; k <= khi; k++) {
               sample_log << std::setw(datwidth) << std::setprecision(datprecision) << my_line_tau33_arr(i,j,k);
           }
-          sample_log << std::endl;
+          sample_log << '\n';
         } // if good
     } // mfi
 }
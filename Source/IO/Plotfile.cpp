@@ -14,6 +14,78 @@ bool containerHasElement (const V& iterable, const T& query) {
     return std::find(iterable.begin(), iterable.end(), query) != iterable.end();
 }
 
+/**
+ * Cell-centered x-derivative of a cell-centered field in terrain-following
+ * coordinates, computed as the average of the gradients on the two x-faces
+ */
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+Real
+gradp_x_terrain (int i, int j, int k, int klo, int khi,
+                 const GpuArray<Real,AMREX_SPACEDIM>& dxInv,
+                 const Array4<Real const>& z_nd,
+                 const Array4<Real const>& p_arr)
+{
+    Real gpx[2];
+    for (int n = 0; n < 2; ++n) {
+        int ii = i + n; // face between cells ii-1 and ii
+        Real met_h_xi   = Compute_h_xi_AtIface  (ii, j, k, dxInv, z_nd);
+        Real met_h_zeta = Compute_h_zeta_AtIface(ii, j, k, dxInv, z_nd);
+        Real gp_xi = dxInv[0] * (p_arr(ii,j,k) - p_arr(ii-1,j,k));
+        Real gp_zeta_on_iface;
+        if (k == klo) {
+            gp_zeta_on_iface = 0.5 * dxInv[2] * (
+                p_arr(ii-1,j,k+1) + p_arr(ii,j,k+1)
+              - p_arr(ii-1,j,k  ) - p_arr(ii,j,k  ) );
+        } else if (k == khi) {
+            gp_zeta_on_iface = 0.5 * dxInv[2] * (
+                p_arr(ii-1,j,k  ) + p_arr(ii,j,k  )
+              - p_arr(ii-1,j,k-1) - p_arr(ii,j,k-1) );
+        } else {
+            gp_zeta_on_iface = 0.25 * dxInv[2] * (
+                p_arr(ii-1,j,k+1) + p_arr(ii,j,k+1)
+              - p_arr(ii-1,j,k-1) - p_arr(ii,j,k-1) );
+        }
+        gpx[n] = gp_xi - (met_h_xi / met_h_zeta) * gp_zeta_on_iface;
+    }
+    return 0.5 * (gpx[0] + gpx[1]);
+}
+
+/**
+ * Cell-centered y-derivative of a cell-centered field in terrain-following
+ * coordinates, computed as the average of the gradients on the two y-faces
+ */
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+Real
+gradp_y_terrain (int i, int j, int k, int klo, int khi,
+                 const GpuArray<Real,AMREX_SPACEDIM>& dxInv,
+                 const Array4<Real const>& z_nd,
+                 const Array4<Real const>& p_arr)
+{
+    Real gpy[2];
+    for (int n = 0; n < 2; ++n) {
+        int jj = j + n; // face between cells jj-1 and jj
+        Real met_h_eta  = Compute_h_eta_AtJface (i, jj, k, dxInv, z_nd);
+        Real met_h_zeta = Compute_h_zeta_AtJface(i, jj, k, dxInv, z_nd);
+        Real gp_eta = dxInv[1] * (p_arr(i,jj,k) - p_arr(i,jj-1,k));
+        Real gp_zeta_on_jface;
+        if (k == klo) {
+            gp_zeta_on_jface = 0.5 * dxInv[2] * (
+                p_arr(i,jj,k+1) + p_arr(i,jj-1,k+1)
+              - p_arr(i,jj,k  ) - p_arr(i,jj-1,k  ) );
+        } else if (k == khi) {
+            gp_zeta_on_jface = 0.5 * dxInv[2] * (
+                p_arr(i,jj,k  ) + p_arr(i,jj-1,k  )
+              - p_arr(i,jj,k-1) - p_arr(i,jj-1,k-1) );
+        } else {
+            gp_zeta_on_jface = 0.25 * dxInv[2] * (
+                p_arr(i,jj,k+1) + p_arr(i,jj-1,k+1)
+              - p_arr(i,jj,k-1) - p_arr(i,jj-1,k-1) );
+        }
+        gpy[n] = gp_eta - (met_h_eta / met_h_zeta) * gp_zeta_on_jface;
+    }
+    return 0.5 * (gpy[0] + gpy[1]);
+}
+
 void
 ERF::setPlotVariables (const std::string& pp_plot_var_names, Vector<std::string>& plot_var_names)
 {
@@ -91,6 +163,12 @@ ERF::setPlotVariables (const std::string& pp_plot_var_names, Vector<std::string>
         } // hasElement
     }
 
+    for (const auto& stats_name : field_stats.plot_names()) {
+        if ( containerHasElement(plot_var_names, stats_name) ) {
+            tmp_plot_names.push_back(stats_name);
+        }
+    }
+
 #ifdef ERF_USE_PARTICLES
     const auto& particles_namelist( particleData.getNamesUnalloc() );
     for (auto it = particles_namelist.cbegin(); it != particles_namelist.cend(); ++it) {
@@ -161,21 +239,21 @@ ERF::PlotFileVarNames (Vector<std::string> plot_var_names )
 
 }
 
-// Write plotfile to disk
+// Compute the requested plot variables at levels 0 through lev_max
 void
-ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
+ERF::ComputePlotData (const Vector<std::string>& plot_var_names, Vector<MultiFab>& mf, int lev_max)
 {
-    const Vector<std::string> varnames = PlotFileVarNames(plot_var_names);
-    const int ncomp_mf = varnames.size();
+    const int ncomp_mf = plot_var_names.size();
 
     int ncomp_cons = vars_new[0][Vars::cons].nComp();
 
-    if (ncomp_mf == 0) return;
+    // Which shared intermediate fields do the requested variables depend on?
+    const int der_inputs = derived::derived_inputs(plot_var_names);
 
     // We Fillpatch here because some of the derived quantities require derivatives
     //     which require ghost cells to be filled.  We do not need to call FillPatcher
     //     because we don't need to set interior fine points.
-    for (int lev = 0; lev <= finest_level; ++lev) {
+    for (int lev = 0; lev <= lev_max; ++lev) {
         bool fillset = false;
         FillPatch(lev, t_new[lev], {&vars_new[lev][Vars::cons], &vars_new[lev][Vars::xvel],
                                     &vars_new[lev][Vars::yvel], &vars_new[lev][Vars::zvel]},
@@ -186,39 +264,24 @@ ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
     // Get qmoist pointers if using moisture
     bool use_moisture = (solverChoice.moisture_type != MoistureType::None);
     for (int lev = 0; lev <= finest_level; ++lev) {
+        update_micro_diagnostics(lev, vars_new[lev][Vars::cons]);
         for (int mvar(0); mvar<qmoist[lev].size(); ++mvar) {
             qmoist[lev][mvar] = micro->Get_Qmoist_Ptr(lev,mvar);
         }
     }
 
-    // Vector of MultiFabs for cell-centered data
-    Vector<MultiFab> mf(finest_level+1);
-    for (int lev = 0; lev <= finest_level; ++lev) {
+    // MultiFabs for cell-centered data
+    AMREX_ALWAYS_ASSERT(mf.size() > lev_max);
+    for (int lev = 0; lev <= lev_max; ++lev) {
         mf[lev].define(grids[lev], dmap[lev], ncomp_mf, 0);
     }
 
-    // Vector of MultiFabs for nodal data
-    Vector<MultiFab> mf_nd(finest_level+1);
-    if (solverChoice.use_terrain) {
-        for (int lev = 0; lev <= finest_level; ++lev) {
-            BoxArray nodal_grids(grids[lev]); nodal_grids.surroundingNodes();
-            mf_nd[lev].define(nodal_grids, dmap[lev], 3, 0);
-            mf_nd[lev].setVal(0.);
-        }
-    }
-
     // Array of MultiFabs for cell-centered velocity
-    Vector<MultiFab> mf_cc_vel(finest_level+1);
+    Vector<MultiFab> mf_cc_vel(lev_max+1);
 
-    if (containerHasElement(plot_var_names, "x_velocity" ) ||
-        containerHasElement(plot_var_names, "y_velocity" ) ||
-        containerHasElement(plot_var_names, "z_velocity" ) ||
-        containerHasElement(plot_var_names, "magvel"     ) ||
-        containerHasElement(plot_var_names, "vorticity_x") ||
-        containerHasElement(plot_var_names, "vorticity_y") ||
-        containerHasElement(plot_var_names, "vorticity_z") ) {
+    if (der_inputs & derived::DerInput::CCVel) {
 
-        for (int lev = 0; lev <= finest_level; ++lev) {
+        for (int lev = 0; lev <= lev_max; ++lev) {
             mf_cc_vel[lev].define(grids[lev], dmap[lev], AMREX_SPACEDIM, IntVect(1,1,1));
             average_face_to_cellcenter(mf_cc_vel[lev],0,
                                        Array<const MultiFab*,3>{&vars_new[lev][Vars::xvel],
@@ -228,12 +291,10 @@ ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
     } // if (vel or vort)
 
     // We need ghost cells if computing vorticity
-    if ( containerHasElement(plot_var_names, "vorticity_x")||
-         containerHasElement(plot_var_names, "vorticity_y") ||
-         containerHasElement(plot_var_names, "vorticity_z") )
+    if (der_inputs & derived::DerInput::CCVelGhost)
     {
         amrex::Interpolater* mapper = &cell_cons_interp;
-        for (int lev = 1; lev <= finest_level; ++lev)
+        for (int lev = 1; lev <= lev_max; ++lev)
         {
             Vector<MultiFab*> fmf = {&(mf_cc_vel[lev]), &(mf_cc_vel[lev])};
             Vector<Real> ftime    = {t_new[lev], t_new[lev]};
@@ -250,7 +311,7 @@ ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
         FillBdyCCVels(mf_cc_vel);
     } // if (vort)
 
-    for (int lev = 0; lev <= finest_level; ++lev)
+    for (int lev = 0; lev <= lev_max; ++lev)
     {
         int mf_comp = 0;
 
@@ -344,400 +405,130 @@ ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
             mf_comp += 1;
         }
 
-        if (containerHasElement(plot_var_names, "pressure"))
-        {
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.tilebox();
-                const Array4<Real      >& derdat = mf[lev].array(mfi);
-                const Array4<Real const>&  S_arr = vars_new[lev][Vars::cons].const_array(mfi);
-                const int ncomp = vars_new[lev][Vars::cons].nComp();
-
-                ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                {
-                    Real qv_for_p = (use_moisture && (ncomp > RhoQ1_comp)) ? S_arr(i,j,k,RhoQ1_comp)/S_arr(i,j,k,Rho_comp) : 0;
-                    const Real rhotheta = S_arr(i,j,k,RhoTheta_comp);
-                    derdat(i, j, k, mf_comp) = getPgivenRTh(rhotheta,qv_for_p);
-                });
+        // The thermodynamic quantities flagged as "fused" in the derived table are
+        // evaluated together in a single pass over each tile, sharing one pressure field
+        int n_fused = 0;
+        for (int i = 0; i < plot_var_names.size(); ++i) {
+            if (derived::is_fused_derived(plot_var_names[i])) {
+                // The fused variables must occupy contiguous components starting at mf_comp
+                AMREX_ALWAYS_ASSERT(i == mf_comp + n_fused);
+                n_fused++;
             }
-            mf_comp += 1;
         }
-        if (containerHasElement(plot_var_names, "pert_pres"))
-        {
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.tilebox();
-                const Array4<Real>& derdat = mf[lev].array(mfi);
-                const Array4<Real const>& p0_arr = p_hse.const_array(mfi);
-                const Array4<Real const>& S_arr = vars_new[lev][Vars::cons].const_array(mfi);
-                const int ncomp = vars_new[lev][Vars::cons].nComp();
 
-                ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                {
-                    Real qv_for_p = (use_moisture && (ncomp > RhoQ1_comp)) ? S_arr(i,j,k,RhoQ1_comp)/S_arr(i,j,k,Rho_comp) : 0;
-                    const Real rhotheta = S_arr(i,j,k,RhoTheta_comp);
-                    derdat(i, j, k, mf_comp) = getPgivenRTh(rhotheta,qv_for_p) - p0_arr(i,j,k);
-                });
-            }
-            mf_comp += 1;
-        }
-        if (containerHasElement(plot_var_names, "pert_dens"))
-        {
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.tilebox();
-                const Array4<Real>& derdat  = mf[lev].array(mfi);
-                const Array4<Real const>& S_arr = vars_new[lev][Vars::cons].const_array(mfi);
-                const Array4<Real const>& r0_arr = r_hse.const_array(mfi);
-                ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                    derdat(i, j, k, mf_comp) = S_arr(i,j,k,Rho_comp) - r0_arr(i,j,k);
-                });
-            }
-            mf_comp ++;
-        }
-
-        if (containerHasElement(plot_var_names, "eq_pot_temp"))
-        {
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.tilebox();
-                const Array4<Real>& derdat  = mf[lev].array(mfi);
-                const Array4<Real const>& S_arr = vars_new[lev][Vars::cons].const_array(mfi);
-                const int ncomp = vars_new[lev][Vars::cons].nComp();
-                ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                    Real qv = (use_moisture && (ncomp > RhoQ1_comp)) ? S_arr(i,j,k,RhoQ1_comp)/S_arr(i,j,k,Rho_comp) : 0.0;
-                    Real qc = (use_moisture && (ncomp > RhoQ2_comp)) ? S_arr(i,j,k,RhoQ2_comp)/S_arr(i,j,k,Rho_comp) : 0.0;
-                    Real T = getTgivenRandRTh(S_arr(i,j,k,Rho_comp), S_arr(i,j,k,RhoTheta_comp), qv);
-                    Real pressure = getPgivenRTh(S_arr(i,j,k,RhoTheta_comp), qv);
-                    Real fac = Cp_d + Cp_l*(qv + qc);
-                    Real pv = erf_esatw(T)*100.0;
-
-                    derdat(i, j, k, mf_comp) = T*std::pow((pressure - pv)/p_0, -R_d/fac)*std::exp(L_v*qv/(fac*T)) ;
-                });
-            }
-            mf_comp ++;
-        }
-
-#ifdef ERF_USE_WINDFARM
-        if (containerHasElement(plot_var_names, "num_turb"))
-        {
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.tilebox();
-                const Array4<Real>& derdat  = mf[lev].array(mfi);
-                const Array4<Real const>& Nturb_array = Nturb[lev].const_array(mfi);
-                ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                    derdat(i, j, k, mf_comp) = Nturb_array(i,j,k,0);
-                });
-            }
-            mf_comp ++;
-        }
-#endif
-
-        int klo = geom[lev].Domain().smallEnd(2);
-        int khi = geom[lev].Domain().bigEnd(2);
-
-        if (containerHasElement(plot_var_names, "dpdx"))
+        if (n_fused > 0)
         {
+            auto plot_comp = [&](const std::string& name) -> int {
+                auto it = std::find(plot_var_names.begin(), plot_var_names.end(), name);
+                return (it == plot_var_names.end()) ? -1 : static_cast<int>(it - plot_var_names.begin());
+            };
+            const int ic_pres      = plot_comp("pressure");
+            const int ic_pert_pres = plot_comp("pert_pres");
+            const int ic_pert_dens = plot_comp("pert_dens");
+            const int ic_eq_pot    = plot_comp("eq_pot_temp");
+            const int ic_dpdx      = plot_comp("dpdx");
+            const int ic_dpdy      = plot_comp("dpdy");
+            const int ic_phse_x    = plot_comp("pres_hse_x");
+            const int ic_phse_y    = plot_comp("pres_hse_y");
+            const int ic_qsat      = plot_comp("qsat");
+
+            const bool l_use_terrain = solverChoice.use_terrain;
+            const int  ncomp = vars_new[lev][Vars::cons].nComp();
+            const int  klo   = geom[lev].Domain().smallEnd(2);
+            const int  khi   = geom[lev].Domain().bigEnd(2);
             auto dxInv = geom[lev].InvCellSizeArray();
-            MultiFab pres(vars_new[lev][Vars::cons].boxArray(), vars_new[lev][Vars::cons].DistributionMap(), 1, 1);
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                // First define pressure on grown box
-                const Box& gbx = mfi.growntilebox(1);
-                const Array4<Real> & p_arr  = pres.array(mfi);
-                const Array4<Real const>& S_arr = vars_new[lev][Vars::cons].const_array(mfi);
-                ParallelFor(gbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
-                    p_arr(i,j,k) = getPgivenRTh(S_arr(i,j,k,RhoTheta_comp));
-                });
-            }
-            pres.FillBoundary(geom[lev].periodicity());
 
+            // Pressure is computed once per level; the gradients need one ghost cell
+            MultiFab pres;
+            if (der_inputs & derived::DerInput::Pressure) {
+                int ng_pres = (der_inputs & derived::DerInput::PressureGhost) ? 1 : 0;
+                pres.define(grids[lev], dmap[lev], 1, ng_pres);
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-            for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                // Now compute pressure gradient on valid box
-                const Box& bx = mfi.tilebox();
-                const Array4<Real>& derdat = mf[lev].array(mfi);
-                const Array4<Real> & p_arr  = pres.array(mfi);
-
-                if (solverChoice.use_terrain) {
-                    const Array4<Real const>& z_nd = z_phys_nd[lev]->const_array(mfi);
-
-                    ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-
-                        // Pgrad at lower I face
-                        Real met_h_xi_lo   = Compute_h_xi_AtIface  (i, j, k, dxInv, z_nd);
-                        Real met_h_zeta_lo = Compute_h_zeta_AtIface(i, j, k, dxInv, z_nd);
-                        Real gp_xi_lo = dxInv[0] * (p_arr(i,j,k) - p_arr(i-1,j,k));
-                        Real gp_zeta_on_iface_lo;
-                        if(k == klo) {
-                            gp_zeta_on_iface_lo = 0.5 * dxInv[2] * (
-                                p_arr(i-1,j,k+1) + p_arr(i,j,k+1)
-                              - p_arr(i-1,j,k  ) - p_arr(i,j,k  ) );
-                        } else if (k == khi) {
-                            gp_zeta_on_iface_lo = 0.5 * dxInv[2] * (
-                                p_arr(i-1,j,k  ) + p_arr(i,j,k  )
-                              - p_arr(i-1,j,k-1) - p_arr(i,j,k-1) );
-                        } else {
-                            gp_zeta_on_iface_lo = 0.25 * dxInv[2] * (
-                                p_arr(i-1,j,k+1) + p_arr(i,j,k+1)
-                              - p_arr(i-1,j,k-1) - p_arr(i,j,k-1) );
-                        }
-                        Real gpx_lo = gp_xi_lo - (met_h_xi_lo/ met_h_zeta_lo) * gp_zeta_on_iface_lo;
-
-                        // Pgrad at higher I face
-                        Real met_h_xi_hi   = Compute_h_xi_AtIface  (i+1, j, k, dxInv, z_nd);
-                        Real met_h_zeta_hi = Compute_h_zeta_AtIface(i+1, j, k, dxInv, z_nd);
-                        Real gp_xi_hi = dxInv[0] * (p_arr(i+1,j,k) - p_arr(i,j,k));
-                        Real gp_zeta_on_iface_hi;
-                        if(k == klo) {
-                            gp_zeta_on_iface_hi = 0.5 * dxInv[2] * (
-                                p_arr(i+1,j,k+1) + p_arr(i,j,k+1)
-                                - p_arr(i+1,j,k  ) - p_arr(i,j,k  ) );
-                        } else if (k == khi) {
-                            gp_zeta_on_iface_hi = 0.5 * dxInv[2] * (
-                                p_arr(i+1,j,k  ) + p_arr(i,j,k  )
-                                - p_arr(i+1,j,k-1) - p_arr(i,j,k-1) );
-                        } else {
-                            gp_zeta_on_iface_hi = 0.25 * dxInv[2] * (
-                                p_arr(i+1,j,k+1) + p_arr(i,j,k+1)
-                                - p_arr(i+1,j,k-1) - p_arr(i,j,k-1) );
-                        }
-                        Real gpx_hi = gp_xi_hi - (met_h_xi_hi/ met_h_zeta_hi) * gp_zeta_on_iface_hi;
-
-                        // Average P grad to CC
-                        derdat(i ,j ,k, mf_comp) = 0.5 * (gpx_lo + gpx_hi);
-                    });
-                } else {
-                    ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                        derdat(i ,j ,k, mf_comp) = 0.5 * (p_arr(i+1,j,k) - p_arr(i-1,j,k)) * dxInv[0];
+                for ( MFIter mfi(pres,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+                {
+                    const Box& gbx = mfi.growntilebox();
+                    const Array4<Real      >& p_arr = pres.array(mfi);
+                    const Array4<Real const>& S_arr = vars_new[lev][Vars::cons].const_array(mfi);
+                    ParallelFor(gbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
+                    {
+                        Real qv_for_p = (use_moisture && (ncomp > RhoQ1_comp)) ? S_arr(i,j,k,RhoQ1_comp)/S_arr(i,j,k,Rho_comp) : 0;
+                        p_arr(i,j,k) = getPgivenRTh(S_arr(i,j,k,RhoTheta_comp),qv_for_p);
                     });
                 }
-            } // mfi
-            mf_comp ++;
-        } // dpdx
-
-        if (containerHasElement(plot_var_names, "dpdy"))
-        {
-            auto dxInv = geom[lev].InvCellSizeArray();
-
-            MultiFab pres(vars_new[lev][Vars::cons].boxArray(), vars_new[lev][Vars::cons].DistributionMap(), 1, 1);
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                // First define pressure on grown box
-                const Box& gbx = mfi.growntilebox(1);
-                const Array4<Real> & p_arr  = pres.array(mfi);
-                const Array4<Real const>& S_arr = vars_new[lev][Vars::cons].const_array(mfi);
-                ParallelFor(gbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
-                    p_arr(i,j,k) = getPgivenRTh(S_arr(i,j,k,RhoTheta_comp));
-                });
+                if (ng_pres > 0) pres.FillBoundary(geom[lev].periodicity());
             }
-            pres.FillBoundary(geom[lev].periodicity());
 
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
             for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
             {
-                // Now compute pressure gradient on valid box
                 const Box& bx = mfi.tilebox();
-                const Array4<Real>& derdat = mf[lev].array(mfi);
-                const Array4<Real> & p_arr  = pres.array(mfi);
-
-                if (solverChoice.use_terrain) {
-                    const Array4<Real const>& z_nd = z_phys_nd[lev]->const_array(mfi);
-
-                    ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+                const Array4<Real      >& derdat = mf[lev].array(mfi);
+                const Array4<Real const>&  S_arr = vars_new[lev][Vars::cons].const_array(mfi);
+                const Array4<Real const>& p0_arr = p_hse.const_array(mfi);
+                const Array4<Real const>& r0_arr = r_hse.const_array(mfi);
+                const Array4<Real const>   p_arr = (pres.ok()) ? pres.const_array(mfi) : Array4<Real const>{};
+                const Array4<Real const>    z_nd = (l_use_terrain) ? z_phys_nd[lev]->const_array(mfi) : Array4<Real const>{};
 
-                        Real met_h_eta_lo  = Compute_h_eta_AtJface (i, j, k, dxInv, z_nd);
-                        Real met_h_zeta_lo = Compute_h_zeta_AtJface(i, j, k, dxInv, z_nd);
-                        Real gp_eta_lo = dxInv[1] * (p_arr(i,j,k) - p_arr(i,j-1,k));
-                        Real gp_zeta_on_jface_lo;
-                        if (k == klo) {
-                            gp_zeta_on_jface_lo = 0.5 * dxInv[2] * (
-                                p_arr(i,j,k+1) + p_arr(i,j-1,k+1)
-                                - p_arr(i,j,k  ) - p_arr(i,j-1,k  ) );
-                        } else if (k == khi) {
-                            gp_zeta_on_jface_lo = 0.5 * dxInv[2] * (
-                                p_arr(i,j,k  ) + p_arr(i,j-1,k  )
-                                - p_arr(i,j,k-1) - p_arr(i,j-1,k-1) );
-                        } else {
-                            gp_zeta_on_jface_lo = 0.25 * dxInv[2] * (
-                                p_arr(i,j,k+1) + p_arr(i,j-1,k+1)
-                                - p_arr(i,j,k-1) - p_arr(i,j-1,k-1) );
+                ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
+                {
+                    const Real rho = S_arr(i,j,k,Rho_comp);
+
+                    if (ic_pres      >= 0) derdat(i,j,k,ic_pres)      = p_arr(i,j,k);
+                    if (ic_pert_pres >= 0) derdat(i,j,k,ic_pert_pres) = p_arr(i,j,k) - p0_arr(i,j,k);
+                    if (ic_pert_dens >= 0) derdat(i,j,k,ic_pert_dens) = rho - r0_arr(i,j,k);
+
+                    if (ic_eq_pot >= 0 || ic_qsat >= 0) {
+                        Real qv = (use_moisture && (ncomp > RhoQ1_comp)) ? S_arr(i,j,k,RhoQ1_comp)/rho : 0.0;
+                        Real qc = (use_moisture && (ncomp > RhoQ2_comp)) ? S_arr(i,j,k,RhoQ2_comp)/rho : 0.0;
+                        Real T  = getTgivenRandRTh(rho, S_arr(i,j,k,RhoTheta_comp), qv);
+                        if (ic_eq_pot >= 0) {
+                            Real fac = Cp_d + Cp_l*(qv + qc);
+                            Real pv  = erf_esatw(T)*100.0;
+                            derdat(i,j,k,ic_eq_pot) = T*std::pow((p_arr(i,j,k) - pv)/p_0, -R_d/fac)*std::exp(L_v*qv/(fac*T));
                         }
-                        Real gpy_lo = gp_eta_lo - (met_h_eta_lo / met_h_zeta_lo) * gp_zeta_on_jface_lo;
-
-                        Real met_h_eta_hi  = Compute_h_eta_AtJface (i, j+1, k, dxInv, z_nd);
-                        Real met_h_zeta_hi = Compute_h_zeta_AtJface(i, j+1, k, dxInv, z_nd);
-                        Real gp_eta_hi = dxInv[1] * (p_arr(i,j+1,k) - p_arr(i,j,k));
-                        Real gp_zeta_on_jface_hi;
-                        if (k == klo) {
-                            gp_zeta_on_jface_hi = 0.5 * dxInv[2] * (
-                                p_arr(i,j+1,k+1) + p_arr(i,j,k+1)
-                                - p_arr(i,j+1,k  ) - p_arr(i,j,k  ) );
-                        } else if (k == khi) {
-                            gp_zeta_on_jface_hi = 0.5 * dxInv[2] * (
-                                p_arr(i,j+1,k  ) + p_arr(i,j,k  )
-                                - p_arr(i,j+1,k-1) - p_arr(i,j,k-1) );
-                        } else {
-                            gp_zeta_on_jface_hi = 0.25 * dxInv[2] * (
-                                p_arr(i,j+1,k+1) + p_arr(i,j,k+1)
-                                - p_arr(i,j+1,k-1) - p_arr(i,j,k-1) );
+                        if (ic_qsat >= 0) {
+                            erf_qsatw(T, p_arr(i,j,k)*Real(0.01), derdat(i,j,k,ic_qsat));
                         }
-                        Real gpy_hi = gp_eta_hi - (met_h_eta_hi / met_h_zeta_hi) * gp_zeta_on_jface_hi;
-
-                        derdat(i ,j ,k, mf_comp) = 0.5 * (gpy_lo + gpy_hi);
-                    });
-                } else {
-                    ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                        derdat(i ,j ,k, mf_comp) = 0.5 * (p_arr(i,j+1,k) - p_arr(i,j-1,k)) * dxInv[1];
-                    });
-                }
-            } // mf
-            mf_comp ++;
-        } // dpdy
-
-        if (containerHasElement(plot_var_names, "pres_hse_x"))
-        {
-            auto dxInv = geom[lev].InvCellSizeArray();
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.tilebox();
-                const Array4<Real      >&  derdat = mf[lev].array(mfi);
-                const Array4<Real const>&   p_arr = p_hse.const_array(mfi);
-
-                //USE_TERRAIN POSSIBLE ISSUE HERE
-                const Array4<Real const>& z_nd  = z_phys_nd[lev]->const_array(mfi);
-
-                ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                    Real met_h_xi_lo   = Compute_h_xi_AtIface  (i, j, k, dxInv, z_nd);
-                    Real met_h_zeta_lo = Compute_h_zeta_AtIface(i, j, k, dxInv, z_nd);
-                    Real gp_xi_lo = dxInv[0] * (p_arr(i,j,k) - p_arr(i-1,j,k));
-                    Real gp_zeta_on_iface_lo;
-                    if (k == klo) {
-                      gp_zeta_on_iface_lo = 0.5 * dxInv[2] * (
-                                                              p_arr(i-1,j,k+1) + p_arr(i,j,k+1)
-                                                            - p_arr(i-1,j,k  ) - p_arr(i,j,k  ) );
-                    } else if (k == khi) {
-                      gp_zeta_on_iface_lo = 0.5 * dxInv[2] * (
-                                                              p_arr(i-1,j,k  ) + p_arr(i,j,k  )
-                                                            - p_arr(i-1,j,k-1) - p_arr(i,j,k-1) );
-                    } else {
-                      gp_zeta_on_iface_lo = 0.25 * dxInv[2] * (
-                                                               p_arr(i-1,j,k+1) + p_arr(i,j,k+1)
-                                                             - p_arr(i-1,j,k-1) - p_arr(i,j,k-1) );
                     }
-                    Real gpx_lo = gp_xi_lo - (met_h_xi_lo/ met_h_zeta_lo) * gp_zeta_on_iface_lo;
-
-                    Real met_h_xi_hi   = Compute_h_xi_AtIface  (i+1, j, k, dxInv, z_nd);
-                    Real met_h_zeta_hi = Compute_h_zeta_AtIface(i+1, j, k, dxInv, z_nd);
-                    Real gp_xi_hi = dxInv[0] * (p_arr(i+1,j,k) - p_arr(i,j,k));
-                    Real gp_zeta_on_iface_hi;
-                    if (k == klo) {
-                      gp_zeta_on_iface_hi = 0.5 * dxInv[2] * (
-                                                              p_arr(i+1,j,k+1) + p_arr(i,j,k+1)
-                                                            - p_arr(i+1,j,k  ) - p_arr(i,j,k  ) );
-                    } else if (k == khi) {
-                      gp_zeta_on_iface_hi = 0.5 * dxInv[2] * (
-                                                              p_arr(i+1,j,k  ) + p_arr(i,j,k  )
-                                                            - p_arr(i+1,j,k-1) - p_arr(i,j,k-1) );
+
+                    if (l_use_terrain) {
+                        if (ic_dpdx   >= 0) derdat(i,j,k,ic_dpdx)   = gradp_x_terrain(i,j,k,klo,khi,dxInv,z_nd, p_arr);
+                        if (ic_dpdy   >= 0) derdat(i,j,k,ic_dpdy)   = gradp_y_terrain(i,j,k,klo,khi,dxInv,z_nd, p_arr);
+                        if (ic_phse_x >= 0) derdat(i,j,k,ic_phse_x) = gradp_x_terrain(i,j,k,klo,khi,dxInv,z_nd,p0_arr);
+                        if (ic_phse_y >= 0) derdat(i,j,k,ic_phse_y) = gradp_y_terrain(i,j,k,klo,khi,dxInv,z_nd,p0_arr);
                     } else {
-                      gp_zeta_on_iface_hi = 0.25 * dxInv[2] * (
-                                                               p_arr(i+1,j,k+1) + p_arr(i,j,k+1)
-                                                             - p_arr(i+1,j,k-1) - p_arr(i,j,k-1) );
+                        if (ic_dpdx   >= 0) derdat(i,j,k,ic_dpdx)   = 0.5 * ( p_arr(i+1,j,k) -  p_arr(i-1,j,k)) * dxInv[0];
+                        if (ic_dpdy   >= 0) derdat(i,j,k,ic_dpdy)   = 0.5 * ( p_arr(i,j+1,k) -  p_arr(i,j-1,k)) * dxInv[1];
+                        if (ic_phse_x >= 0) derdat(i,j,k,ic_phse_x) = 0.5 * (p0_arr(i+1,j,k) - p0_arr(i-1,j,k)) * dxInv[0];
+                        if (ic_phse_y >= 0) derdat(i,j,k,ic_phse_y) = 0.5 * (p0_arr(i,j+1,k) - p0_arr(i,j-1,k)) * dxInv[1];
                     }
-                    Real gpx_hi = gp_xi_hi - (met_h_xi_hi/ met_h_zeta_hi) * gp_zeta_on_iface_hi;
-
-                    derdat(i ,j ,k, mf_comp) = 0.5 * (gpx_lo + gpx_hi);
                 });
-            }
-            mf_comp += 1;
-        } // pres_hse_x
+            } // mfi
+            mf_comp += n_fused;
+        } // n_fused
 
-        if (containerHasElement(plot_var_names, "pres_hse_y"))
+#ifdef ERF_USE_WINDFARM
+        if (containerHasElement(plot_var_names, "num_turb"))
         {
-            auto dxInv = geom[lev].InvCellSizeArray();
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
             for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
             {
                 const Box& bx = mfi.tilebox();
-                const Array4<Real      >& derdat = mf[lev].array(mfi);
-                const Array4<Real const>&   p_arr = p_hse.const_array(mfi);
-                const Array4<Real const>& z_nd    = z_phys_nd[lev]->const_array(mfi);
+                const Array4<Real>& derdat  = mf[lev].array(mfi);
+                const Array4<Real const>& Nturb_array = Nturb[lev].const_array(mfi);
                 ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                    Real met_h_eta_lo  = Compute_h_eta_AtJface (i, j, k, dxInv, z_nd);
-                    Real met_h_zeta_lo = Compute_h_zeta_AtJface(i, j, k, dxInv, z_nd);
-                    Real gp_eta_lo = dxInv[1] * (p_arr(i,j,k) - p_arr(i,j-1,k));
-                    Real gp_zeta_on_jface_lo;
-                    if (k == klo) {
-                      gp_zeta_on_jface_lo = 0.5 * dxInv[2] * (
-                                                              p_arr(i,j,k+1) + p_arr(i,j-1,k+1)
-                                                            - p_arr(i,j,k  ) - p_arr(i,j-1,k  ) );
-                    } else if (k == khi) {
-                      gp_zeta_on_jface_lo = 0.5 * dxInv[2] * (
-                                                              p_arr(i,j,k  ) + p_arr(i,j-1,k  )
-                                                            - p_arr(i,j,k-1) - p_arr(i,j-1,k-1) );
-                    } else {
-                      gp_zeta_on_jface_lo = 0.25 * dxInv[2] * (
-                                                               p_arr(i,j,k+1) + p_arr(i,j-1,k+1)
-                                                             - p_arr(i,j,k-1) - p_arr(i,j-1,k-1) );
-                    }
-                    Real gpy_lo = gp_eta_lo - (met_h_eta_lo / met_h_zeta_lo) * gp_zeta_on_jface_lo;
-
-                    Real met_h_eta_hi  = Compute_h_eta_AtJface (i, j+1, k, dxInv, z_nd);
-                    Real met_h_zeta_hi = Compute_h_zeta_AtJface(i, j+1, k, dxInv, z_nd);
-                    Real gp_eta_hi = dxInv[1] * (p_arr(i,j+1,k) - p_arr(i,j,k));
-                    Real gp_zeta_on_jface_hi;
-                    if (k == klo) {
-                      gp_zeta_on_jface_hi = 0.5 * dxInv[2] * (
-                                                              p_arr(i,j+1,k+1) + p_arr(i,j,k+1)
-                                                            - p_arr(i,j+1,k  ) - p_arr(i,j,k  ) );
-                    } else if (k == khi) {
-                      gp_zeta_on_jface_hi = 0.5 * dxInv[2] * (
-                                                              p_arr(i,j+1,k  ) + p_arr(i,j,k  )
-                                                            - p_arr(i,j+1,k-1) - p_arr(i,j,k-1) );
-                    } else {
-                      gp_zeta_on_jface_hi = 0.25 * dxInv[2] * (
-                                                               p_arr(i,j+1,k+1) + p_arr(i,j,k+1)
-                                                             - p_arr(i,j+1,k-1) - p_arr(i,j,k-1) );
-                    }
-                    Real gpy_hi = gp_eta_hi - (met_h_eta_hi / met_h_zeta_hi) * gp_zeta_on_jface_hi;
-
-                    derdat(i ,j ,k, mf_comp) = 0.5 * (gpy_lo + gpy_hi);
+                    derdat(i, j, k, mf_comp) = Nturb_array(i,j,k,0);
                 });
             }
-            mf_comp += 1;
-        } // pres_hse_y
+            mf_comp ++;
+        }
+#endif
 
         if (solverChoice.use_terrain) {
             if (containerHasElement(plot_var_names, "z_phys"))
@@ -805,76 +596,22 @@ ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
 #endif
 
 
+        // Time averaged velocities are the means accumulated by the running statistics
         if (solverChoice.time_avg_vel) {
             if (containerHasElement(plot_var_names, "u_t_avg")) {
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-                for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-                {
-                    const Box& bx = mfi.tilebox();
-                    const Array4<Real>& derdat = mf[lev].array(mfi);
-                    const Array4<Real>& data   = vel_t_avg[lev]->array(mfi);
-                    const Real norm = t_avg_cnt[lev];
-                    ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                    {
-                        derdat(i ,j ,k, mf_comp) = data(i,j,k,0) / norm;
-                    });
-                }
+                field_stats.get_mean(lev, "x_velocity", mf[lev], mf_comp);
                 mf_comp ++;
             }
-
             if (containerHasElement(plot_var_names, "v_t_avg")) {
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-                for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-                {
-                    const Box& bx = mfi.tilebox();
-                    const Array4<Real>& derdat = mf[lev].array(mfi);
-                    const Array4<Real>& data   = vel_t_avg[lev]->array(mfi);
-                    const Real norm = t_avg_cnt[lev];
-                    ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                    {
-                        derdat(i ,j ,k, mf_comp) = data(i,j,k,1) / norm;
-                    });
-                }
+                field_stats.get_mean(lev, "y_velocity", mf[lev], mf_comp);
                 mf_comp ++;
             }
-
             if (containerHasElement(plot_var_names, "w_t_avg")) {
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-                for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-                {
-                    const Box& bx = mfi.tilebox();
-                    const Array4<Real>& derdat = mf[lev].array(mfi);
-                    const Array4<Real>& data   = vel_t_avg[lev]->array(mfi);
-                    const Real norm = t_avg_cnt[lev];
-                    ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                    {
-                        derdat(i ,j ,k, mf_comp) = data(i,j,k,2) / norm;
-                    });
-                }
+                field_stats.get_mean(lev, "z_velocity", mf[lev], mf_comp);
                 mf_comp ++;
             }
-
             if (containerHasElement(plot_var_names, "umag_t_avg")) {
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-                for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-                {
-                    const Box& bx = mfi.tilebox();
-                    const Array4<Real>& derdat = mf[lev].array(mfi);
-                    const Array4<Real>& data   = vel_t_avg[lev]->array(mfi);
-                    const Real norm = t_avg_cnt[lev];
-                    ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                    {
-                        derdat(i ,j ,k, mf_comp) = data(i,j,k,3) / norm;
-                    });
-                }
+                field_stats.get_mean(lev, "magvel", mf[lev], mf_comp);
                 mf_comp ++;
             }
         }
@@ -993,26 +730,6 @@ ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
                 mf_comp += 1;
             }
 
-        if (containerHasElement(plot_var_names, "qsat"))
-        {
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(mf[lev],TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.tilebox();
-                const Array4<Real>& derdat  = mf[lev].array(mfi);
-                const Array4<Real const>& S_arr = vars_new[lev][Vars::cons].const_array(mfi);
-                ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-                {
-                    Real       qv = S_arr(i,j,k,RhoQ1_comp) / S_arr(i,j,k,Rho_comp);
-                    Real       T  = getTgivenRandRTh(S_arr(i,j,k,Rho_comp), S_arr(i,j,k,RhoTheta_comp), qv);
-                    Real pressure = getPgivenRTh(S_arr(i,j,k,RhoTheta_comp), qv) * Real(0.01);
-                    erf_qsatw(T, pressure, derdat(i,j,k,mf_comp));
-                });
-            }
-            mf_comp ++;
-        }
 
         if(solverChoice.moisture_type == MoistureType::Kessler){
             if (containerHasElement(plot_var_names, "rain_accum"))
@@ -1022,6 +739,20 @@ ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
                 mf_comp += 1;
             }
         }
+        else if(solverChoice.moisture_type == MoistureType::SuperDroplets)
+        {
+            // The superdroplets, and so the rain that reached the ground, only live on level 0
+            if (containerHasElement(plot_var_names, "rain_accum"))
+            {
+                if (lev == 0) {
+                    MultiFab rain_accum_mf(*(qmoist[lev][4]), make_alias, 0, 1);
+                    MultiFab::Copy(mf[lev],rain_accum_mf,0,mf_comp,1,0);
+                } else {
+                    mf[lev].setVal(0.0,mf_comp,1,0);
+                }
+                mf_comp += 1;
+            }
+        }
         else if(solverChoice.moisture_type == MoistureType::SAM)
         {
             if (containerHasElement(plot_var_names, "rain_accum"))
@@ -1045,6 +776,14 @@ ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
         }
         }
 
+        // Running statistics
+        for (const auto& stats_name : field_stats.plot_names()) {
+            if (containerHasElement(plot_var_names, stats_name)) {
+                field_stats.get_plot_var(lev, stats_name, mf[lev], mf_comp);
+                mf_comp += 1;
+            }
+        }
+
 #ifdef ERF_USE_PARTICLES
         const auto& particles_namelist( particleData.getNames() );
         for (ParticlesNamesVector::size_type i = 0; i < particles_namelist.size(); i++) {
@@ -1250,10 +989,34 @@ ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
     }
 
 #ifdef EB_USE_EB
-    for (int lev = 0; lev <= finest_level; ++lev) {
+    for (int lev = 0; lev <= lev_max; ++lev) {
         EB_set_covered(mf[lev], 0.0);
     }
 #endif
+}
+
+// Write plotfile to disk
+void
+ERF::WritePlotFile (int which, Vector<std::string> plot_var_names)
+{
+    const Vector<std::string> varnames = PlotFileVarNames(plot_var_names);
+    const int ncomp_mf = varnames.size();
+
+    if (ncomp_mf == 0) return;
+
+    // Vector of MultiFabs for cell-centered data
+    Vector<MultiFab> mf(finest_level+1);
+    ComputePlotData(plot_var_names, mf, finest_level);
+
+    // Vector of MultiFabs for nodal data
+    Vector<MultiFab> mf_nd(finest_level+1);
+    if (solverChoice.use_terrain) {
+        for (int lev = 0; lev <= finest_level; ++lev) {
+            BoxArray nodal_grids(grids[lev]); nodal_grids.surroundingNodes();
+            mf_nd[lev].define(nodal_grids, dmap[lev], 3, 0);
+            mf_nd[lev].setVal(0.);
+        }
+    }
 
     // Fill terrain distortion MF
     if (solverChoice.use_terrain) {
@@ -33,6 +33,9 @@ void Kessler::Init (const MultiFab& cons_in,
     m_z_phys_nd = z_phys_nd.get();
     m_detJ_cc   = detJ_cc.get();
 
+    // Whole columns for the sedimentation if the grids are split in the vertical
+    m_columns.define(cons_in.boxArray(), geom.Domain());
+
     MicVarMap.resize(m_qmoist_size);
     MicVarMap = {MicVar_Kess::qt, MicVar_Kess::qv, MicVar_Kess::qcl, MicVar_Kess::qp, MicVar_Kess::rain_accum};
 
@@ -63,9 +66,10 @@ void Kessler::Init (const MultiFab& cons_in,
  */
 void Kessler::Copy_State_to_Micro (const MultiFab& cons_in)
 {
-    // Get the temperature, density, theta, qt and qp from input
+    // Get the temperature, density, theta, qt and qp from input, including the
+    // ghost cells that rain falls in from when a grid does not span the column
     for ( MFIter mfi(cons_in); mfi.isValid(); ++mfi) {
-        const auto& box3d = mfi.tilebox();
+        const auto& box3d = mfi.growntilebox();
 
         auto states_array = cons_in.array(mfi);
 
@@ -2,6 +2,8 @@
 #include <TileNoZ.H>
 #include "Kessler.H"
 #include "DataStruct.H"
+#include "BoxCosts.H"
+#include "Sedimentation.H"
 
 using namespace amrex;
 
@@ -11,65 +13,19 @@ using namespace amrex;
 void Kessler::AdvanceKessler (const SolverChoice &solverChoice)
 {
     auto tabs  = mic_fab_vars[MicVar_Kess::tabs];
+
+    // Measured box costs for load balancing (nullptr unless load balancing is on)
+    LayoutData<Real>* costs = BoxCosts::find(*tabs);
     if (solverChoice.moisture_type == MoistureType::Kessler){
         auto dz = m_geom.CellSize(2);
         auto domain = m_geom.Domain();
         int k_lo = domain.smallEnd(2);
         int k_hi = domain.bigEnd(2);
 
-        MultiFab fz;
-        auto ba    = tabs->boxArray();
-        auto dm    = tabs->DistributionMap();
-        fz.define(convert(ba, IntVect(0,0,1)), dm, 1, 0); // No ghost cells
-
         Real dtn = dt;
 
-        for ( MFIter mfi(fz, TilingIfNotGPU()); mfi.isValid(); ++mfi ){
-            auto rho_array = mic_fab_vars[MicVar_Kess::rho]->array(mfi);
-            auto qp_array  = mic_fab_vars[MicVar_Kess::qp]->array(mfi);
-            auto rain_accum_array = mic_fab_vars[MicVar_Kess::rain_accum]->array(mfi);
-
-            auto fz_array  = fz.array(mfi);
-            const Box& tbz = mfi.tilebox();
-
-            ParallelFor(tbz, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
-            {
-                Real rho_avg, qp_avg;
-
-                if (k==k_lo) {
-                    rho_avg = rho_array(i,j,k);
-                    qp_avg  = qp_array(i,j,k);
-                } else if (k==k_hi+1) {
-                    rho_avg = rho_array(i,j,k-1);
-                    qp_avg  = qp_array(i,j,k-1);
-                } else {
-                    rho_avg = 0.5*(rho_array(i,j,k-1) + rho_array(i,j,k)); // Convert to g/cm^3
-                    qp_avg = 0.5*(qp_array(i,j,k-1)  + qp_array(i,j,k));
-                }
-
-                qp_avg = std::max(0.0, qp_avg);
-
-                Real V_terminal = 36.34*std::pow(rho_avg*0.001*qp_avg, 0.1346)*std::pow(rho_avg/1.16, -0.5); // in m/s
-
-                // NOTE: Fz is the sedimentation flux from the advective operator.
-                //       In the terrain-following coordinate system, the z-deriv in
-                //       the divergence uses the normal velocity (Omega). However,
-                //       there are no u/v components to the sedimentation velocity.
-                //       Therefore, we simply end up with a division by detJ when
-                //       evaluating the source term: dJinv * (flux_hi - flux_lo) * dzinv.
-                fz_array(i,j,k) = rho_avg*V_terminal*qp_avg;
-
-                if(k==k_lo){
-                    rain_accum_array(i,j,k) = rain_accum_array(i,j,k) + rho_avg*qp_avg*V_terminal*dtn/1000.0*1000.0; // Divide by rho_water and convert to mm
-                }
-
-                /*if(k==0){
-                  fz_array(i,j,k) = 0;
-                  }*/
-            });
-        }
-
         for ( MFIter mfi(*tabs,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            BoxCostTimer cost_timer(costs, mfi);
             auto qv_array    = mic_fab_vars[MicVar_Kess::qv]->array(mfi);
             auto qc_array    = mic_fab_vars[MicVar_Kess::qcl]->array(mfi);
             auto qp_array    = mic_fab_vars[MicVar_Kess::qp]->array(mfi);
@@ -79,20 +35,14 @@ void Kessler::AdvanceKessler (const SolverChoice &solverChoice)
             auto theta_array = mic_fab_vars[MicVar_Kess::theta]->array(mfi);
             auto rho_array   = mic_fab_vars[MicVar_Kess::rho]->array(mfi);
 
-            const auto dJ_array = (m_detJ_cc) ? m_detJ_cc->const_array(mfi) : Array4<const Real>{};
-
             const auto& box3d = mfi.tilebox();
 
-            auto fz_array  = fz.array(mfi);
-
             // Expose for GPU
             Real d_fac_cond = m_fac_cond;
+            SatLookup sat = m_sat_table.lookup();
 
             ParallelFor(box3d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
             {
-                // Jacobian determinant
-                Real dJinv = (dJ_array) ? 1.0/dJ_array(i,j,k) : 1.0;
-
                 qv_array(i,j,k) = std::max(0.0, qv_array(i,j,k));
                 qc_array(i,j,k) = std::max(0.0, qc_array(i,j,k));
                 qp_array(i,j,k) = std::max(0.0, qp_array(i,j,k));
@@ -102,7 +52,7 @@ void Kessler::AdvanceKessler (const SolverChoice &solverChoice)
                 Real dq_clwater_to_rain, dq_rain_to_vapor, dq_clwater_to_vapor, dq_vapor_to_clwater, qsat;
 
                 Real pressure = pres_array(i,j,k);
-                erf_qsatw(tabs_array(i,j,k), pressure, qsat);
+                sat.qsatw(tabs_array(i,j,k), pressure, qsat);
 
                 // If there is precipitating water (i.e. rain), and the cell is not saturated
                 // then the rain water can evaporate leading to extraction of latent heat, hence
@@ -155,14 +105,9 @@ void Kessler::AdvanceKessler (const SolverChoice &solverChoice)
                     dq_clwater_to_rain = std::min(dq_clwater_to_rain, qc_array(i,j,k));
                 }
 
-                if(std::fabs(fz_array(i,j,k+1)) < 1e-14) fz_array(i,j,k+1) = 0.0;
-                if(std::fabs(fz_array(i,j,k  )) < 1e-14) fz_array(i,j,k  ) = 0.0;
-                Real dq_sed = dtn * dJinv * (1.0/rho_array(i,j,k)) * (fz_array(i,j,k+1) - fz_array(i,j,k))/dz;
-                if(std::fabs(dq_sed) < 1e-14) dq_sed = 0.0;
-
                 qv_array(i,j,k) += -dq_vapor_to_clwater + dq_clwater_to_vapor + dq_rain_to_vapor;
                 qc_array(i,j,k) +=  dq_vapor_to_clwater - dq_clwater_to_vapor - dq_clwater_to_rain;
-                qp_array(i,j,k) +=  dq_sed + dq_clwater_to_rain - dq_rain_to_vapor;
+                qp_array(i,j,k) +=  dq_clwater_to_rain - dq_rain_to_vapor;
 
                 Real theta_over_T = theta_array(i,j,k)/tabs_array(i,j,k);
                 theta_array(i,j,k) += theta_over_T * d_fac_cond * (dq_vapor_to_clwater - dq_clwater_to_vapor - dq_rain_to_vapor);
@@ -174,12 +119,70 @@ void Kessler::AdvanceKessler (const SolverChoice &solverChoice)
                 qt_array(i,j,k) = qv_array(i,j,k) + qc_array(i,j,k);
             });
         }
+
+        // Rain falls in whole columns with as many substeps as its fall speed needs;
+        // grids split in the vertical are gathered into whole columns first
+        const MultiFab* rho_mf   = mic_fab_vars[MicVar_Kess::rho].get();
+        MultiFab*       qp_mf    = mic_fab_vars[MicVar_Kess::qp].get();
+        MultiFab*       accum_mf = mic_fab_vars[MicVar_Kess::rain_accum].get();
+        const MultiFab* dJ_mf    = m_detJ_cc;
+
+        std::unique_ptr<MultiFab> rho_col, qp_col, accum_col, dJ_col;
+        if (m_columns.isSplit()) {
+            rho_col   = m_columns.gather(*rho_mf, 0, 1);   rho_mf   = rho_col.get();
+            qp_col    = m_columns.gather(*qp_mf, 0, 1);    qp_mf    = qp_col.get();
+            accum_col = m_columns.gather(*accum_mf, 0, 1); accum_mf = accum_col.get();
+            if (dJ_mf) {
+                dJ_col = m_columns.gather(*dJ_mf, 0, 1);   dJ_mf    = dJ_col.get();
+            }
+        }
+
+        for ( MFIter mfi(*qp_mf, TileNoZ()); mfi.isValid(); ++mfi ){
+            BoxCostTimer cost_timer((m_columns.isSplit()) ? nullptr : costs, mfi);
+            auto rho_array = rho_mf->const_array(mfi);
+            auto qp_array  = qp_mf->array(mfi);
+            auto rain_accum_array = accum_mf->array(mfi);
+
+            const auto dJ_array = (dJ_mf) ? dJ_mf->const_array(mfi) : Array4<const Real>{};
+
+            const Box& box3d = mfi.tilebox();
+            const int klo = box3d.smallEnd(2);
+            const int khi = box3d.bigEnd(2);
+            const Box box2d = makeSlab(box3d, 2, klo);
+            AMREX_ASSERT(klo == k_lo && khi == k_hi);
+
+            ParallelFor(box2d, [=] AMREX_GPU_DEVICE(int i, int j, int) noexcept
+            {
+                // Terminal speed of rain, in m/s
+                auto rain_vel = [&] (int k, Real qp) -> Real {
+                    Real rho = rho_array(i,j,k);
+                    return 36.34*std::pow(rho*0.001*std::max(0.0, qp), 0.1346)*std::pow(rho/1.16, -0.5);
+                };
+
+                // NOTE: The sedimentation flux is rho*vel*qp. In the terrain-following
+                //       coordinate system, the z-deriv in the divergence uses the
+                //       normal velocity (Omega). However, there are no u/v components
+                //       to the sedimentation velocity. Therefore, we simply end up with
+                //       a division by detJ when evaluating the source term.
+                Real mass_out = sediment_column(i, j, klo, khi, dtn, dz, rho_array, 0,
+                                                dJ_array, qp_array, rain_vel);
+
+                // Divide by rho_water and convert to mm
+                rain_accum_array(i,j,k_lo) += mass_out/1000.0*1000.0;
+            });
+        }
+
+        if (m_columns.isSplit()) {
+            m_columns.scatter(*mic_fab_vars[MicVar_Kess::qp], *qp_col, 0, 1);
+            m_columns.scatter(*mic_fab_vars[MicVar_Kess::rain_accum], *accum_col, 0, 1);
+        }
     }
 
     if (solverChoice.moisture_type == MoistureType::Kessler_NoRain){
 
         // get the temperature, dentisy, theta, qt and qc from input
         for ( MFIter mfi(*tabs,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            BoxCostTimer cost_timer(costs, mfi);
             auto qv_array    = mic_fab_vars[MicVar_Kess::qv]->array(mfi);
             auto qc_array    = mic_fab_vars[MicVar_Kess::qcl]->array(mfi);
             auto qt_array    = mic_fab_vars[MicVar_Kess::qt]->array(mfi);
@@ -191,6 +194,7 @@ void Kessler::AdvanceKessler (const SolverChoice &solverChoice)
 
             // Expose for GPU
             Real d_fac_cond = m_fac_cond;
+            SatLookup sat = m_sat_table.lookup();
 
             ParallelFor(box3d, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
             {
@@ -200,7 +204,7 @@ void Kessler::AdvanceKessler (const SolverChoice &solverChoice)
                 Real dq_clwater_to_vapor, dq_vapor_to_clwater, qsat;
 
                 Real pressure = pres_array(i,j,k);
-                erf_qsatw(tabs_array(i,j,k), pressure, qsat);
+                sat.qsatw(tabs_array(i,j,k), pressure, qsat);
 
                 // If there is precipitating water (i.e. rain), and the cell is not saturated
                 // then the rain water can evaporate leading to extraction of latent heat, hence
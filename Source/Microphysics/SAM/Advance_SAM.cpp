@@ -0,0 +1,572 @@
+#include <AMReX_Scan.H>
+#include "SAM.H"
+#include "IndexDefines.H"
+#include "TileNoZ.H"
+#include "EOS.H"
+#include "BoxCosts.H"
+#include "Sedimentation.H"
+
+using namespace amrex;
+
+/**
+ * Advances the SAM microphysics in place on the conserved state, one column at
+ * a time. Each column is read out of the state and saturation adjusted (Cloud),
+ * then sees cloud ice sedimentation (A32), autoconversion (A30), accretion (A28)
+ * and evaporation (A24), the precipitation fluxes P_{r/s/g} (A19), and is written
+ * back as rho*theta and rho*q. The temperature, pressure and moisture fractions
+ * of the column are left in the diagnostic variables. Clear columns, without
+ * cloud or precipitation and below saturation, are skipped.
+ *
+ * Cloud ice and precipitation fall with the column sedimentation that is shared
+ * with Kessler, which takes as many substeps as the fall speeds need. When the
+ * grids are split in the vertical, the state and the diagnostic variables are
+ * gathered into whole columns for the pass and scattered back after it.
+ */
+void
+SAM::AdvanceSAM (const SolverChoice& sc)
+{
+    AMREX_ALWAYS_ASSERT(m_cons);
+
+    Array<MultiFab*, MicVar::NumVars> vars;
+    for (int ivar = 0; ivar < MicVar::NumVars; ++ivar) {
+        vars[ivar] = mic_fab_vars[ivar].get();
+    }
+
+    if (!m_columns.isSplit()) {
+        AdvanceColumns(sc, *m_cons, vars, m_detJ_cc);
+        return;
+    }
+
+    MultiFab& cons_grids = *m_cons;
+    const int ncomp = cons_grids.nComp();
+
+    auto cons_col = m_columns.gather(cons_grids, 0, ncomp);
+    Vector<std::unique_ptr<MultiFab>> vars_col(MicVar::NumVars);
+    Array<MultiFab*, MicVar::NumVars> vars_col_ptr;
+    for (int ivar = 0; ivar < MicVar::NumVars; ++ivar) {
+        vars_col[ivar] = m_columns.gather(*vars[ivar], 0, 1);
+        vars_col_ptr[ivar] = vars_col[ivar].get();
+    }
+    std::unique_ptr<MultiFab> detJ_col;
+    if (m_detJ_cc) {
+        detJ_col = m_columns.gather(*m_detJ_cc, 0, 1);
+    }
+
+    AdvanceColumns(sc, *cons_col, vars_col_ptr, detJ_col.get());
+
+    m_columns.scatter(cons_grids, *cons_col, 0, ncomp);
+    for (int ivar = 0; ivar < MicVar::NumVars; ++ivar) {
+        m_columns.scatter(*vars[ivar], *vars_col[ivar], 0, 1);
+    }
+}
+
+/**
+ * The column pass of AdvanceSAM on state cons, diagnostic variables vars and
+ * Jacobian detJ (null without terrain), whose boxes span the whole vertical
+ * extent of the domain.
+ */
+void
+SAM::AdvanceColumns (const SolverChoice& sc,
+                     MultiFab& cons,
+                     const Array<MultiFab*, MicVar::NumVars>& vars,
+                     const MultiFab* detJ)
+{
+    int SAM_moisture_type = 1;
+    if (sc.moisture_type == MoistureType::SAM_NoIce ||
+        sc.moisture_type == MoistureType::SAM_NoPrecip_NoIce) {
+        SAM_moisture_type = 2;
+    }
+    const bool do_icefall = (SAM_moisture_type == 1);
+    const bool do_precip  = (sc.moisture_type != MoistureType::SAM_NoPrecip_NoIce);
+
+    Real fac_cond = m_fac_cond;
+    Real fac_sub  = m_fac_sub;
+    Real fac_fus  = m_fac_fus;
+    Real rdOcp    = m_rdOcp;
+    SatLookup sat = m_sat_table.lookup();
+
+    Real eps = std::numeric_limits<Real>::epsilon();
+
+    Real dz   = m_geom.CellSize(2);
+    Real dtn  = dt;
+
+    auto domain = m_geom.Domain();
+    int k_lo = domain.smallEnd(2);
+    int k_hi = domain.bigEnd(2);
+
+    // Autoconversion, accretion and evaporation
+    Real powr1 = (3.0 + b_rain) / 4.0;
+    Real powr2 = (5.0 + b_rain) / 8.0;
+    Real pows1 = (3.0 + b_snow) / 4.0;
+    Real pows2 = (5.0 + b_snow) / 8.0;
+    Real powg1 = (3.0 + b_grau) / 4.0;
+    Real powg2 = (5.0 + b_grau) / 8.0;
+
+    auto accrrc_t  = accrrc.table();
+    auto accrsc_t  = accrsc.table();
+    auto accrsi_t  = accrsi.table();
+    auto accrgc_t  = accrgc.table();
+    auto accrgi_t  = accrgi.table();
+    auto coefice_t = coefice.table();
+    auto evapr1_t  = evapr1.table();
+    auto evapr2_t  = evapr2.table();
+    auto evaps1_t  = evaps1.table();
+    auto evaps2_t  = evaps2.table();
+    auto evapg1_t  = evapg1.table();
+    auto evapg2_t  = evapg2.table();
+
+    // Precipitation fall speeds
+    Real rho_0 = 1.29;
+
+    Real gamr3 = erf_gammafff(4.0+b_rain);
+    Real gams3 = erf_gammafff(4.0+b_snow);
+    Real gamg3 = erf_gammafff(4.0+b_grau);
+
+    Real vrain = (a_rain*gamr3/6.0)*pow((PI*rhor*nzeror),-crain);
+    Real vsnow = (a_snow*gams3/6.0)*pow((PI*rhos*nzeros),-csnow);
+    Real vgrau = (a_grau*gamg3/6.0)*pow((PI*rhog*nzerog),-cgrau);
+
+    LayoutData<Real>* costs = BoxCosts::find(cons);
+
+    for (MFIter mfi(cons, TileNoZ()); mfi.isValid(); ++mfi) {
+        BoxCostTimer cost_timer(costs, mfi);
+
+        const auto& box3d = mfi.tilebox();
+        const int klo = box3d.smallEnd(2);
+        const int khi = box3d.bigEnd(2);
+        const Box box2d = makeSlab(box3d, 2, klo);
+        AMREX_ASSERT(klo == k_lo && khi == k_hi);
+
+        auto cons_array  = cons.array(mfi);
+
+        auto tabs_array  = vars[MicVar::tabs]->array(mfi);
+        auto pres_array  = vars[MicVar::pres]->array(mfi);
+
+        // Non-precipitating
+        auto qv_array    = vars[MicVar::qv]->array(mfi);
+        auto qcl_array   = vars[MicVar::qcl]->array(mfi);
+        auto qci_array   = vars[MicVar::qci]->array(mfi);
+        auto qt_array    = vars[MicVar::qt]->array(mfi);
+
+        // Precipitating
+        auto qpr_array   = vars[MicVar::qpr]->array(mfi);
+        auto qps_array   = vars[MicVar::qps]->array(mfi);
+        auto qpg_array   = vars[MicVar::qpg]->array(mfi);
+        auto qp_array    = vars[MicVar::qp]->array(mfi);
+
+        auto rain_accum_array  = vars[MicVar::rain_accum]->array(mfi);
+        auto snow_accum_array  = vars[MicVar::snow_accum]->array(mfi);
+        auto graup_accum_array = vars[MicVar::graup_accum]->array(mfi);
+
+        const auto dJ_array = (detJ) ? detJ->const_array(mfi) : Array4<const Real>{};
+
+        //==================================================
+        // Active columns
+        //==================================================
+        // A column is clear if the cloud and precipitation in it stay below
+        // qp_threshold and the vapor is below saturation everywhere. A clear
+        // column is only clipped at zero and its cloud evaporated; precipitation
+        // below the threshold is left in place until the column becomes active.
+        const int nx    = box2d.length(0);
+        const int ncol  = box2d.numPts();
+        const auto lo2d = lbound(box2d);
+
+        Gpu::DeviceVector<int> active(ncol);
+        Gpu::DeviceVector<int> active_cols(ncol);
+        int* active_ptr = active.data();
+        int* cols_ptr   = active_cols.data();
+
+        ParallelFor(box2d, [=] AMREX_GPU_DEVICE (int i, int j, int) noexcept
+        {
+            int is_active = 0;
+            for (int k = klo; k <= khi && !is_active; ++k) {
+                Real rho = cons_array(i,j,k,Rho_comp);
+                Real qn  = std::max(0.0, cons_array(i,j,k,RhoQ2_comp)/rho)
+                         + std::max(0.0, cons_array(i,j,k,RhoQ3_comp)/rho);
+                Real qp  = std::max(0.0, cons_array(i,j,k,RhoQ4_comp)/rho)
+                         + std::max(0.0, cons_array(i,j,k,RhoQ5_comp)/rho)
+                         + std::max(0.0, cons_array(i,j,k,RhoQ6_comp)/rho);
+                if (qn > qp_threshold || qp > qp_threshold) {
+                    is_active = 1;
+                } else {
+                    Real qv   = std::max(0.0, cons_array(i,j,k,RhoQ1_comp)/rho);
+                    Real tabs = getTgivenRandRTh(rho, cons_array(i,j,k,RhoTheta_comp), qv);
+                    Real pres = getPgivenRTh(cons_array(i,j,k,RhoTheta_comp), qv) * 0.01;
+                    Real omn  = (SAM_moisture_type == 2) ? 1.0
+                              : std::max(0.0,std::min(1.0,(tabs-tbgmin)*a_bg));
+                    Real qsatw, qsati;
+                    sat.qsatw(tabs, pres, qsatw);
+                    sat.qsati(tabs, pres, qsati);
+                    if (qv + qn >= omn * qsatw + (1.0-omn) * qsati) is_active = 1;
+                }
+            }
+
+            if (!is_active) {
+                for (int k = klo; k <= khi; ++k) {
+                    Real rho      = cons_array(i,j,k,Rho_comp);
+                    Real rhotheta = cons_array(i,j,k,RhoTheta_comp);
+
+                    Real qv  = std::max(0.0,cons_array(i,j,k,RhoQ1_comp)/rho);
+                    Real qcl = std::max(0.0,cons_array(i,j,k,RhoQ2_comp)/rho);
+                    Real qci = std::max(0.0,cons_array(i,j,k,RhoQ3_comp)/rho);
+                    Real qpr = std::max(0.0,cons_array(i,j,k,RhoQ4_comp)/rho);
+                    Real qps = std::max(0.0,cons_array(i,j,k,RhoQ5_comp)/rho);
+                    Real qpg = std::max(0.0,cons_array(i,j,k,RhoQ6_comp)/rho);
+
+                    Real tabs = getTgivenRandRTh(rho, rhotheta, qv);
+                    Real pres = getPgivenRTh(rhotheta, qv) * 0.01;
+
+                    // Cloud below the threshold in unsaturated air evaporates
+                    if (qcl + qci > 0.0) {
+                        CloudCell(sat, SAM_moisture_type, fac_cond, fac_fus, fac_sub,
+                                  rho, tabs, pres, qv, qcl, qci);
+                        cons_array(i,j,k,RhoTheta_comp) = rho*getThgivenPandT(tabs, 100.0*pres, rdOcp);
+                    }
+
+                    tabs_array(i,j,k) = tabs;
+                    pres_array(i,j,k) = pres;
+                      qv_array(i,j,k) = qv;
+                     qcl_array(i,j,k) = qcl;
+                     qci_array(i,j,k) = qci;
+                     qpr_array(i,j,k) = qpr;
+                     qps_array(i,j,k) = qps;
+                     qpg_array(i,j,k) = qpg;
+                      qt_array(i,j,k) = qv + qcl + qci;
+                      qp_array(i,j,k) = qpr + qps + qpg;
+
+                    // The clipped state goes back into the conserved variables
+                    cons_array(i,j,k,RhoQ1_comp) = rho*qv;
+                    cons_array(i,j,k,RhoQ2_comp) = rho*qcl;
+                    cons_array(i,j,k,RhoQ3_comp) = rho*qci;
+                    cons_array(i,j,k,RhoQ4_comp) = rho*qpr;
+                    cons_array(i,j,k,RhoQ5_comp) = rho*qps;
+                    cons_array(i,j,k,RhoQ6_comp) = rho*qpg;
+                }
+            }
+
+            active_ptr[(i-lo2d.x) + (j-lo2d.y)*nx] = is_active;
+        });
+
+        // Compact the active columns so the threads below all have work
+        const int nactive = Scan::PrefixSum<int>( ncol,
+                                [=] AMREX_GPU_DEVICE (int n) -> int { return active_ptr[n]; },
+                                [=] AMREX_GPU_DEVICE (int n, int const& s) { if (active_ptr[n]) cols_ptr[s] = n; },
+                                Scan::Type::exclusive,
+                                Scan::retSum );
+        if (nactive == 0) continue;
+
+        ParallelFor(nactive, [=] AMREX_GPU_DEVICE (int n) noexcept
+        {
+            const int i = lo2d.x + cols_ptr[n] % nx;
+            const int j = lo2d.y + cols_ptr[n] / nx;
+
+            // Saturation adjusted cell of the state
+            auto read_cell = [&] (int k, Real& tabs, Real& pres, Real& qv, Real& qcl, Real& qci, Real& qp)
+            {
+                Real rho      = cons_array(i,j,k,Rho_comp);
+                Real rhotheta = cons_array(i,j,k,RhoTheta_comp);
+
+                qv  = std::max(0.0, cons_array(i,j,k,RhoQ1_comp)/rho);
+                qcl = std::max(0.0, cons_array(i,j,k,RhoQ2_comp)/rho);
+                qci = std::max(0.0, cons_array(i,j,k,RhoQ3_comp)/rho);
+                qp  = std::max(0.0, cons_array(i,j,k,RhoQ4_comp)/rho)
+                    + std::max(0.0, cons_array(i,j,k,RhoQ5_comp)/rho)
+                    + std::max(0.0, cons_array(i,j,k,RhoQ6_comp)/rho);
+
+                tabs = getTgivenRandRTh(rho, rhotheta, qv);
+                pres = getPgivenRTh(rhotheta, qv) * 0.01;
+
+                CloudCell(sat, SAM_moisture_type, fac_cond, fac_fus, fac_sub,
+                          rho, tabs, pres, qv, qcl, qci);
+            };
+
+            //==================================================
+            // Cloud: read and saturation adjust the column
+            //==================================================
+            for (int k = klo; k <= khi; ++k) {
+                Real tabs, pres, qv, qcl, qci, qp;
+                read_cell(k, tabs, pres, qv, qcl, qci, qp);
+
+                tabs_array(i,j,k) = tabs;
+                pres_array(i,j,k) = pres;
+                  qv_array(i,j,k) = qv;
+                 qcl_array(i,j,k) = qcl;
+                 qci_array(i,j,k) = qci;
+                 qpr_array(i,j,k) = std::max(0.0, cons_array(i,j,k,RhoQ4_comp)/cons_array(i,j,k,Rho_comp));
+                 qps_array(i,j,k) = std::max(0.0, cons_array(i,j,k,RhoQ5_comp)/cons_array(i,j,k,Rho_comp));
+                 qpg_array(i,j,k) = std::max(0.0, cons_array(i,j,k,RhoQ6_comp)/cons_array(i,j,k,Rho_comp));
+            }
+
+            // Fractions of precipitation that are rain and graupel
+            auto precip_fractions = [&] (Real tabs, Real& omp, Real& omg)
+            {
+                if (SAM_moisture_type == 2) {
+                    omp = 1.0;
+                    omg = 0.0;
+                } else {
+                    omp = std::max(0.0,std::min(1.0,(tabs-tprmin)*a_pr));
+                    omg = std::max(0.0,std::min(1.0,(tabs-tgrmin)*a_gr));
+                }
+            };
+
+            // NOTE: The sedimentation flux is rho*vel*q. In the terrain-following
+            //       coordinate system, the z-deriv in the divergence uses the
+            //       normal velocity (Omega). However, there are no u/v components
+            //       to the sedimentation velocity. Therefore, we simply end up with
+            //       a division by detJ when evaluating the source term.
+
+            // Terminal speed of cloud ice
+            auto ice_vel = [&] (int, Real qci) -> Real {
+                return min( 0.4 , 8.66 * pow( (max(0.,qci)+1.e-10) , 0.24) );
+            };
+
+            // Terminal speed of precipitation
+            auto precip_vel = [&] (int k, Real qp) -> Real
+            {
+                if (qp <= qp_threshold) return 0.0;
+
+                Real rho = cons_array(i,j,k,Rho_comp);
+                Real omp, omg;
+                precip_fractions(tabs_array(i,j,k), omp, omg);
+
+                Real qrr = omp*qp;
+                Real qss = (1.0-omp)*(1.0-omg)*qp;
+                Real qgg = (1.0-omp)*(omg)*qp;
+                Real Pprecip = omp*vrain*std::pow(rho*qrr,1.0+crain)
+                             + (1.0-omp)*( (1.0-omg)*vsnow*std::pow(rho*qss,1.0+csnow)
+                                         +      omg *vgrau*std::pow(rho*qgg,1.0+cgrau) );
+                return Pprecip * std::sqrt(rho_0/rho) / (rho*qp);
+            };
+
+            //==================================================
+            // Cloud ice sedimentation (A32)
+            //==================================================
+            // NOTE: Sedimentation does not affect the potential temperature,
+            //       but it does affect the liquid/ice static energy.
+            //       No source to Theta occurs here.
+            if (do_icefall) {
+                sediment_column(i, j, klo, khi, dtn, dz, cons_array, Rho_comp,
+                                dJ_array, qci_array, ice_vel);
+            }
+
+            //==================================================
+            // Precipitation
+            //==================================================
+            for (int k = klo; k <= khi && do_precip; ++k) {
+                Real tabs = tabs_array(i,j,k);
+                Real pres = pres_array(i,j,k);
+                Real qv   =   qv_array(i,j,k);
+                Real qcl  =  qcl_array(i,j,k);
+                Real qci  =  qci_array(i,j,k);
+                Real qpr  =  qpr_array(i,j,k);
+                Real qps  =  qps_array(i,j,k);
+                Real qpg  =  qpg_array(i,j,k);
+
+                // Work to be done for autoc/accr or evap
+                if (qcl+qci+qpr+qps+qpg > 0.0) {
+                    Real omn, omp, omg;
+                    if (SAM_moisture_type == 2) {
+                        omn = 1.0;
+                        omp = 1.0;
+                        omg = 0.0;
+                    } else {
+                        omn = std::max(0.0,std::min(1.0,(tabs-tbgmin)*a_bg));
+                        omp = std::max(0.0,std::min(1.0,(tabs-tprmin)*a_pr));
+                        omg = std::max(0.0,std::min(1.0,(tabs-tgrmin)*a_gr));
+                    }
+
+                    // Precipitation before autoconversion and accretion
+                    Real qpr0 = qpr;
+                    Real qps0 = qps;
+                    Real qpg0 = qpg;
+
+                    //==================================================
+                    // Autoconversion (A30/A31) and accretion (A27)
+                    //==================================================
+                    if (qcl+qci > 0.0) {
+                        Real auto_r, autos;
+                        Real accrcr = 0.0;
+                        Real accrcs = 0.0;
+                        Real accris = 0.0;
+                        Real accrcg = 0.0;
+                        Real accrig = 0.0;
+
+                        if (qcl > qcw0) {
+                            auto_r = alphaelq;
+                        } else {
+                            auto_r = 0.0;
+                        }
+
+                        if (qci > qci0) {
+                            autos = betaelq*coefice_t(k);
+                        } else {
+                            autos = 0.0;
+                        }
+
+                        if (omp > 0.001) {
+                            accrcr = accrrc_t(k);
+                        }
+
+                        if (omp < 0.999 && omg < 0.999) {
+                            accrcs = accrsc_t(k);
+                            accris = accrsi_t(k);
+                        }
+
+                        if (omp < 0.999 && omg > 0.001) {
+                            accrcg = accrgc_t(k);
+                            accrig = accrgi_t(k);
+                        }
+
+                        // Autoconversion & accretion (sink for cloud comps)
+                        Real dqca = dtn * auto_r * (qcl-qcw0);
+                        Real dprc = dtn * accrcr * qcl * std::pow(qpr0, powr1);
+                        Real dpsc = dtn * accrcs * qcl * std::pow(qps0, pows1);
+                        Real dpgc = dtn * accrcg * qcl * std::pow(qpg0, powg1);
+
+                        Real dqia = dtn * autos  * (qci-qci0);
+                        Real dpsi = dtn * accris * qci * std::pow(qps0, pows1);
+                        Real dpgi = dtn * accrig * qci * std::pow(qpg0, powg1);
+
+                        // Rescale sinks to avoid negative cloud fractions
+                        Real dqc  = dqca + dprc + dpsc + dpgc;
+                        Real dqi  = dqia + dpsi + dpgi;
+                        Real scalec = std::min(qcl,dqc) / (dqc + eps);
+                        Real scalei = std::min(qci,dqi) / (dqi + eps);
+                        dqca *= scalec; dprc *= scalec; dpsc *= scalec; dpgc *= scalec;
+                        dqia *= scalei; dpsi *= scalei; dpgi *= scalei;
+                        dqc   = dqca + dprc + dpsc + dpgc;
+                        dqi   = dqia + dpsi + dpgi;
+
+                        // NOTE: Autoconversion of cloud water and ice are sources
+                        //       to qp, while accretion is a source to an individual
+                        //       precipitating component (e.g., qpr/qps/qpg). So we
+                        //       only split autoconversion with omega. The omega
+                        //       splitting does imply a latent heat source.
+
+                        // Partition formed precip componentss
+                        Real dqpr = (dqca + dqia) * omp + dprc;
+                        Real dqps = (dqca + dqia) * (1.0 - omp) * (1.0 - omg) + dpsc + dpsi;
+                        Real dqpg = (dqca + dqia) * (1.0 - omp) * omg         + dpgc + dpgi;
+
+                        // Update the primitive state variables
+                        qcl -= dqc;
+                        qci -= dqi;
+                        qpr += dqpr;
+                        qps += dqps;
+                        qpg += dqpg;
+
+                        // Update temperature
+                        tabs += fac_fus * ( dqca * (1.0 - omp) - dqia * omp );
+                    }
+
+                    //==================================================
+                    // Evaporation (A24)
+                    //==================================================
+                    Real qsat, qsatw, qsati;
+                    sat.qsatw(tabs,pres,qsatw);
+                    sat.qsati(tabs,pres,qsati);
+                    qsat = qsatw * omn + qsati * (1.0-omn);
+                    if((qpr+qps+qpg > 0.0) && (qv < qsat)) {
+
+                        Real dqpr = evapr1_t(k)*sqrt(qpr0) + evapr2_t(k)*pow(qpr0,powr2);
+                        Real dqps = evaps1_t(k)*sqrt(qps0) + evaps2_t(k)*pow(qps0,pows2);
+                        Real dqpg = evapg1_t(k)*sqrt(qpg0) + evapg2_t(k)*pow(qpg0,powg2);
+
+                        // NOTE: This is always a sink for precipitating comps
+                        //       since qv<qsat and thus (1 - qv/qsat)>0. If we are
+                        //       in a super-saturated state (qv>qsat) the Newton
+                        //       iterations in Cloud() will have handled condensation.
+                        dqpr *= dtn * (1.0 - qv/qsat);
+                        dqps *= dtn * (1.0 - qv/qsat);
+                        dqpg *= dtn * (1.0 - qv/qsat);
+
+                        // Limit to avoid negative moisture fractions
+                        dqpr = std::min(qpr,dqpr);
+                        dqps = std::min(qps,dqps);
+                        dqpg = std::min(qpg,dqpg);
+
+                        // Update the primitive state variables
+                        qv  += dqpr + dqps + dqpg;
+                        qpr -= dqpr;
+                        qps -= dqps;
+                        qpg -= dqpg;
+
+                        // Update temperature
+                        tabs -= fac_cond * dqpr + fac_sub * (dqps + dqpg);
+                    }
+
+                    tabs_array(i,j,k) = tabs;
+                      qv_array(i,j,k) = qv;
+                     qcl_array(i,j,k) = qcl;
+                     qci_array(i,j,k) = qci;
+                     qpr_array(i,j,k) = qpr;
+                     qps_array(i,j,k) = qps;
+                     qpg_array(i,j,k) = qpg;
+                }
+            }
+
+            //==================================================
+            // Precipitating sedimentation (A19)
+            //==================================================
+            if (do_precip) {
+                for (int k = klo; k <= khi; ++k) {
+                    qp_array(i,j,k) = qpr_array(i,j,k) + qps_array(i,j,k) + qpg_array(i,j,k);
+                }
+
+                Real mass_out = sediment_column(i, j, klo, khi, dtn, dz, cons_array, Rho_comp,
+                                                dJ_array, qp_array, precip_vel);
+
+                // Precipitation that reached the ground, in mm of water, snow and graupel
+                Real omp_sfc, omg_sfc;
+                precip_fractions(tabs_array(i,j,k_lo), omp_sfc, omg_sfc);
+                rain_accum_array(i,j,k_lo)  += mass_out*omp_sfc/rhor*1000.0;
+                snow_accum_array(i,j,k_lo)  += mass_out*(1.0-omp_sfc)*(1.0-omg_sfc)/rhos*1000.0;
+                graup_accum_array(i,j,k_lo) += mass_out*(1.0-omp_sfc)*omg_sfc/rhog*1000.0;
+
+                // Losses come out of each kind in proportion; gains are split by temperature
+                for (int k = klo; k <= khi; ++k) {
+                    Real qp_old = qpr_array(i,j,k) + qps_array(i,j,k) + qpg_array(i,j,k);
+                    Real qp_new = qp_array(i,j,k);
+                    if (qp_new < qp_old) {
+                        Real fac = qp_new / qp_old;
+                        qpr_array(i,j,k) *= fac;
+                        qps_array(i,j,k) *= fac;
+                        qpg_array(i,j,k) *= fac;
+                    } else {
+                        Real dqp = qp_new - qp_old;
+                        Real omp, omg;
+                        precip_fractions(tabs_array(i,j,k), omp, omg);
+                        qpr_array(i,j,k) += dqp*omp;
+                        qps_array(i,j,k) += dqp*(1.0-omp)*(1.0-omg);
+                        qpg_array(i,j,k) += dqp*(1.0-omp)*omg;
+                    }
+                }
+            }
+
+            //==================================================
+            // Writeback
+            //==================================================
+            for (int k = klo; k <= khi; ++k) {
+                Real rho = cons_array(i,j,k,Rho_comp);
+
+                qt_array(i,j,k) = qv_array(i,j,k) + qcl_array(i,j,k) + qci_array(i,j,k);
+                qp_array(i,j,k) = qpr_array(i,j,k) + qps_array(i,j,k) + qpg_array(i,j,k);
+
+                Real theta = getThgivenPandT(tabs_array(i,j,k), 100.0*pres_array(i,j,k), rdOcp);
+
+                cons_array(i,j,k,RhoTheta_comp) = rho*theta;
+
+                cons_array(i,j,k,RhoQ1_comp) = rho*std::max(0.0, qv_array(i,j,k));
+                cons_array(i,j,k,RhoQ2_comp) = rho*std::max(0.0,qcl_array(i,j,k));
+                cons_array(i,j,k,RhoQ3_comp) = rho*std::max(0.0,qci_array(i,j,k));
+
+                cons_array(i,j,k,RhoQ4_comp) = rho*std::max(0.0,qpr_array(i,j,k));
+                cons_array(i,j,k,RhoQ5_comp) = rho*std::max(0.0,qps_array(i,j,k));
+                cons_array(i,j,k,RhoQ6_comp) = rho*std::max(0.0,qpg_array(i,j,k));
+            }
+        });
+
+        // The column lists go out of scope
+        Gpu::streamSynchronize();
+    }
+}
@@ -33,10 +33,17 @@ SAM::Init (const MultiFab& cons_in,
     m_z_phys_nd = z_phys_nd.get();
     m_detJ_cc   = detJ_cc.get();
 
+    // Whole columns for the sedimentation if the grids are split in the vertical
+    m_columns.define(cons_in.boxArray(), geom.Domain());
+
     MicVarMap.resize(m_qmoist_size);
     MicVarMap = {MicVar::qt, MicVar::qv , MicVar::qcl, MicVar::qci,
                  MicVar::qp, MicVar::qpr, MicVar::qps, MicVar::qpg, MicVar::rain_accum, MicVar::snow_accum, MicVar::graup_accum};
 
+    // The diagnostic variables are filled again before the next advance
+    m_cons = nullptr;
+    m_have_micro_vars = false;
+
     // initialize microphysics variables
     for (auto ivar = 0; ivar < MicVar::NumVars; ++ivar) {
         mic_fab_vars[ivar] = std::make_shared<MultiFab>(cons_in.boxArray(), cons_in.DistributionMap(),
@@ -80,14 +87,15 @@ SAM::Init (const MultiFab& cons_in,
 
 
 /**
- * Initializes the Microphysics module.
+ * Fills the diagnostic variables from the conserved state. SAM advances the
+ * state in place, so this is only needed before the diagnostics are first used.
  *
  * @param[in] cons_in Conserved variables input
  */
 void
 SAM::Copy_State_to_Micro (const MultiFab& cons_in)
 {
-    // Get the temperature, density, theta, qt and qp from input
+    // Get the temperature, pressure, qt and qp from input
     for ( MFIter mfi(cons_in); mfi.isValid(); ++mfi) {
         const auto& box3d = mfi.growntilebox();
 
@@ -97,7 +105,6 @@ SAM::Copy_State_to_Micro (const MultiFab& cons_in)
         auto qv_array    = mic_fab_vars[MicVar::qv]->array(mfi);
         auto qc_array    = mic_fab_vars[MicVar::qcl]->array(mfi);
         auto qi_array    = mic_fab_vars[MicVar::qci]->array(mfi);
-        auto qn_array    = mic_fab_vars[MicVar::qn]->array(mfi);
         auto qt_array    = mic_fab_vars[MicVar::qt]->array(mfi);
 
         // Precipitating
@@ -106,22 +113,16 @@ SAM::Copy_State_to_Micro (const MultiFab& cons_in)
         auto qpg_array   = mic_fab_vars[MicVar::qpg]->array(mfi);
         auto qp_array    = mic_fab_vars[MicVar::qp]->array(mfi);
 
-        auto rho_array   = mic_fab_vars[MicVar::rho]->array(mfi);
-        auto theta_array = mic_fab_vars[MicVar::theta]->array(mfi);
         auto tabs_array  = mic_fab_vars[MicVar::tabs]->array(mfi);
         auto pres_array  = mic_fab_vars[MicVar::pres]->array(mfi);
 
-        // Get pressure, theta, temperature, density, and qt, qp
+        // Get pressure, temperature, and qt, qp
         ParallelFor( box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
         {
-            rho_array(i,j,k)   = states_array(i,j,k,Rho_comp);
-            theta_array(i,j,k) = states_array(i,j,k,RhoTheta_comp)/states_array(i,j,k,Rho_comp);
-
             qv_array(i,j,k)    = std::max(0.0,states_array(i,j,k,RhoQ1_comp)/states_array(i,j,k,Rho_comp));
             qc_array(i,j,k)    = std::max(0.0,states_array(i,j,k,RhoQ2_comp)/states_array(i,j,k,Rho_comp));
             qi_array(i,j,k)    = std::max(0.0,states_array(i,j,k,RhoQ3_comp)/states_array(i,j,k,Rho_comp));
-            qn_array(i,j,k)    = qc_array(i,j,k) + qi_array(i,j,k);
-            qt_array(i,j,k)    = qv_array(i,j,k) + qn_array(i,j,k);
+            qt_array(i,j,k)    = qv_array(i,j,k) + qc_array(i,j,k) + qi_array(i,j,k);
 
             qpr_array(i,j,k)   = std::max(0.0,states_array(i,j,k,RhoQ4_comp)/states_array(i,j,k,Rho_comp));
             qps_array(i,j,k)   = std::max(0.0,states_array(i,j,k,RhoQ5_comp)/states_array(i,j,k,Rho_comp));
@@ -137,7 +138,13 @@ SAM::Copy_State_to_Micro (const MultiFab& cons_in)
 }
 
 
-void SAM::Compute_Coefficients ()
+/**
+ * Computes the coefficients of the precipitation processes from the plane
+ * averages of rho, theta and qv of the conserved state.
+ *
+ * @param[in] cons_in Conserved variables input
+ */
+void SAM::Compute_Coefficients (const MultiFab& cons_in)
 {
     auto dz   = m_geom.CellSize(2);
     auto lowz = m_geom.ProbLo(2);
@@ -170,21 +177,32 @@ void SAM::Compute_Coefficients ()
     Real gamg1 = erf_gammafff(3.0+b_grau      );
     Real gamg2 = erf_gammafff((5.0+b_grau)/2.0);
 
-    // calculate the plane average variables
-    PlaneAverage rho_ave(mic_fab_vars[MicVar::rho].get(), m_geom, m_axis);
-    PlaneAverage theta_ave(mic_fab_vars[MicVar::theta].get(), m_geom, m_axis);
-    PlaneAverage qv_ave(mic_fab_vars[MicVar::qv].get(), m_geom, m_axis);
-    rho_ave.compute_averages(ZDir(), rho_ave.field());
-    theta_ave.compute_averages(ZDir(), theta_ave.field());
-    qv_ave.compute_averages(ZDir(), qv_ave.field());
+    // calculate the plane averages of rho, theta and qv
+    MultiFab rho_theta_qv(cons_in.boxArray(), cons_in.DistributionMap(), 3, cons_in.nGrowVect());
+    for ( MFIter mfi(rho_theta_qv, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const auto& box3d = mfi.growntilebox();
+
+        auto states_array = cons_in.const_array(mfi);
+        auto rtq_array    = rho_theta_qv.array(mfi);
+
+        ParallelFor( box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
+        {
+            Real rho = states_array(i,j,k,Rho_comp);
+            rtq_array(i,j,k,0) = rho;
+            rtq_array(i,j,k,1) = states_array(i,j,k,RhoTheta_comp)/rho;
+            rtq_array(i,j,k,2) = std::max(0.0,states_array(i,j,k,RhoQ1_comp)/rho);
+        });
+    }
+    PlaneAverage rtq_ave(&rho_theta_qv, m_geom, m_axis);
+    rtq_ave.compute_averages(ZDir(), rtq_ave.field());
 
-    // get host variable rho, and rhotheta
-    int ncell = rho_ave.ncell_line();
+    // get host variable rho, theta and qv
+    int ncell = rtq_ave.ncell_line();
 
     Gpu::HostVector<Real> rho_h(ncell), theta_h(ncell), qv_h(ncell);
-    rho_ave.line_average(0, rho_h);
-    theta_ave.line_average(0, theta_h);
-    qv_ave.line_average(0, qv_h);
+    rtq_ave.line_average(0, rho_h);
+    rtq_ave.line_average(1, theta_h);
+    rtq_ave.line_average(2, qv_h);
 
     // copy data to device
     Gpu::DeviceVector<Real> rho_d(ncell), theta_d(ncell), qv_d(ncell);
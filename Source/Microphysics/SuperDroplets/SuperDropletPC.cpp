@@ -0,0 +1,615 @@
+#include "SuperDropletPC.H"
+
+#ifdef ERF_USE_PARTICLES
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_Random.H>
+#include <AMReX_Scan.H>
+
+#include "EOS.H"
+#include "IndexDefines.H"
+#include "Microphysics_Utils.H"
+
+using namespace amrex;
+using namespace SuperDropletConstants;
+
+namespace {
+    // Index of the cell that holds a particle
+    template <typename P>
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    IntVect sd_cell (P const& p,
+                     GpuArray<Real,AMREX_SPACEDIM> const& plo,
+                     GpuArray<Real,AMREX_SPACEDIM> const& dxi,
+                     Dim3 const& dlo)
+    {
+        return IntVect(int(Math::floor((p.pos(0)-plo[0])*dxi[0])) + dlo.x,
+                       int(Math::floor((p.pos(1)-plo[1])*dxi[1])) + dlo.y,
+                       p.idata(ERFParticlesIntIdxAoS::k));
+    }
+}
+
+SuperDropletPC::SuperDropletPC ( const Geometry&            a_geom,
+                                 const DistributionMapping& a_dmap,
+                                 const BoxArray&            a_ba,
+                                 const std::string&         a_name )
+    : ERFPC(a_geom, a_dmap, a_ba, a_name)
+{
+    BL_PROFILE("SuperDropletPC::SuperDropletPC()");
+    for (int n = ERFParticlesRealIdxSoA::ncomps; n < SuperDropletRealIdx::ncomps; ++n) {
+        AddRealComp(true);
+    }
+    readSuperDropletInputs();
+}
+
+/*! Read inputs from file */
+void SuperDropletPC::readSuperDropletInputs ()
+{
+    ParmParse pp(m_name);
+
+    m_aerosol_number = 1.0e8;
+    pp.query("aerosol_number", m_aerosol_number);
+
+    m_aerosol_radius = 0.05e-6;
+    pp.query("aerosol_radius", m_aerosol_radius);
+
+    m_aerosol_sigma = 1.5;
+    pp.query("aerosol_sigma", m_aerosol_sigma);
+
+    AMREX_ALWAYS_ASSERT(m_aerosol_number > 0.0 && m_aerosol_radius > 0.0 && m_aerosol_sigma >= 1.0);
+}
+
+/*! Place initial_particles_per_cell superdroplets in every cell of the particle box.
+ *  Each stands for the same number of aerosol particles and gets a dry radius drawn
+ *  from the lognormal distribution; the droplets start dry and take up water in the
+ *  first condensation steps. */
+void SuperDropletPC::InitializeSuperDroplets (const std::unique_ptr<MultiFab>& a_z_phys_nd)
+{
+    BL_PROFILE("SuperDropletPC::InitializeSuperDroplets()");
+
+    InitializeParticles(a_z_phys_nd);
+
+    const int lev = 0;
+    const auto dx = Geom(lev).CellSizeArray();
+    const Real cell_vol = dx[0]*dx[1]*dx[2];
+    const Real xi = std::max(1.0, std::floor(m_aerosol_number*cell_vol/m_ppc_init));
+
+    const Real mu    = std::log(m_aerosol_radius);
+    const Real sigma = std::log(m_aerosol_sigma);
+
+    for (ParIterType pti(*this, lev); pti.isValid(); ++pti)
+    {
+        auto& ptile = ParticlesAt(lev, pti);
+        auto& soa   = ptile.GetStructOfArrays();
+        const int np = ptile.numParticles();
+
+        auto* mass_ptr = soa.GetRealData(ERFParticlesRealIdxSoA::mass).data();
+        auto* mult_ptr = soa.GetRealData(SuperDropletRealIdx::multiplicity).data();
+        auto* rad_ptr  = soa.GetRealData(SuperDropletRealIdx::radius).data();
+        auto* sol_ptr  = soa.GetRealData(SuperDropletRealIdx::solute_mass).data();
+
+        ParallelForRNG(np, [=] AMREX_GPU_DEVICE (int n, RandomEngine const& engine) noexcept
+        {
+            Real rd = std::exp(RandomNormal(mu, sigma, engine));
+            mult_ptr[n] = xi;
+            rad_ptr[n]  = rd;
+            sol_ptr[n]  = (4.0/3.0)*PI*rd*rd*rd*rho_solute;
+            mass_ptr[n] = 0.0;
+        });
+    }
+}
+
+/*! Let the superdroplets fall at their terminal speed relative to the air, then
+ *  advect them with the flow. A droplet that falls below the lowest cell has
+ *  reached the ground: its water is added to the accumulated rain of its column
+ *  and it is removed at the next Redistribute. The fall comes first so every
+ *  droplet still indexes the grid that owns it, and it is limited to one cell
+ *  per step so that large drops with long time steps do not skip cells. */
+void SuperDropletPC::Transport ( Real a_dt,
+                                 MultiFab* a_umac,
+                                 const MultiFab& a_cons,
+                                 MultiFab& a_rain_accum,
+                                 const std::unique_ptr<MultiFab>& a_z_phys_nd,
+                                 const MultiFab* /*a_detJ*/ )
+{
+    BL_PROFILE("SuperDropletPC::Transport()");
+
+    const int lev = 0;
+    const auto& geom = Geom(lev);
+    const auto plo = geom.ProbLoArray();
+    const auto dx  = geom.CellSizeArray();
+    const auto dxi = geom.InvCellSizeArray();
+    const auto dlo = lbound(geom.Domain());
+    const Real inv_area = 1.0/(dx[0]*dx[1]);
+    const bool use_terrain = (a_z_phys_nd != nullptr);
+
+    for (ParIterType pti(*this, lev); pti.isValid(); ++pti)
+    {
+        int grid    = pti.index();
+        auto& ptile = ParticlesAt(lev, pti);
+        auto& aos   = ptile.GetArrayOfStructs();
+        auto& soa   = ptile.GetStructOfArrays();
+        const int np = aos.numParticles();
+        auto* p_pbox = aos().data();
+
+        auto* mult_ptr = soa.GetRealData(SuperDropletRealIdx::multiplicity).data();
+        auto* rad_ptr  = soa.GetRealData(SuperDropletRealIdx::radius).data();
+        auto* sol_ptr  = soa.GetRealData(SuperDropletRealIdx::solute_mass).data();
+
+        auto cons_arr = a_cons.const_array(grid);
+        auto rain_arr = a_rain_accum.array(grid);
+        auto zheight  = use_terrain ? (*a_z_phys_nd)[grid].const_array() : Array4<const Real>{};
+
+        ParallelFor(np, [=] AMREX_GPU_DEVICE (int n) noexcept
+        {
+            auto& p = p_pbox[n];
+            if (p.id() <= 0) { return; }
+
+            IntVect iv = sd_cell(p, plo, dxi, dlo);
+            Real dz_loc = dx[2];
+            if (use_terrain) {
+                dz_loc = 0.25 * ( zheight(iv[0]  ,iv[1]  ,iv[2]+1) - zheight(iv[0]  ,iv[1]  ,iv[2])
+                                + zheight(iv[0]+1,iv[1]  ,iv[2]+1) - zheight(iv[0]+1,iv[1]  ,iv[2])
+                                + zheight(iv[0]  ,iv[1]+1,iv[2]+1) - zheight(iv[0]  ,iv[1]+1,iv[2])
+                                + zheight(iv[0]+1,iv[1]+1,iv[2]+1) - zheight(iv[0]+1,iv[1]+1,iv[2]) );
+            }
+            p.pos(2) -= amrex::min(sd_terminal_velocity(rad_ptr[n], cons_arr(iv,Rho_comp)) * a_dt, dz_loc);
+
+            bool on_ground;
+            if (use_terrain) {
+                update_location_idata(p, plo, dxi, zheight);
+                on_ground = (p.idata(ERFParticlesIntIdxAoS::k) < dlo.z);
+            } else {
+                on_ground = (p.pos(2) < plo[2]);
+            }
+
+            if (on_ground) {
+                // Divide by rho_water and convert to mm
+                Real mass = mult_ptr[n]*sd_water_mass(rad_ptr[n], sol_ptr[n]);
+                Gpu::Atomic::AddNoRet(&rain_arr(iv[0],iv[1],dlo.z), mass*inv_area/rhor*1000.0);
+                p.id() = -1;
+            }
+        });
+    }
+
+    AdvectWithFlow(a_umac, lev, a_dt, a_z_phys_nd);
+
+    // Without terrain the vertical index is not updated by the advection
+    if (!use_terrain) {
+        for (ParIterType pti(*this, lev); pti.isValid(); ++pti)
+        {
+            auto& aos = ParticlesAt(lev, pti).GetArrayOfStructs();
+            const int np = aos.numParticles();
+            auto* p_pbox = aos().data();
+            ParallelFor(np, [=] AMREX_GPU_DEVICE (int n) noexcept
+            {
+                auto& p = p_pbox[n];
+                p.idata(ERFParticlesIntIdxAoS::k) = int(Math::floor((p.pos(2)-plo[2])*dxi[2])) + dlo.z;
+            });
+        }
+    }
+
+    Redistribute();
+}
+
+/*! Grow or shrink every droplet towards equilibrium with the vapor of its cell.
+ *  The radius follows r dr/dt = (S - 1 - A/r + B/r^3) / (F_k + F_d) and is
+ *  advanced implicitly in r^2 with a safeguarded Newton iteration, since the
+ *  haze droplets relax much faster than the time step. The water taken up in a
+ *  cell is limited so the cell does not overshoot saturation, and the vapor and
+ *  heat of the state are changed by what the droplets gained. */
+void SuperDropletPC::Condense ( Real a_dt,
+                                MultiFab& a_cons,
+                                const MultiFab* a_detJ )
+{
+    BL_PROFILE("SuperDropletPC::Condense()");
+
+    const int lev = 0;
+    const auto& geom = Geom(lev);
+    const auto plo = geom.ProbLoArray();
+    const auto dx  = geom.CellSizeArray();
+    const auto dxi = geom.InvCellSizeArray();
+    const auto dlo = lbound(geom.Domain());
+    const Real cell_vol = dx[0]*dx[1]*dx[2];
+
+    for (ParIterType pti(*this, lev); pti.isValid(); ++pti)
+    {
+        int grid    = pti.index();
+        auto& ptile = ParticlesAt(lev, pti);
+        auto& aos   = ptile.GetArrayOfStructs();
+        auto& soa   = ptile.GetStructOfArrays();
+        const int np = aos.numParticles();
+        auto* p_pbox = aos().data();
+
+        auto* mass_ptr = soa.GetRealData(ERFParticlesRealIdxSoA::mass).data();
+        auto* mult_ptr = soa.GetRealData(SuperDropletRealIdx::multiplicity).data();
+        auto* rad_ptr  = soa.GetRealData(SuperDropletRealIdx::radius).data();
+        auto* sol_ptr  = soa.GetRealData(SuperDropletRealIdx::solute_mass).data();
+
+        const Box& bx = pti.validbox();
+        auto cons_arr = a_cons.array(grid);
+        auto detJ_arr = (a_detJ) ? a_detJ->const_array(grid) : Array4<const Real>{};
+
+        // Unlimited new radius of every droplet and the water gained per cell
+        Gpu::DeviceVector<Real> r_new(np);
+        auto* r_new_ptr = r_new.data();
+
+        FArrayBox dm_fab(bx, 2, The_Async_Arena());
+        auto dm_arr = dm_fab.array();
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            dm_arr(i,j,k,0) = 0.0;
+            dm_arr(i,j,k,1) = 1.0;
+        });
+
+        ParallelFor(np, [=] AMREX_GPU_DEVICE (int n) noexcept
+        {
+            auto& p = p_pbox[n];
+            r_new_ptr[n] = rad_ptr[n];
+            if (p.id() <= 0) { return; }
+
+            IntVect iv = sd_cell(p, plo, dxi, dlo);
+            Real rho  = cons_arr(iv,Rho_comp);
+            Real qv   = amrex::max(0.0, cons_arr(iv,RhoQ1_comp)/rho);
+            Real tabs = getTgivenRandRTh(rho, cons_arr(iv,RhoTheta_comp), qv);
+            Real pres = getPgivenRTh(cons_arr(iv,RhoTheta_comp), qv);
+
+            Real qsat;
+            erf_qsatw(tabs, pres*0.01, qsat);
+            Real es = erf_esatw(tabs)*100.0;
+            Real S  = qv/qsat;
+
+            // Thermal conduction and vapor diffusion terms, Koehler coefficients
+            Real F = rhor*lcond*lcond/(therco*R_v*tabs*tabs) + rhor*R_v*tabs/(diffelq*es);
+            Real A = 3.3e-7/tabs;
+            Real B = van_t_hoff*sol_ptr[n]*mw_water / ((4.0/3.0)*PI*rhor*mw_solute);
+            Real c = 2.0*a_dt/F;
+
+            Real R = sd_koehler_r2(rad_ptr[n]*rad_ptr[n], sol_ptr[n], S, A, B, c);
+            r_new_ptr[n] = std::sqrt(R);
+
+            Real dm = mult_ptr[n]*( sd_water_mass(r_new_ptr[n], sol_ptr[n])
+                                  - sd_water_mass(rad_ptr[n],   sol_ptr[n]) );
+            Gpu::Atomic::AddNoRet(&dm_arr(iv,0), dm);
+        });
+
+        // Fraction of the change each cell can take without crossing saturation
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            Real dm = dm_arr(i,j,k,0);
+            if (dm == 0.0) return;
+
+            Real vol  = cell_vol * ((detJ_arr) ? detJ_arr(i,j,k) : 1.0);
+            Real rho  = cons_arr(i,j,k,Rho_comp);
+            Real qv   = amrex::max(0.0, cons_arr(i,j,k,RhoQ1_comp)/rho);
+            Real tabs = getTgivenRandRTh(rho, cons_arr(i,j,k,RhoTheta_comp), qv);
+            Real pres = getPgivenRTh(cons_arr(i,j,k,RhoTheta_comp), qv);
+            Real qsat;
+            erf_qsatw(tabs, pres*0.01, qsat);
+
+            Real avail = std::abs(qv - qsat)
+                       / (1.0 + lcond*lcond*qsat/(Cp_d*R_v*tabs*tabs)) * rho * vol;
+            if ((dm > 0.0) != (qv > qsat)) avail = 0.0;
+            Real frac = amrex::min(1.0, avail/std::abs(dm));
+            dm_arr(i,j,k,1) = frac;
+
+            // Vapor and latent heat exchanged with the state
+            Real dq = frac*dm/(rho*vol);
+            Real theta = cons_arr(i,j,k,RhoTheta_comp)/rho;
+            cons_arr(i,j,k,RhoQ1_comp)    -= rho*dq;
+            cons_arr(i,j,k,RhoTheta_comp) += rho*theta/tabs * lcond/Cp_d * dq;
+        });
+
+        ParallelFor(np, [=] AMREX_GPU_DEVICE (int n) noexcept
+        {
+            auto& p = p_pbox[n];
+            if (p.id() <= 0) { return; }
+
+            IntVect iv = sd_cell(p, plo, dxi, dlo);
+            Real frac = dm_arr(iv,1);
+            Real r3_old = rad_ptr[n]*rad_ptr[n]*rad_ptr[n];
+            Real r3_new = r_new_ptr[n]*r_new_ptr[n]*r_new_ptr[n];
+            rad_ptr[n]  = std::cbrt(r3_old + frac*(r3_new - r3_old));
+            mass_ptr[n] = mult_ptr[n]*sd_water_mass(rad_ptr[n], sol_ptr[n]);
+        });
+
+        Gpu::streamSynchronize();
+    }
+}
+
+/*! Order the particles of a tile by cell: count them with atomics, take the
+ *  prefix sum of the counts and scatter the particle indices. */
+void SuperDropletPC::SortByCell ( const ParIterType& a_pti,
+                                  BaseFab<int>& a_counts,
+                                  BaseFab<int>& a_offsets,
+                                  Gpu::DeviceVector<int>& a_perm ) const
+{
+    const int lev = 0;
+    const auto& geom = Geom(lev);
+    const auto plo = geom.ProbLoArray();
+    const auto dxi = geom.InvCellSizeArray();
+    const auto dlo = lbound(geom.Domain());
+
+    const auto& ptile = ParticlesAt(lev, a_pti);
+    const auto& aos   = ptile.GetArrayOfStructs();
+    const int np = aos.numParticles();
+    const auto* p_pbox = aos().data();
+
+    const Box& bx = a_pti.validbox();
+    a_counts.resize(bx, 1);
+    a_offsets.resize(bx, 1);
+    a_counts.setVal<RunOn::Device>(0);
+    auto counts_arr  = a_counts.array();
+    auto offsets_arr = a_offsets.array();
+
+    ParallelFor(np, [=] AMREX_GPU_DEVICE (int n) noexcept
+    {
+        if (p_pbox[n].id() <= 0) { return; }
+        Gpu::Atomic::AddNoRet(&counts_arr(sd_cell(p_pbox[n], plo, dxi, dlo)), 1);
+    });
+
+    const int ncell = bx.numPts();
+    const int* in = a_counts.dataPtr();
+    int* out = a_offsets.dataPtr();
+    int nvalid = Scan::PrefixSum<int>( ncell,
+                                       [=] AMREX_GPU_DEVICE (int i) -> int { return in[i]; },
+                                       [=] AMREX_GPU_DEVICE (int i, int const &x) { out[i] = x; },
+                                       Scan::Type::exclusive,
+                                       Scan::retSum );
+
+    a_perm.resize(nvalid);
+    auto* perm_ptr = a_perm.data();
+
+    BaseFab<int> cursor(bx, 1, The_Async_Arena());
+    auto cursor_arr = cursor.array();
+    ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        cursor_arr(i,j,k) = offsets_arr(i,j,k);
+    });
+    ParallelFor(np, [=] AMREX_GPU_DEVICE (int n) noexcept
+    {
+        if (p_pbox[n].id() <= 0) { return; }
+        int pos = Gpu::Atomic::Add(&cursor_arr(sd_cell(p_pbox[n], plo, dxi, dlo)), 1);
+        perm_ptr[pos] = n;
+    });
+    Gpu::streamSynchronize();
+}
+
+/*! Collision and coalescence of Shima et al. (2009). The n superdroplets of a
+ *  cell are shuffled and split into n/2 candidate pairs, and the probability of
+ *  each pair is scaled up by n(n-1)/2 / (n/2) to stand for all pairs. With the
+ *  hydrodynamic kernel K = E pi (r_j+r_k)^2 |v_j - v_k|, a pair coalesces gamma
+ *  times, where gamma is the integer part of the scaled probability plus one
+ *  with the probability of its fractional part. */
+void SuperDropletPC::Coalesce ( Real a_dt,
+                                const MultiFab& a_cons,
+                                const MultiFab* a_detJ )
+{
+    BL_PROFILE("SuperDropletPC::Coalesce()");
+
+    const int lev = 0;
+    const auto dx = Geom(lev).CellSizeArray();
+    const Real cell_vol = dx[0]*dx[1]*dx[2];
+
+    BaseFab<int> counts, offsets;
+    Gpu::DeviceVector<int> perm;
+
+    for (ParIterType pti(*this, lev); pti.isValid(); ++pti)
+    {
+        int grid    = pti.index();
+        auto& ptile = ParticlesAt(lev, pti);
+        auto& soa   = ptile.GetStructOfArrays();
+
+        SortByCell(pti, counts, offsets, perm);
+
+        auto* mass_ptr = soa.GetRealData(ERFParticlesRealIdxSoA::mass).data();
+        auto* mult_ptr = soa.GetRealData(SuperDropletRealIdx::multiplicity).data();
+        auto* rad_ptr  = soa.GetRealData(SuperDropletRealIdx::radius).data();
+        auto* sol_ptr  = soa.GetRealData(SuperDropletRealIdx::solute_mass).data();
+
+        const Box& bx = pti.validbox();
+        auto cons_arr    = a_cons.const_array(grid);
+        auto detJ_arr    = (a_detJ) ? a_detJ->const_array(grid) : Array4<const Real>{};
+        auto counts_arr  = counts.const_array();
+        auto offsets_arr = offsets.const_array();
+        auto* perm_ptr   = perm.data();
+
+        ParallelForRNG(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k, RandomEngine const& engine) noexcept
+        {
+            const int nsd = counts_arr(i,j,k);
+            if (nsd < 2) return;
+            int* cell_perm = perm_ptr + offsets_arr(i,j,k);
+
+            // Random permutation of the superdroplets of the cell
+            for (int m = nsd-1; m > 0; --m) {
+                int l = static_cast<int>(Random_int(m+1, engine));
+                int tmp = cell_perm[m]; cell_perm[m] = cell_perm[l]; cell_perm[l] = tmp;
+            }
+
+            const int  npair = nsd/2;
+            const Real vol   = cell_vol * ((detJ_arr) ? detJ_arr(i,j,k) : 1.0);
+            const Real rho   = cons_arr(i,j,k,Rho_comp);
+            const Real scale = Real(nsd)*Real(nsd-1)/(2.0*npair) * a_dt/vol;
+
+            for (int m = 0; m < npair; ++m) {
+                int a = cell_perm[m];
+                int b = cell_perm[m+npair];
+                if (mult_ptr[a] < mult_ptr[b]) { int tmp = a; a = b; b = tmp; }
+                if (mult_ptr[b] < 1.0) continue;
+
+                Real ra = rad_ptr[a], rb = rad_ptr[b];
+                Real kernel = sd_collection_efficiency(ra, rb) * PI*(ra+rb)*(ra+rb)
+                            * std::abs(sd_terminal_velocity(ra,rho) - sd_terminal_velocity(rb,rho));
+                Real prob  = mult_ptr[a]*kernel*scale;
+                Real gamma = std::floor(prob);
+                if (Random(engine) < prob - gamma) gamma += 1.0;
+                if (gamma <= 0.0) continue;
+
+                // Each of the mult_ptr[b] droplets of b collects gamma droplets of a
+                Real mult_a = mult_ptr[a], sol_a = sol_ptr[a];
+                Real mult_b = mult_ptr[b], sol_b = sol_ptr[b];
+                sd_coalesce_pair(gamma, mult_a, ra, sol_a, mult_b, rb, sol_b);
+                mult_ptr[a] = mult_a; rad_ptr[a] = ra; sol_ptr[a] = sol_a;
+                mult_ptr[b] = mult_b; rad_ptr[b] = rb; sol_ptr[b] = sol_b;
+                mass_ptr[a] = mult_ptr[a]*sd_water_mass(rad_ptr[a], sol_ptr[a]);
+                mass_ptr[b] = mult_ptr[b]*sd_water_mass(rad_ptr[b], sol_ptr[b]);
+            }
+        });
+        Gpu::streamSynchronize();
+    }
+}
+
+/*! Keep the number of superdroplets adapted to the droplets they stand for:
+ *  superdroplets left with no droplets by coalescence are removed, and in cells
+ *  with fewer than a_min_per_cell superdroplets every one with a multiplicity of
+ *  at least two is split into two halves. */
+void SuperDropletPC::Adapt (int a_min_per_cell)
+{
+    BL_PROFILE("SuperDropletPC::Adapt()");
+
+    const int lev = 0;
+    const auto& geom = Geom(lev);
+    const auto plo = geom.ProbLoArray();
+    const auto dxi = geom.InvCellSizeArray();
+    const auto dlo = lbound(geom.Domain());
+
+    BaseFab<int> counts, offsets;
+    Gpu::DeviceVector<int> perm;
+
+    for (ParIterType pti(*this, lev); pti.isValid(); ++pti)
+    {
+        auto& ptile = ParticlesAt(lev, pti);
+
+        // Remove the superdroplets with no droplets left
+        {
+            auto& aos = ptile.GetArrayOfStructs();
+            auto& soa = ptile.GetStructOfArrays();
+            const int np = aos.numParticles();
+            auto* p_pbox   = aos().data();
+            auto* mult_ptr = soa.GetRealData(SuperDropletRealIdx::multiplicity).data();
+            ParallelFor(np, [=] AMREX_GPU_DEVICE (int n) noexcept
+            {
+                if (mult_ptr[n] < 1.0) p_pbox[n].id() = -1;
+            });
+        }
+
+        if (a_min_per_cell <= 0) continue;
+
+        SortByCell(pti, counts, offsets, perm);
+        auto counts_arr = counts.const_array();
+
+        const int np = ptile.numParticles();
+        Gpu::DeviceVector<int> split(np);
+        Gpu::DeviceVector<int> split_offset(np);
+        auto* split_ptr  = split.data();
+        auto* offset_ptr = split_offset.data();
+        {
+            auto* p_pbox   = ptile.GetArrayOfStructs()().data();
+            auto* mult_ptr = ptile.GetStructOfArrays().GetRealData(SuperDropletRealIdx::multiplicity).data();
+            ParallelFor(np, [=] AMREX_GPU_DEVICE (int n) noexcept
+            {
+                const auto& p = p_pbox[n];
+                split_ptr[n] = (p.id() > 0 && mult_ptr[n] >= 2.0 &&
+                                counts_arr(sd_cell(p, plo, dxi, dlo)) < a_min_per_cell) ? 1 : 0;
+            });
+        }
+        const int nsplit = Scan::PrefixSum<int>( np,
+                                                 [=] AMREX_GPU_DEVICE (int n) -> int { return split_ptr[n]; },
+                                                 [=] AMREX_GPU_DEVICE (int n, int const &x) { offset_ptr[n] = x; },
+                                                 Scan::Type::exclusive,
+                                                 Scan::retSum );
+        if (nsplit == 0) continue;
+
+        Long pid = ParticleType::NextID();
+        ParticleType::NextID(pid+nsplit);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE( static_cast<Long>(pid + nsplit) < LastParticleID,
+                                          "Error: overflow on particle id numbers!" );
+        const int my_proc = ParallelDescriptor::MyProc();
+
+        ptile.resize(np + nsplit);
+        auto* p_pbox = ptile.GetArrayOfStructs()().data();
+        auto& soa    = ptile.GetStructOfArrays();
+        GpuArray<ParticleReal*,SuperDropletRealIdx::ncomps> rdata;
+        for (int c = 0; c < SuperDropletRealIdx::ncomps; ++c) {
+            rdata[c] = soa.GetRealData(c).data();
+        }
+
+        ParallelFor(np, [=] AMREX_GPU_DEVICE (int n) noexcept
+        {
+            if (!split_ptr[n]) return;
+            const int m = np + offset_ptr[n];
+
+            p_pbox[m] = p_pbox[n];
+            p_pbox[m].id()  = pid + offset_ptr[n];
+            p_pbox[m].cpu() = my_proc;
+            for (int c = 0; c < SuperDropletRealIdx::ncomps; ++c) {
+                rdata[c][m] = rdata[c][n];
+            }
+
+            Real half = std::floor(0.5*rdata[SuperDropletRealIdx::multiplicity][n]);
+            Real rest = rdata[SuperDropletRealIdx::multiplicity][n] - half;
+            Real mass = rdata[ERFParticlesRealIdxSoA::mass][n];
+            rdata[SuperDropletRealIdx::multiplicity][m] = half;
+            rdata[SuperDropletRealIdx::multiplicity][n] = rest;
+            rdata[ERFParticlesRealIdxSoA::mass][m] = mass*half/(half+rest);
+            rdata[ERFParticlesRealIdxSoA::mass][n] = mass*rest/(half+rest);
+        });
+        Gpu::streamSynchronize();
+    }
+
+    Redistribute();
+}
+
+/*! Cloud water is the water of the droplets smaller than r_rain and rain the
+ *  water of the larger ones; both are written into the state as densities. */
+void SuperDropletPC::Deposit ( MultiFab& a_cons,
+                               const MultiFab* a_detJ ) const
+{
+    BL_PROFILE("SuperDropletPC::Deposit()");
+
+    const int lev = 0;
+    const auto& geom = Geom(lev);
+    const auto plo = geom.ProbLoArray();
+    const auto dx  = geom.CellSizeArray();
+    const auto dxi = geom.InvCellSizeArray();
+    const auto dlo = lbound(geom.Domain());
+    const Real cell_vol = dx[0]*dx[1]*dx[2];
+
+    for (MFIter mfi(a_cons); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        auto cons_arr = a_cons.array(mfi);
+        ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            cons_arr(i,j,k,RhoQ2_comp) = 0.0;
+            cons_arr(i,j,k,RhoQ3_comp) = 0.0;
+        });
+    }
+
+    for (ParConstIterType pti(*this, lev); pti.isValid(); ++pti)
+    {
+        int grid = pti.index();
+        const auto& ptile = ParticlesAt(lev, pti);
+        const auto& aos   = ptile.GetArrayOfStructs();
+        const auto& soa   = ptile.GetStructOfArrays();
+        const int np = aos.numParticles();
+        const auto* p_pbox = aos().data();
+
+        const auto* mass_ptr = soa.GetRealData(ERFParticlesRealIdxSoA::mass).data();
+        const auto* rad_ptr  = soa.GetRealData(SuperDropletRealIdx::radius).data();
+
+        auto cons_arr = a_cons.array(grid);
+        auto detJ_arr = (a_detJ) ? a_detJ->const_array(grid) : Array4<const Real>{};
+
+        ParallelFor(np, [=] AMREX_GPU_DEVICE (int n) noexcept
+        {
+            const auto& p = p_pbox[n];
+            if (p.id() <= 0) { return; }
+            IntVect iv = sd_cell(p, plo, dxi, dlo);
+            Real vol = cell_vol * ((detJ_arr) ? detJ_arr(iv) : 1.0);
+            int comp = (rad_ptr[n] < r_rain) ? RhoQ2_comp : RhoQ3_comp;
+            Gpu::Atomic::AddNoRet(&cons_arr(iv,comp), mass_ptr[n]/vol);
+        });
+    }
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include "SuperDroplets.H"
+
+#ifdef ERF_USE_PARTICLES
+
+#include "IndexDefines.H"
+
+using namespace amrex;
+
+/**
+ * Initializes the superdroplet model. The superdroplets are created and placed
+ * the first time; when level 0 is remade they are moved to the new grids.
+ *
+ * @param[in] cons_in Conserved variables input
+ * @param[in] grids The boxes on which we will evolve the solution
+ * @param[in] geom Geometry associated with these MultiFabs and grids
+ * @param[in] dt_advance Timestep for the advance
+ * @param[in] z_phys_nd Nodal z heights
+ * @param[in] detJ_cc Cell-centered Jacobian determinants
+ */
+void SuperDroplets::Init (const MultiFab& cons_in,
+                          const BoxArray& grids,
+                          const Geometry& geom,
+                          const Real& /*dt_advance*/,
+                          std::unique_ptr<MultiFab>& z_phys_nd,
+                          std::unique_ptr<MultiFab>& detJ_cc)
+{
+    m_geom    = geom;
+    m_detJ_cc = detJ_cc.get();
+
+    if (m_pc == nullptr) {
+        m_pc = new SuperDropletPC(geom, cons_in.DistributionMap(), grids, m_name);
+        m_pc->InitializeSuperDroplets(z_phys_nd);
+    } else {
+        m_pc->SetParGDB(geom, cons_in.DistributionMap(), grids);
+        m_pc->Redistribute();
+    }
+
+    // initialize diagnostic variables
+    for (auto ivar = 0; ivar < MicVar_SD::NumVars; ++ivar) {
+        mic_fab_vars[ivar] = std::make_shared<MultiFab>(cons_in.boxArray(), cons_in.DistributionMap(),
+                                                        1, cons_in.nGrowVect());
+        mic_fab_vars[ivar]->setVal(0.);
+    }
+}
+
+/**
+ * Sets the moisture diagnostics from the conserved variables.
+ *
+ * @param[in] cons_in Conserved variables input
+ */
+void SuperDroplets::Copy_State_to_Micro (const MultiFab& cons_in)
+{
+    for ( MFIter mfi(cons_in,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const auto& box3d = mfi.growntilebox();
+
+        auto states_array = cons_in.const_array(mfi);
+
+        auto qt_array = mic_fab_vars[MicVar_SD::qt]->array(mfi);
+        auto qv_array = mic_fab_vars[MicVar_SD::qv]->array(mfi);
+        auto qc_array = mic_fab_vars[MicVar_SD::qcl]->array(mfi);
+        auto qp_array = mic_fab_vars[MicVar_SD::qp]->array(mfi);
+
+        ParallelFor( box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
+        {
+            qv_array(i,j,k) = states_array(i,j,k,RhoQ1_comp)/states_array(i,j,k,Rho_comp);
+            qc_array(i,j,k) = states_array(i,j,k,RhoQ2_comp)/states_array(i,j,k,Rho_comp);
+            qp_array(i,j,k) = states_array(i,j,k,RhoQ3_comp)/states_array(i,j,k,Rho_comp);
+            qt_array(i,j,k) = qv_array(i,j,k) + qc_array(i,j,k);
+        });
+    }
+}
+
+/**
+ * The superdroplets have already written the vapor, heat, cloud and rain water
+ * into the conserved variables; refresh the diagnostics and the ghost cells.
+ *
+ * @param[in,out] cons Conserved variables
+ */
+void SuperDroplets::Update_State_Vars (MultiFab& cons)
+{
+    this->Copy_State_to_Micro(cons);
+
+    // Fill interior ghost cells and periodic boundaries
+    cons.FillBoundary(m_geom.periodicity());
+}
+
+/**
+ * Advances the superdroplets by one time step: transport and sedimentation,
+ * condensation, collision and coalescence, adaptation of their number, and
+ * finally deposition of their water into the conserved variables.
+ *
+ * @param[in] dt_advance Timestep for the advance
+ * @param[in,out] a_vars State variables of all levels; only level 0 is used
+ * @param[in] a_z Nodal z heights of all levels
+ */
+void SuperDroplets::Advance (const Real& dt_advance,
+                             const int& /*iter*/,
+                             const Real& /*time*/,
+                             Vector<Vector<MultiFab>>& a_vars,
+                             const Vector<std::unique_ptr<MultiFab>>& a_z)
+{
+    BL_PROFILE("SuperDroplets::Advance()");
+
+    const int lev = 0;
+    MultiFab& cons = a_vars[lev][Vars::cons];
+
+    m_pc->Transport(dt_advance, &a_vars[lev][Vars::xvel], cons,
+                    *mic_fab_vars[MicVar_SD::rain_accum], a_z[lev], m_detJ_cc);
+
+    if (docloud) {
+        m_pc->Condense(dt_advance, cons, m_detJ_cc);
+    }
+
+    if (doprecip) {
+        m_pc->Coalesce(dt_advance, cons, m_detJ_cc);
+    }
+
+    m_pc->Adapt(m_min_per_cell);
+
+    m_pc->Deposit(cons, m_detJ_cc);
+}
+
+#endif
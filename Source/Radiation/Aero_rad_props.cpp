@@ -13,7 +13,7 @@ void AerRadProps::initialize (int num_gas, int num_modes, int naeroes,
                               int nswbands_, int nlwbands_,
                               int ncoloum, int nlevel, int num_rh, int top_levels,
                               const std::vector<std::string>& aerosol_names,
-                              const real2d& zint, const real2d& pmiddle, const real2d& pint,
+                              const real2d& zint, const real2d& pmiddle, const real2d& pinterface,
                               const real2d& temperature, const real2d& qtotal,
                               const real2d& geom_rad)
 {
@@ -30,14 +30,11 @@ void AerRadProps::initialize (int num_gas, int num_modes, int naeroes,
     top_lev  = top_levels;
 
     // NOTE: pmid is absolute pressure but pdeldry is the vertical
-    //       change in pressure (analog to mass per area with HSE balance)
+    //       change in pressure (analog to mass per area with HSE balance);
+    //       both follow the state the caller gathers into pmid and pint
     pmid    = pmiddle;
-    pdeldry = pmiddle;
-    parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev)
-    {
-        // Pressure max at bottom of column
-        pdeldry(icol,ilev) = pmid(icol,ilev) -  pmid(icol,ilev+1);
-    });
+    pint    = pinterface;
+    pdeldry = real2d("pdeldry", ncol, nlev);
 
     temp = temperature;
     qt   = qtotal;
@@ -49,10 +46,23 @@ void AerRadProps::initialize (int num_gas, int num_modes, int naeroes,
     mam_aer.initialize(ncol, nlev, top_lev, nswbands, nlwbands);
 }
 
+void AerRadProps::compute_pdeldry ()
+{
+    auto pdeldry_loc = pdeldry;
+    auto pint_loc    = pint;
+    parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilev)
+    {
+        // Pressure max at bottom of column
+        pdeldry_loc(icol,ilev) = pint_loc(icol,ilev) - pint_loc(icol,ilev+1);
+    });
+}
+
 void AerRadProps::aer_rad_props_sw (const int& list_idx, const real& dt, const int& nnite,
                                     const int1d& idxnite, const bool is_cmip6_volc, const real3d& tau, const real3d& tau_w,
                                     const real3d& tau_w_g, const real3d& tau_w_f, const real2d& clear_rh)
 {
+    compute_pdeldry();
+
     // for cmip6 style volcanic file
     int1d trop_level("trop_level", ncol);
     real3d ext_cmip6_sw_inv_m("ext_cmip6_sw_inv_m", ncol, nlev, nswbands); // short wave extinction in the units of 1/m
@@ -304,6 +314,8 @@ void AerRadProps::aer_rad_props_lw (const bool& is_cmip6_volc,
                                     const real3d& odap_aer,
                                     const real2d& clear_rh)
 {
+    compute_pdeldry();
+
     int numaerosols; // number of bulk aerosols in climate/diagnostic list
     int nmodes;      // number of aerosol modes in climate/diagnostic list
     std::string opticstype;  // hygro or nonhygro
@@ -17,7 +17,11 @@ void Optics::initialize (int ngas, int nmodes, int num_aeros,
                          const real2d& temp, const real2d& qi,
                          const real2d& geom_radius)
 {
-    cloud_optics.initialize();
+    // The cloud optics tables do not depend on the grid, so they are only read once
+    if (!cloud_optics) {
+        cloud_optics = std::make_shared<CloudRadProps>();
+        cloud_optics->initialize();
+    }
     aero_optics.initialize(ngas, nmodes, num_aeros,
                            nswbands, nlwbands, ncol, nlev, nrh, top_lev,
                            aero_names, zi, pmid, pint, temp, qi, geom_radius);
@@ -87,7 +91,7 @@ void Optics::get_cloud_optics_sw (int ncol, int nlev, int nbnd,
 
     // Get ice cloud optics
     if (icecldoptics == "mitchell") {
-        cloud_optics.mitchell_ice_optics_sw(ncol, nlev, iciwp, dei,
+        cloud_optics->mitchell_ice_optics_sw(ncol, nlev, iciwp, dei,
                                             ice_tau, ice_tau_ssa,
                                             ice_tau_ssa_g, ice_tau_ssa_f);
     }
@@ -99,7 +103,7 @@ void Optics::get_cloud_optics_sw (int ncol, int nlev, int nbnd,
 
     // Get liquid cloud optics
     if (liqcldoptics == "gammadist") {
-        cloud_optics.gammadist_liq_optics_sw(ncol, nlev, iclwp, lambdac, mu,
+        cloud_optics->gammadist_liq_optics_sw(ncol, nlev, iclwp, lambdac, mu,
                                              liq_tau, liq_tau_ssa,
                                              liq_tau_ssa_g, liq_tau_ssa_f);
     }
@@ -111,7 +115,7 @@ void Optics::get_cloud_optics_sw (int ncol, int nlev, int nbnd,
 
     // Get snow cloud optics
     if (do_snow) {
-        cloud_optics.mitchell_ice_optics_sw(ncol, nlev, icswp, des,
+        cloud_optics->mitchell_ice_optics_sw(ncol, nlev, icswp, des,
                                             snow_tau, snow_tau_ssa,
                                             snow_tau_ssa_g, snow_tau_ssa_f);
     }
@@ -205,7 +209,7 @@ void Optics::get_cloud_optics_lw (int ncol, int nlev, int nbnd, bool do_snow, co
 
     // Get ice optics
     if (icecldoptics == "mitchell") {
-        cloud_optics.mitchell_ice_optics_lw(ncol, nlev, iciwp, dei, ice_tau);
+        cloud_optics->mitchell_ice_optics_lw(ncol, nlev, iciwp, dei, ice_tau);
     }
     else if (icecldoptics == "ebertcurry") {
         EbertCurry::ec_ice_optics_lw(ncol, nlev, nbnd, cld, iclwp, iciwp, rei, ice_tau);
@@ -213,7 +217,7 @@ void Optics::get_cloud_optics_lw (int ncol, int nlev, int nbnd, bool do_snow, co
 
     // Get liquid optics
     if (liqcldoptics == "gammadist") {
-        cloud_optics.gammadist_liq_optics_lw(ncol, nlev, iclwp, lambdac, mu, liq_tau);
+        cloud_optics->gammadist_liq_optics_lw(ncol, nlev, iclwp, lambdac, mu, liq_tau);
     }
     else if (liqcldoptics == "slingo") {
         Slingo::slingo_liq_optics_lw(ncol, nlev, nbnd, cld, iclwp, iciwp, liq_tau);
@@ -227,7 +231,7 @@ void Optics::get_cloud_optics_lw (int ncol, int nlev, int nbnd, bool do_snow, co
 
     // Get snow optics?
     if (do_snow) {
-        cloud_optics.mitchell_ice_optics_lw(ncol, nlev, icswp, des, snow_tau);
+        cloud_optics->mitchell_ice_optics_lw(ncol, nlev, icswp, des, snow_tau);
         combine_properties(nbnd, ncol, nlev,
                            cld, cld_tau, cldfsnow, snow_tau, combined_tau);
     }
@@ -18,6 +18,7 @@
 #include "Radiation.H"
 #include "m2005_effradius.H"
 #include <AMReX_GpuContainers.H>
+#include <AMReX_Scan.H>
 #include <AMReX_FArrayBox.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_TableData.H>
@@ -48,35 +49,42 @@ namespace internal {
         fluxes.bnd_flux_dn_dir = real3d("flux_dn_dir", nz, nlay+1, nbands);
     }
 
+    void reset_fluxes (FluxesByband& fluxes)
+    {
+        yakl::memset(fluxes.flux_up    , 0.);
+        yakl::memset(fluxes.flux_dn    , 0.);
+        yakl::memset(fluxes.flux_net   , 0.);
+        yakl::memset(fluxes.flux_dn_dir, 0.);
+
+        yakl::memset(fluxes.bnd_flux_up    , 0.);
+        yakl::memset(fluxes.bnd_flux_dn    , 0.);
+        yakl::memset(fluxes.bnd_flux_net   , 0.);
+        yakl::memset(fluxes.bnd_flux_dn_dir, 0.);
+    }
+
+    // Scatter the fluxes of the nday daytime columns back to their columns; the
+    // nighttime columns get zero
     void expand_day_fluxes (const FluxesByband& daytime_fluxes,
                             FluxesByband& expanded_fluxes,
-                            const int1d& day_indices)
+                            const int1d& day_indices, int nday)
     {
-        auto ncol  = size(daytime_fluxes.bnd_flux_up, 1);
         auto nlev  = size(daytime_fluxes.bnd_flux_up, 2);
         auto nbnds = size(daytime_fluxes.bnd_flux_up, 3);
 
-        int1d nday_1d("nday_1d", 1),nday_host("nday_host",1);
-        yakl::memset(nday_1d, 0);
-        parallel_for(SimpleBounds<1>(ncol), YAKL_LAMBDA (int icol)
-        {
-            if (day_indices(icol) > 0) nday_1d(1)++;
-            //printf("daynight indices(check): %d, %d, %d\n",icol,day_indices(icol),nday_1d(1));
-        });
+        reset_fluxes(expanded_fluxes);
 
-        nday_1d.deep_copy_to(nday_host);
-        auto nday = nday_host(1);
-        AMREX_ASSERT_WITH_MESSAGE((nday>0) && (nday<=ncol), "RADIATION: Invalid number of days!");
         parallel_for(SimpleBounds<3>(nday, nlev, nbnds), YAKL_LAMBDA (int iday, int ilev, int ibnd)
         {
             // Map daytime index to proper column index
             auto icol = day_indices(iday);
-            //auto icol = iday;
+
             // Expand broadband fluxes
-            expanded_fluxes.flux_up(icol,ilev)     = daytime_fluxes.flux_up(iday,ilev);
-            expanded_fluxes.flux_dn(icol,ilev)     = daytime_fluxes.flux_dn(iday,ilev);
-            expanded_fluxes.flux_net(icol,ilev)    = daytime_fluxes.flux_net(iday,ilev);
-            expanded_fluxes.flux_dn_dir(icol,ilev) = daytime_fluxes.flux_dn_dir(iday,ilev);
+            if (ibnd == 1) {
+                expanded_fluxes.flux_up(icol,ilev)     = daytime_fluxes.flux_up(iday,ilev);
+                expanded_fluxes.flux_dn(icol,ilev)     = daytime_fluxes.flux_dn(iday,ilev);
+                expanded_fluxes.flux_net(icol,ilev)    = daytime_fluxes.flux_net(iday,ilev);
+                expanded_fluxes.flux_dn_dir(icol,ilev) = daytime_fluxes.flux_dn_dir(iday,ilev);
+            }
 
             // Expand band-by-band fluxes
             expanded_fluxes.bnd_flux_up(icol,ilev,ibnd)     = daytime_fluxes.bnd_flux_up(iday,ilev,ibnd);
@@ -86,6 +94,17 @@ namespace internal {
         });
     }
 
+    // Monotonized central slope of a column value between its neighbours
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real mc_slope (Real left, Real center, Real right)
+    {
+        Real dl = center - left;
+        Real dr = right - center;
+        if (dl*dr <= 0.0) return 0.0;
+        Real dc = 0.5*(right - left);
+        return std::copysign(amrex::min(std::abs(dc), 2.0*std::abs(dl), 2.0*std::abs(dr)), dc);
+    }
+
     // Utility function to reorder an array given a new indexing
     void reordered (const real1d& array_in, const int1d& new_indexing, const real1d& array_out)
     {
@@ -97,45 +116,20 @@ namespace internal {
     }
 }
 
-// init
-void Radiation::initialize (const MultiFab& cons_in,
-                            MultiFab* lsm_fluxes,
-                            MultiFab* lsm_zenith,
-                            MultiFab* qheating_rates,
-                            MultiFab* lat,
-                            MultiFab* lon,
-                            Vector<MultiFab*> qmoist,
-                            const BoxArray& grids,
-                            const Geometry& geom,
-                            const Real& dt_advance,
-                            const bool& do_sw_rad,
+// One-time setup: read the options and load the k-distributions
+void Radiation::initialize (const bool& do_sw_rad,
                             const bool& do_lw_rad,
                             const bool& do_aero_rad,
                             const bool& do_snow_opt,
-                            const bool& is_cmip6_volcano)
+                            const bool& is_cmip6_volcano,
+                            const Radiation* shared)
 {
-    m_geom = geom;
-    m_box = grids;
-
-    qrad_src = qheating_rates;
-
-    auto dz   = m_geom.CellSize(2);
-    auto lowz = m_geom.ProbLo(2);
-
-    dt = dt_advance;
-
     do_short_wave_rad = do_sw_rad;
     do_long_wave_rad  = do_lw_rad;
     do_aerosol_rad    = do_aero_rad;
     do_snow_optics    = do_snow_opt;
     is_cmip6_volc     = is_cmip6_volcano;
 
-    m_lat = lat;
-    m_lon = lon;
-
-    m_lsm_fluxes = lsm_fluxes;
-    m_lsm_zenith = lsm_zenith;
-
     rrtmgp_data_path = getRadiationDataDir() + "/";
     rrtmgp_coefficients_file_sw = rrtmgp_data_path + rrtmgp_coefficients_file_name_sw;
     rrtmgp_coefficients_file_lw = rrtmgp_data_path + rrtmgp_coefficients_file_name_lw;
@@ -143,25 +137,30 @@ void Radiation::initialize (const MultiFab& cons_in,
     ParmParse pp("erf");
     pp.query("fixed_total_solar_irradiance", fixed_total_solar_irradiance);
     pp.query("radiation_uniform_angle"     , uniform_angle);
-
-    for ( MFIter mfi(cons_in, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-        const auto& box3d = mfi.tilebox();
-        nlev = box3d.length(2);
-        ncol = box3d.length(0)*box3d.length(1);
-    }
+    pp.query("radiation_coarsen"           , m_coarsen);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_coarsen >= 1 && m_coarsen <= 8,
+                                     "erf.radiation_coarsen must be between 1 and 8");
 
     ngas = active_gases.size();
 
-    // initialize cloud, aerosol, and radiation
-    radiation.initialize(ngas, active_gases,
-                         rrtmgp_coefficients_file_sw.c_str(),
-                         rrtmgp_coefficients_file_lw.c_str());
+    // The k-distributions and cloud optics tables do not depend on the grid; load them
+    // once and share them with the objects of the other levels
+    const bool load_tables = !(shared && shared->is_initialized());
+    if (load_tables) {
+        radiation = std::make_shared<Rrtmgp>();
+        radiation->initialize(ngas, active_gases,
+                              rrtmgp_coefficients_file_sw.c_str(),
+                              rrtmgp_coefficients_file_lw.c_str());
+    } else {
+        radiation = shared->radiation;
+        optics.set_cloud_props(shared->optics.get_cloud_props());
+    }
 
     // initialize the radiation data
-    nswbands = radiation.get_nband_sw();
-    nswgpts  = radiation.get_ngpt_sw();
-    nlwbands = radiation.get_nband_lw();
-    nlwgpts  = radiation.get_ngpt_lw();
+    nswbands = radiation->get_nband_sw();
+    nswgpts  = radiation->get_ngpt_sw();
+    nlwbands = radiation->get_nband_lw();
+    nlwgpts  = radiation->get_ngpt_lw();
 
     rrtmg_to_rrtmgp = int1d("rrtmg_to_rrtmgp",14);
     parallel_for(14, YAKL_LAMBDA (int i)
@@ -173,6 +172,22 @@ void Radiation::initialize (const MultiFab& cons_in,
         }
     });
 
+    if (load_tables) {
+        amrex::Print() << "LW coefficients file: " << rrtmgp_coefficients_file_lw
+                       << "\nSW coefficients file: " << rrtmgp_coefficients_file_sw
+                       << "\nDo aerosol radiative calculations: " << do_aerosol_rad
+                       << "\nHorizontal coarsening of the radiation columns: " << m_coarsen << std::endl;
+    }
+
+    m_initialized = true;
+}
+
+// (Re)allocate the column buffers and the aerosol optics that are sized with them
+void Radiation::resize_buffers (int ncol_in, int nlev_in)
+{
+    ncol = ncol_in;
+    nlev = nlev_in;
+
     tmid = real2d("tmid", ncol, nlev);
     pmid = real2d("pmid", ncol, nlev);
     pdel = real2d("pdel", ncol, nlev);
@@ -186,10 +201,100 @@ void Radiation::initialize (const MultiFab& cons_in,
     qn   = real2d("qn", ncol, nlev);
     zi   = real2d("zi", ncol, nlev);
 
+    col_lat = real1d("col_lat", ncol);
+    col_lon = real1d("col_lon", ncol);
+
+    albedo_dir = real2d("albedo_dir", nswbands, ncol);
+    albedo_dif = real2d("albedo_dif", nswbands, ncol);
+
+    qrs = real2d("qrs", ncol, nlev);   // shortwave radiative heating rate
+    qrl = real2d("qrl", ncol, nlev);   // longwave  radiative heating rate
+
+    // Clear-sky heating rates are not on the physics buffer, and we have no
+    // reason to put them there, so declare these are regular arrays here
+    qrsc = real2d("qrsc", ncol, nlev);
+    qrlc = real2d("qrlc", ncol, nlev);
+
+    int nmodes = 3;
+    int nrh = 1;
+    int top_lev = 1;
+    naer = 4;
+    std::vector<std::string> aero_names {"H2O", "N2", "O2", "O3"};
+    auto geom_radius = real2d("geom_radius", ncol, nlev);
+    yakl::memset(geom_radius, 0.1);
+
+    // The aerosol optics keep references to these buffers, so they see
+    // the state gathered into them on every call
+    optics.initialize(ngas, nmodes, naer, nswbands, nlwbands,
+                      ncol, nlev, nrh, top_lev, aero_names, zi,
+                      pmid, pint, tmid, qt, geom_radius);
+}
+
+// Per-call update: gather the state into the column buffers
+void Radiation::set_state (const MultiFab& cons_in,
+                           MultiFab* lsm_fluxes,
+                           MultiFab* lsm_zenith,
+                           MultiFab* qheating_rates,
+                           MultiFab* lat,
+                           MultiFab* lon,
+                           Vector<MultiFab*> qmoist,
+                           const BoxArray& grids,
+                           const Geometry& geom,
+                           const Real& dt_advance)
+{
+    AMREX_ALWAYS_ASSERT(m_initialized);
+
+    m_geom = geom;
+    m_box = grids;
+
+    qrad_src = qheating_rates;
+
+    auto dz   = m_geom.CellSize(2);
+    auto lowz = m_geom.ProbLo(2);
+
+    dt = dt_advance;
+
+    m_lat = lat;
+    m_lon = lon;
+
+    m_lsm_fluxes = lsm_fluxes;
+    m_lsm_zenith = lsm_zenith;
+
+    // Each radiation column is the average of r x r columns of the grid, and the
+    // columns of all local boxes are packed one box after the other.  A column runs
+    // from the surface to the model top, so every box must span the whole domain in z
+    const int r = m_coarsen;
+    const Box& domain = m_geom.Domain();
+
+    int ncol_new = 0, nlev_new = 0;
+    m_col_offset.resize(cons_in.local_size());
+    for (MFIter mfi(cons_in); mfi.isValid(); ++mfi) {
+        const auto& box3d = mfi.validbox();
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(box3d.coarsenable(IntVect(r,r,1)),
+                                         "Radiation: box sizes and lower corners must be multiples of erf.radiation_coarsen");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(box3d.smallEnd(2) == domain.smallEnd(2) &&
+                                         box3d.bigEnd(2)   == domain.bigEnd(2),
+                                         "Radiation: boxes must span the whole vertical extent of the domain");
+        nlev_new = box3d.length(2);
+        m_col_offset[mfi.LocalIndex()] = ncol_new;
+        ncol_new += (box3d.length(0)/r)*(box3d.length(1)/r);
+    }
+
+    // The buffers only change size when the grids do
+    if (ncol_new != ncol || nlev_new != nlev) {
+        resize_buffers(ncol_new, nlev_new);
+    }
+
+    // A rank without boxes has nothing to compute
+    if (ncol == 0) return;
+
     // Get the temperature, density, theta, qt and qp from input
     for (MFIter mfi(cons_in); mfi.isValid(); ++mfi) {
-        const auto& box3d = mfi.tilebox();
-        auto nx = box3d.length(0);
+        const auto& box3d = mfi.validbox();
+        const auto& cbox  = amrex::coarsen(box3d, IntVect(r,r,1));
+        const auto  clo   = lbound(cbox);
+        auto ncx = cbox.length(0);
+        auto off = m_col_offset[mfi.LocalIndex()];
 
         auto states_array = cons_in.array(mfi);
         auto qt_array = (qmoist[0]) ? qmoist[0]->array(mfi) : Array4<Real> {};
@@ -197,22 +302,65 @@ void Radiation::initialize (const MultiFab& cons_in,
         auto qc_array = (qmoist[2]) ? qmoist[2]->array(mfi) : Array4<Real> {};
         auto qi_array = (qmoist.size()>=8) ? qmoist[3]->array(mfi) : Array4<Real> {};
 
+        const Real inv_area = 1.0 / (r*r);
+
         // Get pressure, theta, temperature, density, and qt, qp
-        ParallelFor(box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
+        ParallelFor(cbox, [=] AMREX_GPU_DEVICE (int ic, int jc, int k)
         {
-            auto icol = j*nx+i+1;
-            auto ilev = k+1;
-            Real qv         = (qv_array) ? qv_array(i,j,k): 0.0;
-            qt(icol,ilev)   = (qt_array) ? qt_array(i,j,k): 0.0;
-            qc(icol,ilev)   = (qc_array) ? qc_array(i,j,k): 0.0;
-            qi(icol,ilev)   = (qi_array) ? qi_array(i,j,k): 0.0;
+            auto icol = off + (jc-clo.y)*ncx + (ic-clo.x) + 1;
+            auto ilev = k-clo.z+1;
+            Real qt_sum(0.0), qc_sum(0.0), qi_sum(0.0), t_sum(0.0), p_sum(0.0);
+            for (int j = jc*r; j < (jc+1)*r; ++j) {
+                for (int i = ic*r; i < (ic+1)*r; ++i) {
+                    Real qv = (qv_array) ? qv_array(i,j,k): 0.0;
+                    qt_sum += (qt_array) ? qt_array(i,j,k): 0.0;
+                    qc_sum += (qc_array) ? qc_array(i,j,k): 0.0;
+                    qi_sum += (qi_array) ? qi_array(i,j,k): 0.0;
+                    t_sum  += getTgivenRandRTh(states_array(i,j,k,Rho_comp),states_array(i,j,k,RhoTheta_comp),qv);
+                    // NOTE: RRTMGP code expects pressure in pa
+                    p_sum  += getPgivenRTh(states_array(i,j,k,RhoTheta_comp),qv);
+                }
+            }
+            qt(icol,ilev)   = qt_sum * inv_area;
+            qc(icol,ilev)   = qc_sum * inv_area;
+            qi(icol,ilev)   = qi_sum * inv_area;
             qn(icol,ilev)   = qc(icol,ilev) + qi(icol,ilev);
-            tmid(icol,ilev) = getTgivenRandRTh(states_array(i,j,k,Rho_comp),states_array(i,j,k,RhoTheta_comp),qv);
-            // NOTE: RRTMGP code expects pressure in pa
-            pmid(icol,ilev) = getPgivenRTh(states_array(i,j,k,RhoTheta_comp),qv);
+            tmid(icol,ilev) = t_sum * inv_area;
+            pmid(icol,ilev) = p_sum * inv_area;
         });
     }
 
+    // Position of the columns for the solar zenith angle; lat/lon are 2D multifabs
+    // on the same boxes as the state
+    if (m_lat) {
+        for (MFIter mfi(*m_lat); mfi.isValid(); ++mfi) {
+            const auto& cbox  = amrex::coarsen(mfi.validbox(), IntVect(r,r,1));
+            const auto  clo   = lbound(cbox);
+            auto ncx = cbox.length(0);
+            auto off = m_col_offset[mfi.LocalIndex()];
+
+            auto lat_array = m_lat->array(mfi);
+            auto lon_array = m_lon->array(mfi);
+            auto lat_col = col_lat;
+            auto lon_col = col_lon;
+
+            const Real inv_area = 1.0 / (r*r);
+            ParallelFor(cbox, [=] AMREX_GPU_DEVICE (int ic, int jc, int k)
+            {
+                auto icol = off + (jc-clo.y)*ncx + (ic-clo.x) + 1;
+                Real lat_sum(0.0), lon_sum(0.0);
+                for (int j = jc*r; j < (jc+1)*r; ++j) {
+                    for (int i = ic*r; i < (ic+1)*r; ++i) {
+                        lat_sum += lat_array(i,j,k);
+                        lon_sum += lon_array(i,j,k);
+                    }
+                }
+                lat_col(icol) = lat_sum * inv_area;
+                lon_col(icol) = lon_sum * inv_area;
+            });
+        }
+    }
+
     parallel_for(SimpleBounds<2>(ncol, nlev+1), YAKL_LAMBDA (int icol, int ilev)
     {
         if (ilev == 1) {
@@ -232,42 +380,15 @@ void Radiation::initialize (const MultiFab& cons_in,
         zi(icol, ilev)  = lowz + (ilev+0.5)*dz;
         pdel(icol,ilev) = pint(icol,ilev+1) - pint(icol,ilev);
     });
-
-    albedo_dir = real2d("albedo_dir", nswbands, ncol);
-    albedo_dif = real2d("albedo_dif", nswbands, ncol);
-
-    qrs = real2d("qrs", ncol, nlev);   // shortwave radiative heating rate
-    qrl = real2d("qrl", ncol, nlev);   // longwave  radiative heating rate
-
-    // Clear-sky heating rates are not on the physics buffer, and we have no
-    // reason to put them there, so declare these are regular arrays here
-    qrsc = real2d("qrsc", ncol, nlev);
-    qrlc = real2d("qrlc", ncol, nlev);
-
-    int nmodes = 3;
-    int nrh = 1;
-    int top_lev = 1;
-    naer = 4;
-    std::vector<std::string> aero_names {"H2O", "N2", "O2", "O3"};
-    auto geom_radius = real2d("geom_radius", ncol, nlev);
-    yakl::memset(geom_radius, 0.1);
-
-    optics.initialize(ngas, nmodes, naer, nswbands, nlwbands,
-                      ncol, nlev, nrh, top_lev, aero_names, zi,
-                      pmid, pint, tmid, qt, geom_radius);
-
-    amrex::Print() << "LW coefficients file: " << rrtmgp_coefficients_file_lw
-                   << "\nSW coefficients file: " << rrtmgp_coefficients_file_sw
-                   << "\nFrequency (timesteps) of Shortwave Radiation calc: " << dt
-                   << "\nFrequency (timesteps) of Longwave Radiation calc:  " << dt
-                   << "\nDo aerosol radiative calculations: " << do_aerosol_rad << std::endl;
-
 }
 
 
 // run radiation model
 void Radiation::run ()
 {
+    // A rank without boxes has nothing to compute
+    if (ncol == 0) return;
+
     // Cosine solar zenith angle for all columns in chunk
     real1d coszrs("coszrs", ncol);
 
@@ -309,7 +430,6 @@ void Radiation::run ()
     real3d gas_vmr("gas_vmr", ngas, ncol, nlev);
 
     // Needed for shortwave aerosol;
-    //int nday, nnight;     // Number of daylight columns
     int1d day_indices("day_indices", ncol), night_indices("night_indices", ncol);   // Indices of daylight coumns
 
     // Flag to carry (QRS,QRL)*dp across time steps.
@@ -325,6 +445,21 @@ void Radiation::run ()
     int1d gpoint_bands_sw("gpoint_bands_sw", nswgpts);
     int1d gpoint_bands_lw("gpoint_bands_lw", nlwgpts);
 
+    // Cloud properties, shared by the shortwave and the longwave
+    // set cloud fraction to be 1, and snow fraction 0
+    yakl::memset(cldfsnow, 0.0);
+    yakl::memset(cld, 1.0);
+
+    parallel_for (SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int i, int k)
+    {
+        iciwp(i,k) = std::min(qi(i,k)/std::max(1.0e-4,cld(i,k)),0.005)*pmid(i,k)/CONST_GRAV;
+        iclwp(i,k) = std::min(qt(i,k)/std::max(1.0e-4,cld(i,k)),0.005)*pmid(i,k)/CONST_GRAV;
+        icswp(i,k) = qn(i,k)/std::max(1.0e-4,cldfsnow(i,k))*pmid(i,k)/CONST_GRAV;
+    });
+
+    m2005_effradius(qc, qc, qi, qi, qt, qt, cld, pmid, tmid,
+                    rel, rei, dei, lambdac, mu, des);
+
     // Do shortwave stuff...
     if (do_short_wave_rad) {
         // Radiative fluxes
@@ -336,151 +471,136 @@ void Radiation::run ()
         int calday = 1;
         // Get cosine solar zenith angle for current time step.
         if (m_lat) {
-            zenith(calday, m_lat, m_lon, coszrs, ncol,
+            zenith(calday, col_lat, col_lon, coszrs, ncol,
                    eccen,  mvelpp, lambm0, obliqr);
         } else {
-            zenith(calday, m_lat, m_lon, coszrs, ncol,
+            zenith(calday, real1d(), real1d(), coszrs, ncol,
                    eccen,  mvelpp, lambm0, obliqr, uniform_angle);
         }
 
-        // Get albedo. This uses CAM routines internally and just provides a
-        // wrapper to improve readability of the code here.
-        set_albedo(coszrs, albedo_dir, albedo_dif);
-
-        // Do shortwave cloud optics calculations
-        yakl::memset(cld_tau_gpt_sw, 0.);
-        yakl::memset(cld_ssa_gpt_sw, 0.);
-        yakl::memset(cld_asm_gpt_sw, 0.);
+        // Gather night/day column indices; the shortwave is only computed on the
+        // daytime columns, and not at all when the whole rank is in night
+        int nday = set_daynight_indices(coszrs, day_indices, night_indices);
 
-        // set cloud fraction to be 1, and snow fraction 0
-        yakl::memset(cldfsnow, 0.0);
-        yakl::memset(cld, 1.0);
+        if (nday == 0) {
+            internal::reset_fluxes(fluxes_allsky);
+            internal::reset_fluxes(fluxes_clrsky);
+            yakl::memset(qrs, 0.);
+            yakl::memset(qrsc, 0.);
+        } else {
+            // Get albedo. This uses CAM routines internally and just provides a
+            // wrapper to improve readability of the code here.
+            set_albedo(coszrs, albedo_dir, albedo_dif);
+
+            // Do shortwave cloud optics calculations
+            yakl::memset(cld_tau_gpt_sw, 0.);
+            yakl::memset(cld_ssa_gpt_sw, 0.);
+            yakl::memset(cld_asm_gpt_sw, 0.);
+
+            // calculate the cloud radiation
+            optics.get_cloud_optics_sw(ncol, nlev, nswbands, do_snow_optics, cld,
+                                       cldfsnow, iclwp, iciwp, icswp,
+                                       lambdac, mu, dei, des, rel, rei,
+                                       cld_tau_bnd_sw, cld_ssa_bnd_sw, cld_asm_bnd_sw,
+                                       liq_tau_bnd_sw, ice_tau_bnd_sw, snw_tau_bnd_sw);
+
+            // Now reorder bands to be consistent with RRTMGP
+            // We need to fix band ordering because the old input files assume RRTMG
+            // band ordering, but this has changed in RRTMGP.
+            // TODO: fix the input files themselves!
+            real1d cld_tau_bnd_sw_1d("cld_tau_bnd_sw_1d", nswbands);
+            real1d cld_ssa_bnd_sw_1d("cld_ssa_bnd_sw_1d", nswbands);
+            real1d cld_asm_bnd_sw_1d("cld_asm_bnd_sw_1d", nswbands);
+            real1d cld_tau_bnd_sw_o_1d("cld_tau_bnd_sw_1d", nswbands);
+            real1d cld_ssa_bnd_sw_o_1d("cld_ssa_bnd_sw_1d", nswbands);
+            real1d cld_asm_bnd_sw_o_1d("cld_asm_bnd_sw_1d", nswbands);
+
+            parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilay)
+            {
+                for (auto ibnd = 1; ibnd <= nswbands; ++ibnd) {
+                    cld_tau_bnd_sw_1d(ibnd) = cld_tau_bnd_sw(icol,ilay,ibnd);
+                    cld_ssa_bnd_sw_1d(ibnd) = cld_ssa_bnd_sw(icol,ilay,ibnd);
+                    cld_asm_bnd_sw_1d(ibnd) = cld_asm_bnd_sw(icol,ilay,ibnd);
+                }
+                internal::reordered(cld_tau_bnd_sw_1d, rrtmg_to_rrtmgp, cld_tau_bnd_sw_o_1d);
+                internal::reordered(cld_ssa_bnd_sw_1d, rrtmg_to_rrtmgp, cld_ssa_bnd_sw_o_1d);
+                internal::reordered(cld_asm_bnd_sw_1d, rrtmg_to_rrtmgp, cld_asm_bnd_sw_o_1d);
+                for (auto ibnd = 1; ibnd <= nswbands; ++ibnd) {
+                    cld_tau_bnd_sw(icol,ilay,ibnd) = cld_tau_bnd_sw_o_1d(ibnd);
+                    cld_ssa_bnd_sw(icol,ilay,ibnd) = cld_ssa_bnd_sw_o_1d(ibnd);
+                    cld_asm_bnd_sw(icol,ilay,ibnd) = cld_asm_bnd_sw_o_1d(ibnd);
+                }
+            });
 
-        parallel_for (SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int i, int k)
-        {
-            iciwp(i,k) = std::min(qi(i,k)/std::max(1.0e-4,cld(i,k)),0.005)*pmid(i,k)/CONST_GRAV;
-            iclwp(i,k) = std::min(qt(i,k)/std::max(1.0e-4,cld(i,k)),0.005)*pmid(i,k)/CONST_GRAV;
-            icswp(i,k) = qn(i,k)/std::max(1.0e-4,cldfsnow(i,k))*pmid(i,k)/CONST_GRAV;
-        });
+            // And now do the MCICA sampling to get cloud optical properties by
+            // gpoint/cloud state
+            radiation->get_gpoint_bands_sw(gpoint_bands_sw);
 
-        m2005_effradius(qc, qc, qi, qi, qt, qt, cld, pmid, tmid,
-                        rel, rei, dei, lambdac, mu, des);
-
-        // calculate the cloud radiation
-        optics.get_cloud_optics_sw(ncol, nlev, nswbands, do_snow_optics, cld,
-                                   cldfsnow, iclwp, iciwp, icswp,
-                                   lambdac, mu, dei, des, rel, rei,
-                                   cld_tau_bnd_sw, cld_ssa_bnd_sw, cld_asm_bnd_sw,
-                                   liq_tau_bnd_sw, ice_tau_bnd_sw, snw_tau_bnd_sw);
-
-        // Now reorder bands to be consistent with RRTMGP
-        // We need to fix band ordering because the old input files assume RRTMG
-        // band ordering, but this has changed in RRTMGP.
-        // TODO: fix the input files themselves!
-        real1d cld_tau_bnd_sw_1d("cld_tau_bnd_sw_1d", nswbands);
-        real1d cld_ssa_bnd_sw_1d("cld_ssa_bnd_sw_1d", nswbands);
-        real1d cld_asm_bnd_sw_1d("cld_asm_bnd_sw_1d", nswbands);
-        real1d cld_tau_bnd_sw_o_1d("cld_tau_bnd_sw_1d", nswbands);
-        real1d cld_ssa_bnd_sw_o_1d("cld_ssa_bnd_sw_1d", nswbands);
-        real1d cld_asm_bnd_sw_o_1d("cld_asm_bnd_sw_1d", nswbands);
-
-        parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilay)
-        {
-            for (auto ibnd = 1; ibnd <= nswbands; ++ibnd) {
-                cld_tau_bnd_sw_1d(ibnd) = cld_tau_bnd_sw(icol,ilay,ibnd);
-                cld_ssa_bnd_sw_1d(ibnd) = cld_ssa_bnd_sw(icol,ilay,ibnd);
-                cld_asm_bnd_sw_1d(ibnd) = cld_asm_bnd_sw(icol,ilay,ibnd);
-            }
-            internal::reordered(cld_tau_bnd_sw_1d, rrtmg_to_rrtmgp, cld_tau_bnd_sw_o_1d);
-            internal::reordered(cld_ssa_bnd_sw_1d, rrtmg_to_rrtmgp, cld_ssa_bnd_sw_o_1d);
-            internal::reordered(cld_asm_bnd_sw_1d, rrtmg_to_rrtmgp, cld_asm_bnd_sw_o_1d);
-            for (auto ibnd = 1; ibnd <= nswbands; ++ibnd) {
-                cld_tau_bnd_sw(icol,ilay,ibnd) = cld_tau_bnd_sw_o_1d(ibnd);
-                cld_ssa_bnd_sw(icol,ilay,ibnd) = cld_ssa_bnd_sw_o_1d(ibnd);
-                cld_asm_bnd_sw(icol,ilay,ibnd) = cld_asm_bnd_sw_o_1d(ibnd);
-            }
-        });
+            optics.sample_cloud_optics_sw(ncol, nlev, nswgpts, gpoint_bands_sw,
+                                          pmid, cld, cldfsnow,
+                                          cld_tau_bnd_sw, cld_ssa_bnd_sw, cld_asm_bnd_sw,
+                                          cld_tau_gpt_sw, cld_ssa_gpt_sw, cld_asm_gpt_sw);
 
-        // And now do the MCICA sampling to get cloud optical properties by
-        // gpoint/cloud state
-        radiation.get_gpoint_bands_sw(gpoint_bands_sw);
+            // get aerosol optics
+            do_aerosol_rad = true;
+            {
+                // Get gas concentrations
+                get_gas_vmr(active_gases, gas_vmr);
+
+                // Get aerosol optics
+                if (do_aerosol_rad) {
+                    yakl::memset(aer_tau_bnd_sw, 0.);
+                    yakl::memset(aer_ssa_bnd_sw, 0.);
+                    yakl::memset(aer_asm_bnd_sw, 0.);
+
+                    real2d clear_rh("clear_rh",ncol, nswbands);
+                    yakl::memset(clear_rh, 0.01);
+
+                    optics.set_aerosol_optics_sw(0, ncol, nlev, nswbands, dt, night_indices,
+                                                 is_cmip6_volc, aer_tau_bnd_sw, aer_ssa_bnd_sw, aer_asm_bnd_sw, clear_rh);
+
+                    // Now reorder bands to be consistent with RRTMGP
+                    // TODO: fix the input files themselves!
+                    real1d aer_tau_bnd_sw_1d("cld_tau_bnd_sw_1d", nswbands);
+                    real1d aer_ssa_bnd_sw_1d("cld_ssa_bnd_sw_1d", nswbands);
+                    real1d aer_asm_bnd_sw_1d("cld_asm_bnd_sw_1d", nswbands);
+                    real1d aer_tau_bnd_sw_o_1d("cld_tau_bnd_sw_1d", nswbands);
+                    real1d aer_ssa_bnd_sw_o_1d("cld_ssa_bnd_sw_1d", nswbands);
+                    real1d aer_asm_bnd_sw_o_1d("cld_asm_bnd_sw_1d", nswbands);
+
+                    parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilay)
+                    {
+                        for (auto ibnd = 1; ibnd < nswbands; ++ibnd) {
+                            aer_tau_bnd_sw_1d(ibnd) = aer_tau_bnd_sw(icol,ilay,ibnd);
+                            aer_ssa_bnd_sw_1d(ibnd) = aer_ssa_bnd_sw(icol,ilay,ibnd);
+                            aer_asm_bnd_sw_1d(ibnd) = aer_asm_bnd_sw(icol,ilay,ibnd);
+                        }
+                        internal::reordered(aer_tau_bnd_sw_1d, rrtmg_to_rrtmgp, aer_tau_bnd_sw_o_1d);
+                        internal::reordered(aer_ssa_bnd_sw_1d, rrtmg_to_rrtmgp, aer_ssa_bnd_sw_o_1d);
+                        internal::reordered(aer_asm_bnd_sw_1d, rrtmg_to_rrtmgp, aer_asm_bnd_sw_o_1d);
+                        for (auto ibnd = 1; ibnd < nswbands; ++ibnd) {
+                            aer_tau_bnd_sw(icol,ilay,ibnd) = aer_tau_bnd_sw_o_1d(ibnd);
+                            aer_ssa_bnd_sw(icol,ilay,ibnd) = aer_ssa_bnd_sw_o_1d(ibnd);
+                            aer_asm_bnd_sw(icol,ilay,ibnd) = aer_asm_bnd_sw_o_1d(ibnd);
+                        }
+                    });
+                } else {
+                    yakl::memset(aer_tau_bnd_sw, 0.);
+                    yakl::memset(aer_ssa_bnd_sw, 0.);
+                    yakl::memset(aer_asm_bnd_sw, 0.);
+                }
 
-        optics.sample_cloud_optics_sw(ncol, nlev, nswgpts, gpoint_bands_sw,
-                                      pmid, cld, cldfsnow,
-                                      cld_tau_bnd_sw, cld_ssa_bnd_sw, cld_asm_bnd_sw,
-                                      cld_tau_gpt_sw, cld_ssa_gpt_sw, cld_asm_gpt_sw);
-
-        // Aerosol needs night indices
-        // TODO: remove this dependency, it's just used to mask aerosol outputs
-        set_daynight_indices(coszrs, day_indices, night_indices);
-        int1d nday("nday",1);
-        int1d nnight("nnight",1);
-        yakl::memset(nday, 0);
-        yakl::memset(nnight, 0);
-        for (auto icol=1; icol<ncol; ++icol) {
-            if (day_indices(icol) > 0) nday(1)++;
-            if (night_indices(icol) > 0) nnight(1)++;
-        }
+             yakl::memset(cld_tau_gpt_sw, 0.);
+             yakl::memset(cld_ssa_gpt_sw, 0.);
+             yakl::memset(cld_asm_gpt_sw, 0.);
 
-        // get aerosol optics
-        do_aerosol_rad = true;
-        {
-            // Get gas concentrations
-            get_gas_vmr(active_gases, gas_vmr);
-
-            // Get aerosol optics
-            if (do_aerosol_rad) {
-                yakl::memset(aer_tau_bnd_sw, 0.);
-                yakl::memset(aer_ssa_bnd_sw, 0.);
-                yakl::memset(aer_asm_bnd_sw, 0.);
-
-                real2d clear_rh("clear_rh",ncol, nswbands);
-                yakl::memset(clear_rh, 0.01);
-
-                optics.set_aerosol_optics_sw(0, ncol, nlev, nswbands, dt, night_indices,
-                                             is_cmip6_volc, aer_tau_bnd_sw, aer_ssa_bnd_sw, aer_asm_bnd_sw, clear_rh);
-
-                // Now reorder bands to be consistent with RRTMGP
-                // TODO: fix the input files themselves!
-                real1d aer_tau_bnd_sw_1d("cld_tau_bnd_sw_1d", nswbands);
-                real1d aer_ssa_bnd_sw_1d("cld_ssa_bnd_sw_1d", nswbands);
-                real1d aer_asm_bnd_sw_1d("cld_asm_bnd_sw_1d", nswbands);
-                real1d aer_tau_bnd_sw_o_1d("cld_tau_bnd_sw_1d", nswbands);
-                real1d aer_ssa_bnd_sw_o_1d("cld_ssa_bnd_sw_1d", nswbands);
-                real1d aer_asm_bnd_sw_o_1d("cld_asm_bnd_sw_1d", nswbands);
-
-                parallel_for(SimpleBounds<2>(ncol, nlev), YAKL_LAMBDA (int icol, int ilay)
-                {
-                    for (auto ibnd = 1; ibnd < nswbands; ++ibnd) {
-                        aer_tau_bnd_sw_1d(ibnd) = aer_tau_bnd_sw(icol,ilay,ibnd);
-                        aer_ssa_bnd_sw_1d(ibnd) = aer_ssa_bnd_sw(icol,ilay,ibnd);
-                        aer_asm_bnd_sw_1d(ibnd) = aer_asm_bnd_sw(icol,ilay,ibnd);
-                    }
-                    internal::reordered(aer_tau_bnd_sw_1d, rrtmg_to_rrtmgp, aer_tau_bnd_sw_o_1d);
-                    internal::reordered(aer_ssa_bnd_sw_1d, rrtmg_to_rrtmgp, aer_ssa_bnd_sw_o_1d);
-                    internal::reordered(aer_asm_bnd_sw_1d, rrtmg_to_rrtmgp, aer_asm_bnd_sw_o_1d);
-                    for (auto ibnd = 1; ibnd < nswbands; ++ibnd) {
-                        aer_tau_bnd_sw(icol,ilay,ibnd) = aer_tau_bnd_sw_o_1d(ibnd);
-                        aer_ssa_bnd_sw(icol,ilay,ibnd) = aer_ssa_bnd_sw_o_1d(ibnd);
-                        aer_asm_bnd_sw(icol,ilay,ibnd) = aer_asm_bnd_sw_o_1d(ibnd);
-                    }
-                });
-            } else {
-                yakl::memset(aer_tau_bnd_sw, 0.);
-                yakl::memset(aer_ssa_bnd_sw, 0.);
-                yakl::memset(aer_asm_bnd_sw, 0.);
+             // Call the shortwave radiation driver
+             radiation_driver_sw(ncol, nday, day_indices, gas_vmr,
+                                 pmid, pint, tmid, albedo_dir, albedo_dif, coszrs,
+                                 cld_tau_gpt_sw, cld_ssa_gpt_sw, cld_asm_gpt_sw,
+                                 aer_tau_bnd_sw, aer_ssa_bnd_sw, aer_asm_bnd_sw,
+                                 fluxes_allsky, fluxes_clrsky, qrs, qrsc);
             }
-
-         yakl::memset(cld_tau_gpt_sw, 0.);
-         yakl::memset(cld_ssa_gpt_sw, 0.);
-         yakl::memset(cld_asm_gpt_sw, 0.);
-
-         // Call the shortwave radiation driver
-         radiation_driver_sw(ncol, gas_vmr,
-                             pmid, pint, tmid, albedo_dir, albedo_dif, coszrs,
-                             cld_tau_gpt_sw, cld_ssa_gpt_sw, cld_asm_gpt_sw,
-                             aer_tau_bnd_sw, aer_ssa_bnd_sw, aer_asm_bnd_sw,
-                             fluxes_allsky, fluxes_clrsky, qrs, qrsc);
         }
 
         // Set surface fluxes that are used by the land model
@@ -510,7 +630,7 @@ void Radiation::run ()
                                    lambdac, mu, dei, des, rei,
                                    cld_tau_bnd_lw, liq_tau_bnd_lw, ice_tau_bnd_lw, snw_tau_bnd_lw);
 
-        radiation.get_gpoint_bands_lw(gpoint_bands_lw);
+        radiation->get_gpoint_bands_lw(gpoint_bands_lw);
 
         optics.sample_cloud_optics_lw(ncol, nlev, nlwgpts, gpoint_bands_lw,
                                       pmid, cld, cldfsnow,
@@ -544,27 +664,48 @@ void Radiation::run ()
     } // dolw
 
     // Populate source term for theta dycore variable
-    for (MFIter mfi(*(qrad_src)); mfi.isValid(); ++mfi) {
-        auto qrad_src_array = qrad_src->array(mfi);
-        const auto& box3d = mfi.tilebox();
-        auto nx = box3d.length(0);
+    // TODO: We do not include the cloud source term qrsc/qrlc.
+    //       Do these simply sum for a net source or do we pick one?
+    columns_to_mf(qrs, *qrad_src, 0);
+    columns_to_mf(qrl, *qrad_src, 1);
+}
+
+void Radiation::columns_to_mf (const real2d& col, MultiFab& mf, int dcomp)
+{
+    const int r = m_coarsen;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto mf_array = mf.array(mfi);
+        const auto& box3d = mfi.validbox();
+        const auto& cbox  = amrex::coarsen(box3d, IntVect(r,r,1));
+        const auto clo = lbound(cbox);
+        const auto chi = ubound(cbox);
+        auto ncx = cbox.length(0);
+        auto off = m_col_offset[mfi.LocalIndex()];
         amrex::ParallelFor(box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
         {
-            // Map (col,lev) to (i,j,k)
-            auto icol = j*nx+i+1;
-            auto ilev = k+1;
-
-            // TODO: We do not include the cloud source term qrsc/qrlc.
-            //       Do these simply sum for a net source or do we pick one?
-
-            // SW and LW sources
-            qrad_src_array(i,j,k,0) = qrs(icol,ilev);
-            qrad_src_array(i,j,k,1) = qrl(icol,ilev);
+            // Map (i,j,k) to the (col,lev) that holds it
+            auto ic   = i/r;
+            auto jc   = j/r;
+            auto ilev = k-clo.z+1;
+            auto index = [=] (int ii, int jj) { return off + (jj-clo.y)*ncx + (ii-clo.x) + 1; };
+
+            // Limited linear reconstruction across the columns of the box; the offsets
+            // of the r x r cells sum to zero, so their average is the column value
+            Real c  = col(index(ic,jc), ilev);
+            Real sx = internal::mc_slope(col(index(amrex::max(ic-1,clo.x),jc), ilev), c,
+                                         col(index(amrex::min(ic+1,chi.x),jc), ilev));
+            Real sy = internal::mc_slope(col(index(ic,amrex::max(jc-1,clo.y)), ilev), c,
+                                         col(index(ic,amrex::min(jc+1,chi.y)), ilev));
+            Real xoff = (i - ic*r + 0.5)/r - 0.5;
+            Real yoff = (j - jc*r + 0.5)/r - 0.5;
+
+            mf_array(i,j,k,dcomp) = c + sx*xoff + sy*yoff;
         });
     }
 }
 
-void Radiation::radiation_driver_sw (int ncol, const real3d& gas_vmr,
+void Radiation::radiation_driver_sw (int ncol, int nday, const int1d& day_indices,
+                                     const real3d& gas_vmr,
                                      const real2d& pmid, const real2d& pint, const real2d& tmid,
                                      const real2d& albedo_dir, const real2d& albedo_dif, const real1d& coszrs,
                                      const real3d& cld_tau_gpt, const real3d& cld_ssa_gpt, const real3d& cld_asm_gpt,
@@ -572,36 +713,26 @@ void Radiation::radiation_driver_sw (int ncol, const real3d& gas_vmr,
                                      FluxesByband& fluxes_clrsky, FluxesByband& fluxes_allsky, const real2d& qrs,
                                      const real2d& qrsc)
 {
-    // Incoming solar radiation, scaled for solar zenith angle
-    // and earth-sun distance
-    real2d solar_irradiance_by_gpt("solar_irradiance_by_gpt",ncol,nswgpts);
-
-    // Gathered indices of day and night columns
-    // chunk_column_index = day_indices(daylight_column_index)
-    int1d day_indices("day_indices",ncol), night_indices("night_indices", ncol);   // Indices of daylight coumns
-
-    real1d coszrs_day("coszrs_day", ncol);
-    real2d albedo_dir_day("albedo_dir_day", nswbands, ncol), albedo_dif_day("albedo_dif_day", nswbands, ncol);
-    real2d pmid_day("pmid_day", ncol, nlev);
-    real2d tmid_day("tmid_day", ncol, nlev);
-    real2d pint_day("pint_day", ncol, nlev+1);
-
-    real3d gas_vmr_day("gas_vmr_day", ngas, ncol, nlev);
-    real3d gas_vmr_rad("gas_vmr_rad", ngas, ncol, nlev);
-
-    real3d cld_tau_gpt_day("cld_tau_gpt_day", ncol, nlev, nswgpts);
-    real3d cld_ssa_gpt_day("cld_ssa_gpt_day", ncol, nlev, nswgpts);
-    real3d cld_asm_gpt_day("cld_asm_gpt_day", ncol, nlev, nswgpts);
-    real3d aer_tau_bnd_day("aer_tau_bnd_day", ncol, nlev, nswbands);
-    real3d aer_ssa_bnd_day("aer_ssa_bnd_day", ncol, nlev, nswbands);
-    real3d aer_asm_bnd_day("aer_asm_bnd_day", ncol, nlev, nswbands);
-
-    real3d cld_tau_gpt_rad("cld_tau_gpt_rad", ncol, nlev+1, nswgpts);
-    real3d cld_ssa_gpt_rad("cld_ssa_gpt_rad", ncol, nlev+1, nswgpts);
-    real3d cld_asm_gpt_rad("cld_asm_gpt_rad", ncol, nlev+1, nswgpts);
-    real3d aer_tau_bnd_rad("aer_tau_bnd_rad", ncol, nlev+1, nswgpts);
-    real3d aer_ssa_bnd_rad("aer_ssa_bnd_rad", ncol, nlev+1, nswgpts);
-    real3d aer_asm_bnd_rad("aer_asm_bnd_rad", ncol, nlev+1, nswgpts);
+    // The shortwave radiative transfer is only done on the nday daytime columns
+    // (RRTMGP fails for cosine solar zenith angles less than or equal to zero);
+    // they are packed into contiguous arrays here and the fluxes are scattered
+    // back to all ncol columns at the end
+    AMREX_ASSERT_WITH_MESSAGE((nday>0) && (nday<=ncol), "RADIATION: Invalid number of days!");
+
+    real1d coszrs_day("coszrs_day", nday);
+    real2d albedo_dir_day("albedo_dir_day", nswbands, nday), albedo_dif_day("albedo_dif_day", nswbands, nday);
+    real2d pmid_day("pmid_day", nday, nlev);
+    real2d tmid_day("tmid_day", nday, nlev);
+    real2d pint_day("pint_day", nday, nlev+1);
+
+    real3d gas_vmr_day("gas_vmr_day", ngas, nday, nlev);
+
+    real3d cld_tau_gpt_day("cld_tau_gpt_day", nday, nlev, nswgpts);
+    real3d cld_ssa_gpt_day("cld_ssa_gpt_day", nday, nlev, nswgpts);
+    real3d cld_asm_gpt_day("cld_asm_gpt_day", nday, nlev, nswgpts);
+    real3d aer_tau_bnd_day("aer_tau_bnd_day", nday, nlev, nswbands);
+    real3d aer_ssa_bnd_day("aer_ssa_bnd_day", nday, nlev, nswbands);
+    real3d aer_asm_bnd_day("aer_asm_bnd_day", nday, nlev, nswbands);
 
     // Scaling factor for total sky irradiance; used to account for orbital
     // eccentricity, and could be used to scale total sky irradiance for different
@@ -621,52 +752,42 @@ void Radiation::radiation_driver_sw (int ncol, const real3d& gas_vmr,
         tsi_scaling = fixed_total_solar_irradiance / 1360.9;
     }
 
-    // Gather night/day column indices for subsetting SW inputs; we only want to
-    // do the shortwave radiative transfer during the daytime to save
-    // computational cost (and because RRTMGP will fail for cosine solar zenith
-    // angles less than or equal to zero)
-    set_daynight_indices(coszrs, day_indices, night_indices);
-    int1d nday("nday",1);
-    int1d nnight("nnight", 1);
-    yakl::memset(nday, 0);
-    yakl::memset(nnight, 0);
-    parallel_for(SimpleBounds<1>(ncol), YAKL_LAMBDA (int icol)
+    // Compress to daytime-only arrays
+    parallel_for(SimpleBounds<2>(nday, nlev+1), YAKL_LAMBDA (int iday, int ilev)
     {
-        if (day_indices(icol) > 0) nday(1)++;
-        if (night_indices(icol) > 0) nnight(1)++;
+        auto icol = day_indices(iday);
+        pint_day(iday,ilev) = pint(icol,ilev);
+        if (ilev <= nlev) {
+            tmid_day(iday,ilev) = tmid(icol,ilev);
+            pmid_day(iday,ilev) = pmid(icol,ilev);
+        }
+        if (ilev == 1) {
+            coszrs_day(iday) = coszrs(icol);
+        }
     });
 
-    intHost1d num_day("num_day",1);
-    intHost1d num_night("num_night",1);
-    nday.deep_copy_to(num_day);
-    nnight.deep_copy_to(num_night);
-
-    // If no daytime columns in this chunk, then we return zeros
-    if (num_day(1) == 0) {
-        //    reset_fluxes(fluxes_allsky)
-        //    reset_fluxes(fluxes_clrsky)
-        yakl::memset(qrs, 0.);
-        yakl::memset(qrsc, 0.);
-        return;
-    }
+    parallel_for(SimpleBounds<2>(nswbands, nday), YAKL_LAMBDA (int ibnd, int iday)
+    {
+        auto icol = day_indices(iday);
+        albedo_dir_day(ibnd,iday) = albedo_dir(ibnd,icol);
+        albedo_dif_day(ibnd,iday) = albedo_dif(ibnd,icol);
+    });
 
-    // Compress to daytime-only arrays
-    parallel_for(SimpleBounds<3>(num_day(1), nlev, nswgpts), YAKL_LAMBDA (int iday, int ilev, int igpt)
+    parallel_for(SimpleBounds<3>(ngas, nday, nlev), YAKL_LAMBDA (int igas, int iday, int ilev)
+    {
+        auto icol = day_indices(iday);
+        gas_vmr_day(igas,iday,ilev) = gas_vmr(igas,icol,ilev);
+    });
+
+    parallel_for(SimpleBounds<3>(nday, nlev, nswgpts), YAKL_LAMBDA (int iday, int ilev, int igpt)
     {
         auto icol = day_indices(iday);
-        tmid_day(iday,ilev) = tmid(icol,ilev);
-        pmid_day(iday,ilev) = pmid(icol,ilev);
-        pint_day(iday,ilev) = pint(icol,ilev);
-        albedo_dir_day(igpt,iday) = albedo_dir(igpt,icol);
-        albedo_dif_day(igpt,iday) = albedo_dif(igpt,icol);
-        coszrs_day(iday) = coszrs(icol);
-        gas_vmr_day(igpt,iday,ilev) = gas_vmr(igpt,icol,ilev);
         cld_tau_gpt_day(iday,ilev,igpt) = cld_tau_gpt(icol,ilev,igpt);
         cld_ssa_gpt_day(iday,ilev,igpt) = cld_ssa_gpt(icol,ilev,igpt);
         cld_asm_gpt_day(iday,ilev,igpt) = cld_asm_gpt(icol,ilev,igpt);
     });
 
-    parallel_for(SimpleBounds<3>(num_day(1), nlev, nswbands), YAKL_LAMBDA (int iday, int ilev, int ibnd)
+    parallel_for(SimpleBounds<3>(nday, nlev, nswbands), YAKL_LAMBDA (int iday, int ilev, int ibnd)
     {
         auto icol = day_indices(iday);
         aer_tau_bnd_day(iday,ilev,ibnd) = aer_tau_bnd(icol,ilev,ibnd);
@@ -679,39 +800,13 @@ void Radiation::radiation_driver_sw (int ncol, const real3d& gas_vmr,
     // dimension nlev_rad+1, while we initialized the RRTMGP input variables to
     // have vertical dimension nlev_rad (defined at midpoints).
     FluxesByband fluxes_clrsky_day, fluxes_allsky_day;
-    internal::initial_fluxes(num_day(1), nlev+1, nswbands, fluxes_allsky_day);
-    internal::initial_fluxes(num_day(1), nlev+1, nswbands, fluxes_clrsky_day);
-
-    // Add an empty level above model top
-    // TODO: combine with day compression above
-    yakl::memset(cld_tau_gpt_rad, 0.);
-    yakl::memset(cld_ssa_gpt_rad, 0.);
-    yakl::memset(cld_asm_gpt_rad, 0.);
-
-    yakl::memset(aer_tau_bnd_rad, 0.);
-    yakl::memset(aer_ssa_bnd_rad, 0);
-    yakl::memset(aer_asm_bnd_rad, 0.);
-
-    parallel_for(SimpleBounds<3>(num_day(1), nlev, nswgpts), YAKL_LAMBDA (int iday, int ilev, int igpt)
-    {
-        cld_tau_gpt_rad(iday,ilev,igpt) = cld_tau_gpt_day(iday,ilev,igpt);
-        cld_ssa_gpt_rad(iday,ilev,igpt) = cld_ssa_gpt_day(iday,ilev,igpt);
-        cld_asm_gpt_rad(iday,ilev,igpt) = cld_asm_gpt_day(iday,ilev,igpt);
-        gas_vmr_rad(igpt,iday,1) = gas_vmr_day(igpt,iday,1);
-        gas_vmr_rad(igpt,iday,ilev) = gas_vmr_day(igpt,iday,ilev);
-    });
-
-    parallel_for(SimpleBounds<3>(num_day(1), nlev, nswbands), YAKL_LAMBDA (int iday, int ilev, int ibnd)
-    {
-        aer_tau_bnd_rad(iday,ilev,ibnd) = aer_tau_bnd_day(iday,ilev,ibnd);
-        aer_ssa_bnd_rad(iday,ilev,ibnd) = aer_ssa_bnd_day(iday,ilev,ibnd);
-        aer_asm_bnd_rad(iday,ilev,ibnd) = aer_asm_bnd_day(iday,ilev,ibnd);
-    });
+    internal::initial_fluxes(nday, nlev+1, nswbands, fluxes_allsky_day);
+    internal::initial_fluxes(nday, nlev+1, nswbands, fluxes_clrsky_day);
 
     // Do shortwave radiative transfer calculations
-    radiation.run_shortwave_rrtmgp(ngas, num_day(1), nlev, gas_vmr_rad, pmid,
+    radiation->run_shortwave_rrtmgp(ngas, nday, nlev, gas_vmr_day, pmid_day,
                                    tmid_day, pint_day, coszrs_day, albedo_dir_day, albedo_dif_day,
-                                   cld_tau_gpt_rad, cld_ssa_gpt_rad, cld_asm_gpt_rad, aer_tau_bnd_rad, aer_ssa_bnd_rad, aer_asm_bnd_rad,
+                                   cld_tau_gpt_day, cld_ssa_gpt_day, cld_asm_gpt_day, aer_tau_bnd_day, aer_ssa_bnd_day, aer_asm_bnd_day,
                                    fluxes_allsky_day.flux_up    , fluxes_allsky_day.flux_dn    , fluxes_allsky_day.flux_net    , fluxes_allsky_day.flux_dn_dir    ,
                                    fluxes_allsky_day.bnd_flux_up, fluxes_allsky_day.bnd_flux_dn, fluxes_allsky_day.bnd_flux_net, fluxes_allsky_day.bnd_flux_dn_dir,
                                    fluxes_clrsky_day.flux_up    , fluxes_clrsky_day.flux_dn    , fluxes_clrsky_day.flux_net    , fluxes_clrsky_day.flux_dn_dir    ,
@@ -719,8 +814,8 @@ void Radiation::radiation_driver_sw (int ncol, const real3d& gas_vmr,
                                    tsi_scaling);
 
     // Expand fluxes from daytime-only arrays to full chunk arrays
-    internal::expand_day_fluxes(fluxes_allsky_day, fluxes_allsky, day_indices);
-    internal::expand_day_fluxes(fluxes_clrsky_day, fluxes_clrsky, day_indices);
+    internal::expand_day_fluxes(fluxes_allsky_day, fluxes_allsky, day_indices, nday);
+    internal::expand_day_fluxes(fluxes_clrsky_day, fluxes_clrsky, day_indices, nday);
 
     // Calculate heating rates
     calculate_heating_rate(fluxes_allsky.flux_up,
@@ -767,7 +862,7 @@ void Radiation::radiation_driver_lw (int ncol, int nlev,
     });
 
     // Do longwave radiative transfer calculations
-    radiation.run_longwave_rrtmgp(ngas, ncol, nlev,
+    radiation->run_longwave_rrtmgp(ngas, ncol, nlev,
                                   gas_vmr_rad, pmid, tmid, pint, tint,
                                   surface_emissivity, cld_tau_gpt_rad, aer_tau_bnd_rad,
                                   fluxes_allsky.flux_up    , fluxes_allsky.flux_dn    , fluxes_allsky.flux_net    ,
@@ -785,30 +880,28 @@ void Radiation::radiation_driver_lw (int ncol, int nlev,
                            pint, qrlc);
 }
 
-// Initialize array of daytime indices to be all zero. If any zeros exist when
-// we are done, something went wrong.
-void Radiation::set_daynight_indices (const real1d& coszrs, const int1d& day_indices, const int1d& night_indices)
+// Gather the daytime and nighttime columns, each in column order, with a prefix
+// sum over the columns; returns the number of daytime columns
+int Radiation::set_daynight_indices (const real1d& coszrs, const int1d& day_indices, const int1d& night_indices)
 {
-    // Loop over columns and identify daytime columns as those where the cosine
-    // solar zenith angle exceeds zero. Note that we wrap the setting of
-    // day_indices in an if-then to make sure we are not accessing day_indices out
-    // of bounds, and stopping with an informative error message if we do for some reason.
-    int1d iday("iday", 1);
-    int1d inight("inight",1);
-    yakl::memset(iday, 0);
-    yakl::memset(inight, 0);
+    // Unused entries stay zero; the aerosol optics count the night columns that way
     yakl::memset(day_indices, 0);
     yakl::memset(night_indices, 0);
-    parallel_for(SimpleBounds<1>(ncol), YAKL_LAMBDA (int icol)
-    {
-        if (coszrs(icol) > 0.) {
-            iday(1) += 1;
-            day_indices(iday(1)) = icol;
-        } else {
-            inight(1) += 1;
-            night_indices(inight(1)) = icol;
-        }
-    });
+
+    // Daytime columns are those where the cosine solar zenith angle exceeds zero;
+    // the columns before icol that are not daytime precede it in night_indices
+    return Scan::PrefixSum<int>( ncol,
+                                 [=] AMREX_GPU_DEVICE (int i) -> int { return (coszrs(i+1) > 0.) ? 1 : 0; },
+                                 [=] AMREX_GPU_DEVICE (int i, int const &x)
+                                 {
+                                     if (coszrs(i+1) > 0.) {
+                                         day_indices(x+1) = i+1;
+                                     } else {
+                                         night_indices(i-x+1) = i+1;
+                                     }
+                                 },
+                                 Scan::Type::exclusive,
+                                 Scan::retSum );
 }
 
 void Radiation::get_gas_vmr (const std::vector<std::string>& gas_names, const real3d& gas_vmr)
@@ -954,74 +1047,62 @@ Radiation::export_surface_fluxes(FluxesByband& fluxes,
     // No work to be done if we don't have valid pointers
     if (!m_lsm_fluxes) return;
 
+    // Surface values of the columns
+    int ilev = 1;
+
     if (band == "shortwave") {
-        real3d flux_dn_diffuse("flux_dn_diffuse", ncol, nlev+1, nswbands);
+        real2d dir_vis("dir_vis", ncol, 1), dir_nir("dir_nir", ncol, 1);
+        real2d dif_vis("dif_vis", ncol, 1), dif_nir("dif_nir", ncol, 1);
+        real2d net("net", ncol, 1);
 
-        // Calculate diffuse flux from total and direct
-        // This only occurs at the bottom level (k index)
-        parallel_for (SimpleBounds<3>(ncol, 1, nswbands), YAKL_LAMBDA (int icol, int ilev, int ibnd)
+        parallel_for (SimpleBounds<1>(ncol), YAKL_LAMBDA (int icol)
         {
-            flux_dn_diffuse(icol,ilev,ibnd) = fluxes.bnd_flux_dn(icol,ilev,ibnd)
-                                            - fluxes.bnd_flux_dn_dir(icol,ilev,ibnd);
+            // Direct fluxes
+            Real sum1(0.0), sum2(0.0);
+            for (int ibnd(1); ibnd<=9; ++ibnd) {
+                sum1 += fluxes.bnd_flux_dn_dir(icol,ilev,ibnd);
+            }
+            for (int ibnd(11); ibnd<=14; ++ibnd) {
+                sum2 += fluxes.bnd_flux_dn_dir(icol,ilev,ibnd);
+            }
+            sum1 += 0.5 * fluxes.bnd_flux_dn_dir(icol,ilev,10);
+            sum2 += 0.5 * fluxes.bnd_flux_dn_dir(icol,ilev,10);
+            dir_vis(icol,1) = sum1;
+            dir_nir(icol,1) = sum2;
+
+            // Diffuse fluxes, from total and direct
+            sum1=0.0; sum2=0.0;
+            for (int ibnd(1); ibnd<=9; ++ibnd) {
+                sum1 += fluxes.bnd_flux_dn(icol,ilev,ibnd) - fluxes.bnd_flux_dn_dir(icol,ilev,ibnd);
+            }
+            for (int ibnd(11); ibnd<=14; ++ibnd) {
+                sum2 += fluxes.bnd_flux_dn(icol,ilev,ibnd) - fluxes.bnd_flux_dn_dir(icol,ilev,ibnd);
+            }
+            sum1 += 0.5 * (fluxes.bnd_flux_dn(icol,ilev,10) - fluxes.bnd_flux_dn_dir(icol,ilev,10));
+            sum2 += 0.5 * (fluxes.bnd_flux_dn(icol,ilev,10) - fluxes.bnd_flux_dn_dir(icol,ilev,10));
+            dif_vis(icol,1) = sum1;
+            dif_nir(icol,1) = sum2;
+
+            // Net fluxes
+            net(icol,1) = fluxes.flux_net(icol,ilev);
         });
 
         // Populate the LSM data structure (this is a 2D MF)
-        for (MFIter mfi(*(m_lsm_fluxes)); mfi.isValid(); ++mfi) {
-            auto lsm_array = m_lsm_fluxes->array(mfi);
-            const auto& box3d = mfi.tilebox();
-            auto nx = box3d.length(0);
-            amrex::ParallelFor(box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
-            {
-                // Map (col,lev) to (i,j,k)
-                auto icol = j*nx+i+1;
-                auto ilev = k+1;
-
-                // Direct fluxes
-                Real sum1(0.0), sum2(0.0);
-                for (int ibnd(1); ibnd<=9; ++ibnd) {
-                    sum1 += fluxes.bnd_flux_dn_dir(icol,ilev,ibnd);
-                }
-                for (int ibnd(11); ibnd<=14; ++ibnd) {
-                    sum2 += fluxes.bnd_flux_dn_dir(icol,ilev,ibnd);
-                }
-                sum1 += 0.5 * fluxes.bnd_flux_dn_dir(icol,ilev,10);
-                sum2 += 0.5 * fluxes.bnd_flux_dn_dir(icol,ilev,10);
-                lsm_array(i,j,k,0) = sum1;
-                lsm_array(i,j,k,1) = sum2;
-
-                // Diffuse fluxes
-                sum1=0.0; sum2=0.0;
-                for (int ibnd(1); ibnd<=9; ++ibnd) {
-                    sum1 += flux_dn_diffuse(icol,ilev,ibnd);
-                }
-                for (int ibnd(11); ibnd<=14; ++ibnd) {
-                    sum2 += flux_dn_diffuse(icol,ilev,ibnd);
-                }
-                sum1 += 0.5 * flux_dn_diffuse(icol,ilev,10);
-                sum2 += 0.5 * flux_dn_diffuse(icol,ilev,10);
-                lsm_array(i,j,k,2) = sum1;
-                lsm_array(i,j,k,3) = sum2;
-
-                // Net fluxes
-                lsm_array(i,j,k,4) = fluxes.flux_net(icol,ilev);
-            });
-        }
+        columns_to_mf(dir_vis, *m_lsm_fluxes, 0);
+        columns_to_mf(dir_nir, *m_lsm_fluxes, 1);
+        columns_to_mf(dif_vis, *m_lsm_fluxes, 2);
+        columns_to_mf(dif_nir, *m_lsm_fluxes, 3);
+        columns_to_mf(net    , *m_lsm_fluxes, 4);
     } else if (band == "longwave") {
-        // Populate the LSM data structure (this is a 2D MF)
-        for (MFIter mfi(*(m_lsm_fluxes)); mfi.isValid(); ++mfi) {
-            auto lsm_array = m_lsm_fluxes->array(mfi);
-            const auto& box3d = mfi.tilebox();
-            auto nx = box3d.length(0);
-            amrex::ParallelFor(box3d, [=] AMREX_GPU_DEVICE (int i, int j, int k)
-            {
-                // Map (col,lev) to (i,j,k)
-                auto icol = j*nx+i+1;
-                auto ilev = k+1;
+        real2d flux_dn("flux_dn", ncol, 1);
 
-                // Net fluxes
-                lsm_array(i,j,k,5) = fluxes.flux_dn(icol,ilev);
-            });
-        }
+        parallel_for (SimpleBounds<1>(ncol), YAKL_LAMBDA (int icol)
+        {
+            flux_dn(icol,1) = fluxes.flux_dn(icol,ilev);
+        });
+
+        // Populate the LSM data structure (this is a 2D MF)
+        columns_to_mf(flux_dn, *m_lsm_fluxes, 5);
     } else {
          amrex::Abort("Unknown radiation band type!");
     }
@@ -19,6 +19,7 @@ using namespace amrex;
  * @param[in]  S_data current solution
  * @param[in]  S_prim primitive variables (i.e. conserved variables divided by density)
  * @param[in] source source terms for conserved variables
+ * @param[in]  micro_tendency microphysics tendencies of (rho theta) and the moist variables, or nullptr
  * @param[in]  geom   Container for geometric information
  * @param[in]  solverChoice  Container for solver parameters
  * @param[in] mapfac_u map factor at x-faces
@@ -37,6 +38,7 @@ void make_sources (int level,
 #ifdef ERF_USE_RRTMGP
                    const MultiFab* qheating_rates,
 #endif
+                   const MultiFab* micro_tendency,
                    const Geometry geom,
                    const SolverChoice& solverChoice,
                    std::unique_ptr<MultiFab>& mapfac_u,
@@ -193,6 +195,31 @@ void make_sources (int level,
 
 #endif
 
+        // *************************************************************************************
+        // Add the microphysics tendencies on steps that do not call the microphysics
+        // *************************************************************************************
+        if (micro_tendency) {
+            auto const& tend_arr = micro_tendency->const_array(mfi);
+            const int n_qstate = micro_tendency->nComp() - 1;
+            ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // Do not take away more moisture than is left; all the tendencies of the
+                // cell are scaled by the same factor so the latent heating matches the
+                // phase changes that are actually applied
+                Real fac = 1.0;
+                for (int n = 0; n < n_qstate; ++n) {
+                    const Real sink = -tend_arr(i,j,k,1+n) * dt;
+                    if (sink > cell_data(i,j,k,RhoQ1_comp+n)) {
+                        fac = amrex::min(fac, amrex::max(cell_data(i,j,k,RhoQ1_comp+n), Real(0.0)) / sink);
+                    }
+                }
+                cell_src(i,j,k,RhoTheta_comp) += fac * tend_arr(i,j,k,0);
+                for (int n = 0; n < n_qstate; ++n) {
+                    cell_src(i,j,k,RhoQ1_comp+n) += fac * tend_arr(i,j,k,1+n);
+                }
+            });
+        }
+
         // *************************************************************************************
         // Add Rayleigh damping for (rho theta)
         // *************************************************************************************
@@ -161,7 +161,7 @@ ERF::Advance (int lev, Real time, Real dt_lev, int iteration, int /*ncycle*/)
     // **************************************************************************************
     // Update the radiation
     // **************************************************************************************
-    advance_radiation(lev, S_new, dt_lev);
+    advance_radiation(lev, S_new, time, dt_lev);
 #endif
 
 #ifdef ERF_USE_PARTICLES
@@ -181,7 +181,7 @@ ERF::Advance (int lev, Real time, Real dt_lev, int iteration, int /*ncycle*/)
             state_old[IntVars::cons].FillBoundary(geom[lev].periodicity());
             state_new[IntVars::cons].FillBoundary(geom[lev].periodicity());
             FPr_c[lev].RegisterCoarseData({&state_old[IntVars::cons], &state_new[IntVars::cons]},
-                                          {time, time + dt_lev});
+                                          {time, time + dt_lev}, domain_bcs_type);
         }
 
         if (cf_width >= 0) {
@@ -189,24 +189,24 @@ ERF::Advance (int lev, Real time, Real dt_lev, int iteration, int /*ncycle*/)
             state_old[IntVars::xmom].FillBoundary(geom[lev].periodicity());
             state_new[IntVars::xmom].FillBoundary(geom[lev].periodicity());
             FPr_u[lev].RegisterCoarseData({&state_old[IntVars::xmom], &state_new[IntVars::xmom]},
-                                          {time, time + dt_lev});
+                                          {time, time + dt_lev}, domain_bcs_type);
 
             state_old[IntVars::ymom].FillBoundary(geom[lev].periodicity());
             state_new[IntVars::ymom].FillBoundary(geom[lev].periodicity());
             FPr_v[lev].RegisterCoarseData({&state_old[IntVars::ymom], &state_new[IntVars::ymom]},
-                                          {time, time + dt_lev});
+                                          {time, time + dt_lev}, domain_bcs_type);
 
             state_old[IntVars::zmom].FillBoundary(geom[lev].periodicity());
             state_new[IntVars::zmom].FillBoundary(geom[lev].periodicity());
             FPr_w[lev].RegisterCoarseData({&state_old[IntVars::zmom], &state_new[IntVars::zmom]},
-                                          {time, time + dt_lev});
+                                          {time, time + dt_lev}, domain_bcs_type);
         }
     }
 
     // ***********************************************************************************************
-    // Update the time averaged velocities if they are requested
+    // Update the running statistics if they are requested
     // ***********************************************************************************************
-    if (solverChoice.time_avg_vel) {
-        Time_Avg_Vel_atCC(dt[lev], t_avg_cnt[lev], vel_t_avg[lev].get(), U_new, V_new, W_new);
+    if (field_stats.active()) {
+        field_stats.accumulate(lev, time + dt_lev, dt_lev, S_new, U_new, V_new, W_new);
     }
 }
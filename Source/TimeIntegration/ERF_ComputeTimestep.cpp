@@ -3,28 +3,62 @@
 
 using namespace amrex;
 
+namespace {
+/**
+ * Round the ratio of slow to fast time step up to a value the MRI integrator supports
+ *
+ * @param[in] ratio ratio of slow to fast time step
+ * @param[in] single_substep_stage1 whether the first RK stage takes a single substep
+ */
+long
+round_mri_ratio (long ratio, bool single_substep_stage1)
+{
+    if (single_substep_stage1) {
+        if (ratio%2 != 0) ratio += 1;
+    } else {
+        if (ratio%6 != 0) ratio = static_cast<long>(std::ceil(ratio/6.0) * 6);
+    }
+    return ratio;
+}
+}
+
 /**
  * Function that calls estTimeStep for each level
  *
+ * Depending on amr.subcycling_mode each finer level takes the refinement ratio (Auto),
+ * one (None) or a given number (Manual) of substeps per step of the next coarser level,
+ * and the level 0 time step is limited by all levels.  With Optimal each finer level
+ * instead takes as many substeps as its own estimate requires, so the time step of a
+ * level only depends on the levels at and above it.
  */
 void
 ERF::ComputeDt (int step)
 {
     Vector<Real> dt_tmp(finest_level+1);
+    Vector<Real> dt_fast(finest_level+1);
 
     for (int lev = 0; lev <= finest_level; ++lev)
     {
-        dt_tmp[lev] = estTimeStep(lev, dt_mri_ratio[lev]);
+        dt_tmp[lev] = estTimeStep(lev, dt_mri_ratio[lev], dt_fast[lev]);
     }
 
     ParallelDescriptor::ReduceRealMin(&dt_tmp[0], dt_tmp.size());
 
+    if (subcycling_mode == "None") {
+        for (int lev = 1; lev <= finest_level; ++lev) {
+            nsubsteps[lev] = 1;
+        }
+    }
+    const bool optimal = (subcycling_mode == "Optimal");
+
     Real dt_0 = dt_tmp[0];
     int n_factor = 1;
     for (int lev = 0; lev <= finest_level; ++lev) {
         dt_tmp[lev] = amrex::min(dt_tmp[lev], change_max*dt[lev]);
         n_factor *= nsubsteps[lev];
-        dt_0 = amrex::min(dt_0, n_factor*dt_tmp[lev]);
+        if (lev == 0 || !optimal) {
+            dt_0 = amrex::min(dt_0, n_factor*dt_tmp[lev]);
+        }
         if (step == 0){
             dt_0 *= init_shrink;
             if (verbose) {
@@ -41,8 +75,29 @@ ERF::ComputeDt (int step)
 
     dt[0] = dt_0;
     for (int lev = 1; lev <= finest_level; ++lev) {
+        if (optimal) {
+            Real dt_lev = (step == 0) ? init_shrink*dt_tmp[lev] : dt_tmp[lev];
+            nsubsteps[lev] = amrex::max(1, static_cast<int>(std::ceil(dt[lev-1] / dt_lev * (1.0 - 1.e-8))));
+        }
         dt[lev] = dt[lev-1] / nsubsteps[lev];
     }
+
+    // A subcycled level usually takes a smaller step than its own estimate, so its
+    // acoustic substep ratio follows from the step it actually takes; without
+    // subcycling every level keeps the ratio of its own estimate
+    if (fixed_dt <= 0.0 && !solverChoice.no_substepping && subcycling_mode != "None") {
+        for (int lev = 1; lev <= finest_level; ++lev) {
+            long ratio = amrex::max(1L, static_cast<long>(std::ceil(dt[lev] / dt_fast[lev])));
+            dt_mri_ratio[lev] = round_mri_ratio(ratio, solverChoice.force_stage1_single_substep);
+        }
+    }
+
+    if (verbose && finest_level > 0) {
+        for (int lev = 1; lev <= finest_level; ++lev) {
+            Print() << "Level " << lev << " takes " << nsubsteps[lev] << " substeps with dt = " << dt[lev]
+                    << " and mri_dt_ratio = " << dt_mri_ratio[lev] << std::endl;
+        }
+    }
 }
 
 /**
@@ -50,9 +105,10 @@ ERF::ComputeDt (int step)
  *
  * @param[in] level level of refinement (coarsest level i 0)
  * @param[out] dt_fast_ratio ratio of slow to fast time step
+ * @param[out] dt_fast acoustic time step
  */
 Real
-ERF::estTimeStep (int level, long& dt_fast_ratio) const
+ERF::estTimeStep (int level, long& dt_fast_ratio, Real& dt_fast) const
 {
     BL_PROFILE("ERF::estTimeStep()");
 
@@ -182,15 +238,13 @@ ERF::estTimeStep (int level, long& dt_fast_ratio) const
      }
 
      // Force time step ratio to be an even value
-     if (solverChoice.force_stage1_single_substep) {
-         if ( dt_fast_ratio%2 != 0) dt_fast_ratio += 1;
-     } else {
-         if ( dt_fast_ratio%6 != 0) {
-             Print() << "mri_dt_ratio = " << dt_fast_ratio
-                            << " not divisible by 6 for N/3 substeps in stage 1" << std::endl;
-             dt_fast_ratio = static_cast<int>(std::ceil(dt_fast_ratio/6.0) * 6);
-         }
+     if (!solverChoice.force_stage1_single_substep && dt_fast_ratio%6 != 0) {
+         Print() << "mri_dt_ratio = " << dt_fast_ratio
+                        << " not divisible by 6 for N/3 substeps in stage 1" << std::endl;
      }
+     dt_fast_ratio = round_mri_ratio(dt_fast_ratio, solverChoice.force_stage1_single_substep);
+
+     dt_fast = estdt_comp;
 
      if (verbose && !l_no_substepping)
          Print() << "smallest even ratio is: " << dt_fast_ratio << std::endl;
@@ -1,5 +1,6 @@
 #include <ERF.H>
 #include <Utils.H>
+#include <TileTuning.H>
 
 using namespace amrex;
 
@@ -15,7 +16,7 @@ using namespace amrex;
 void
 ERF::timeStep (int lev, Real time, int /*iteration*/)
 {
-    if (regrid_int > 0)  // We may need to regrid
+    if (regrid_int > 0 && !static_nest)  // We may need to regrid
     {
         // help keep track of whether a level was already regridded
         // from a coarser level call to regrid
@@ -34,6 +35,8 @@ ERF::timeStep (int lev, Real time, int /*iteration*/)
 
                 regrid(lev, time);
 
+                ReportMemory("regrid at level " + std::to_string(lev));
+
 #ifdef ERF_USE_PARTICLES
                 if (finest_level != old_finest) {
                     particleData.Redistribute();
@@ -45,14 +48,28 @@ ERF::timeStep (int lev, Real time, int /*iteration*/)
                     last_regrid_step[k] = istep[k];
                 }
 
-                // if there are newly created levels, set the time step
+                // if there are newly created levels, set the time step; until the next
+                // ComputeDt a new level subcycles as its mode says (the refinement ratio
+                // with Auto and Optimal)
                 for (int k = old_finest+1; k <= finest_level; ++k) {
-                    dt[k] = dt[k-1] / MaxRefRatio(k-1);
+                    if (subcycling_mode == "None") {
+                        nsubsteps[k] = 1;
+                    } else if (subcycling_mode != "Manual") {
+                        nsubsteps[k] = MaxRefRatio(k-1);
+                    }
+                    dt[k] = dt[k-1] / nsubsteps[k];
                 }
             } // if
         } // lev
     }
 
+    // Redistribute the grids using the costs measured since the last time; all levels
+    // are at the same time at the start of a level 0 step
+    if (lev == 0 && load_balance_int > 0 && istep[0] > 0 && (istep[0] % load_balance_int == 0))
+    {
+        LoadBalance();
+    }
+
     // Update what we call "old" and "new" time
     t_old[lev] = t_new[lev];
     t_new[lev] += dt[lev];
@@ -73,6 +90,8 @@ ERF::timeStep (int lev, Real time, int /*iteration*/)
 
     ++istep[lev];
 
+    TileTuning::finish_step(lev);
+
     if (Verbose()) {
         amrex::Print() << "[Level " << lev << " step " << istep[lev] << "] ";
         amrex::Print() << "Advanced " << CountCells(lev) << " cells" << std::endl;
@@ -86,6 +105,12 @@ ERF::timeStep (int lev, Real time, int /*iteration*/)
             Real strt_time_for_fine = time + (i-1)*dt[lev+1];
             timeStep(lev+1, strt_time_for_fine, i);
         }
+
+        // Once the finer level has caught up, reflux and average down onto this level
+        // before it takes its next step
+        if (solverChoice.coupling_type == CouplingType::TwoWay) {
+            RefluxAndAverageDown(lev);
+        }
     }
 
     if (verbose && lev == 0) {
@@ -2,15 +2,91 @@
 
 using namespace amrex;
 
+/**
+ * Advances the microphysics at one level. With erf.micro_int = N > 1 the model is
+ * only called every N steps of the level; on those steps the rates of change it
+ * makes to the state and to the precipitation accumulations are stored. The state
+ * rates are added as sources in make_sources on the steps in between, and the
+ * accumulations are advanced with their rates here; the model itself is not touched
+ * on those steps, and its diagnostic variables are only refilled from the state by
+ * update_micro_diagnostics when they are read.
+ *
+ * @param[in] lev level of refinement
+ * @param[in,out] cons conserved state after the dycore
+ * @param[in] dt_advance time step of the level
+ * @param[in] iteration iteration number
+ * @param[in] time start time of the step
+ */
 void ERF::advance_microphysics (int lev,
                                 MultiFab& cons,
                                 const Real& dt_advance,
                                 const int& iteration,
                                 const Real& time )
 {
-    if (solverChoice.moisture_type != MoistureType::None) {
+    if (solverChoice.moisture_type == MoistureType::None) return;
+
+    if (!micro_tendency[lev]) {
+        micro->Update_Micro_Vars_Lev(lev, cons);
+        micro->Advance(lev, dt_advance, iteration, time, solverChoice, vars_new, z_phys_nd);
+        micro->Update_State_Vars_Lev(lev, cons);
+        return;
+    }
+
+    MultiFab& tend = *micro_tendency[lev];
+    const int n_qstate = tend.nComp() - 1;
+    const Vector<int> accum_idx = Microphysics::precipAccumIndices(solverChoice.moisture_type);
+
+    if (use_micro_tendency(lev)) {
+        // The dycore has applied the stored tendencies; only add the precipitation that
+        // reached the ground, the model's own copy of the state is refreshed on its next call
+        for (int n = 0; n < accum_idx.size(); ++n) {
+            MultiFab::Saxpy(*qmoist[lev][accum_idx[n]], dt_advance, *micro_accum_rate[lev], n, 0, 1, 0);
+        }
+        micro_diag_stale[lev] = 1;
+    } else {
+        // Keep the state before the call ...
+        MultiFab::Copy(tend, cons, RhoTheta_comp, 0, 1, 0);
+        MultiFab::Copy(tend, cons, RhoQ1_comp, 1, n_qstate, 0);
+        for (int n = 0; n < accum_idx.size(); ++n) {
+            MultiFab::Copy(*micro_accum_rate[lev], *qmoist[lev][accum_idx[n]], 0, n, 1, 0);
+        }
+
         micro->Update_Micro_Vars_Lev(lev, cons);
         micro->Advance(lev, dt_advance, iteration, time, solverChoice, vars_new, z_phys_nd);
         micro->Update_State_Vars_Lev(lev, cons);
+
+        // ... and turn it into the rate of change over this step
+        const Real inv_dt = 1.0 / dt_advance;
+        MultiFab::LinComb(tend, inv_dt, cons, RhoTheta_comp, -inv_dt, tend, 0, 0, 1, 0);
+        MultiFab::LinComb(tend, inv_dt, cons, RhoQ1_comp, -inv_dt, tend, 1, 1, n_qstate, 0);
+        for (int n = 0; n < accum_idx.size(); ++n) {
+            MultiFab::LinComb(*micro_accum_rate[lev], inv_dt, *qmoist[lev][accum_idx[n]], 0,
+                              -inv_dt, *micro_accum_rate[lev], n, n, 1, 0);
+        }
+
+        micro_step_count[lev] = 0;
+        micro_diag_stale[lev] = 0;
+    }
+
+    ++micro_step_count[lev];
+}
+
+/**
+ * Refills the diagnostic microphysics variables of a level (qmoist) from the state
+ * if the stored tendencies have changed it since the last call of the model. The
+ * radiation and the plotfiles read them; the precipitation accumulations are left
+ * as they are.
+ *
+ * @param[in] lev level of refinement
+ * @param[in] cons conserved state
+ */
+void ERF::update_micro_diagnostics (int lev,
+                                    const MultiFab& cons)
+{
+    if (solverChoice.moisture_type == MoistureType::None) return;
+
+    if (micro_diag_stale[lev]) {
+        micro->Update_Diagnostics_Lev(lev, cons);
+        micro_diag_stale[lev] = 0;
     }
 }
@@ -3,8 +3,20 @@
 using namespace amrex;
 
 #if defined(ERF_USE_RRTMGP)
+/**
+ * Advances the radiation at one level. With erf.radiation_interval or erf.radiation_per
+ * the model is only called at that frequency (and whenever the heating rates of the
+ * level have just been allocated); the heating rates and surface fluxes of the last
+ * call stay in place and keep being applied on the steps in between.
+ *
+ * @param[in] lev level of refinement
+ * @param[in] cons conserved state after the dycore
+ * @param[in] time start time of the step
+ * @param[in] dt_advance time step of the level
+ */
 void ERF::advance_radiation (int lev,
                              MultiFab& cons,
+                             const Real& time,
                              const Real& dt_advance)
 {
    bool do_sw_rad {true};
@@ -13,22 +25,52 @@ void ERF::advance_radiation (int lev,
    bool do_snow_opt {true};
    bool is_cmip6_volcano {false};
 
-    rad.initialize(cons,
-                   sw_lw_fluxes[lev].get(),
-                   solar_zenith[lev].get(),
-                   qheating_rates[lev].get(),
-                   lat_m[lev].get(),
-                   lon_m[lev].get(),
-                   qmoist[lev],
-                   grids[lev],
-                   Geom(lev),
-                   dt_advance,
-                   do_sw_rad,
-                   do_lw_rad,
-                   do_aero_rad,
-                   do_snow_opt,
-                   is_cmip6_volcano);
-    rad.run();
-    rad.on_complete();
+    bool every_step = (rad_interval <= 0 && rad_per <= 0.);
+    if (!every_step && !rad_needs_update[lev] &&
+        !is_it_time_for_action(istep[lev]+1, time+dt_advance, dt_advance, rad_interval, rad_per)) {
+        return;
+    }
+
+    // Each level has its own radiation object, so its column buffers are only
+    // resized when its own grids change; the k-distributions and cloud optics are
+    // loaded by the first object and shared by the others
+    if (!rad[lev]) {
+        rad[lev] = std::make_unique<Radiation>();
+    }
+    Radiation& rad_lev = *rad[lev];
+
+    if (!rad_lev.is_initialized()) {
+        const Radiation* shared = nullptr;
+        for (const auto& r : rad) {
+            if (r && r->is_initialized()) {
+                shared = r.get();
+                break;
+            }
+        }
+        rad_lev.initialize(do_sw_rad,
+                           do_lw_rad,
+                           do_aero_rad,
+                           do_snow_opt,
+                           is_cmip6_volcano,
+                           shared);
+    }
+
+    // The cloud optics read the moisture of the state, not of the last microphysics call
+    update_micro_diagnostics(lev, cons);
+
+    rad_lev.set_state(cons,
+                      sw_lw_fluxes[lev].get(),
+                      solar_zenith[lev].get(),
+                      qheating_rates[lev].get(),
+                      lat_m[lev].get(),
+                      lon_m[lev].get(),
+                      qmoist[lev],
+                      grids[lev],
+                      Geom(lev),
+                      dt_advance);
+    rad_lev.run();
+    rad_lev.on_complete();
+
+    rad_needs_update[lev] = 0;
 }
 #endif
@@ -1,5 +1,6 @@
 
 #include <TI_fast_headers.H>
+#include <TileTuning.H>
 
 using namespace amrex;
 
@@ -55,6 +56,9 @@ void erf_fast_rhs_N (int step, int nrk,
 {
     BL_PROFILE_REGION("erf_fast_rhs_N()");
 
+    // Time the loops of this kernel family while the tile sizes are being tuned
+    TileTuningTimer tile_timer(TileTuning::Family::FastRhs, level);
+
     Real beta_1 = 0.5 * (1.0 - beta_s);  // multiplies explicit terms
     Real beta_2 = 0.5 * (1.0 + beta_s);  // multiplies implicit terms
 
@@ -103,7 +107,7 @@ void erf_fast_rhs_N (int step, int nrk,
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-    for ( MFIter mfi(S_stage_data[IntVars::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for ( MFIter mfi(S_stage_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::FastRhs, level, false)); mfi.isValid(); ++mfi)
     {
         const Array4<Real>       & cur_cons  = S_data[IntVars::cons].array(mfi);
         const Array4<const Real>& prev_cons  = S_prev[IntVars::cons].const_array(mfi);
@@ -150,7 +154,7 @@ void erf_fast_rhs_N (int step, int nrk,
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-    for ( MFIter mfi(S_stage_data[IntVars::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for ( MFIter mfi(S_stage_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::FastRhs, level, false)); mfi.isValid(); ++mfi)
     {
         // We define lagged_delta_rt for our next step as the current delta_rt
         Box gbx = mfi.tilebox(); gbx.grow(1);
@@ -170,7 +174,7 @@ void erf_fast_rhs_N (int step, int nrk,
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-    for ( MFIter mfi(S_stage_data[IntVars::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for ( MFIter mfi(S_stage_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::FastRhs, level, false)); mfi.isValid(); ++mfi)
     {
         Box tbx = mfi.nodaltilebox(0);
         Box tby = mfi.nodaltilebox(1);
@@ -260,7 +264,7 @@ void erf_fast_rhs_N (int step, int nrk,
 #endif
     {
     std::array<FArrayBox,AMREX_SPACEDIM> flux;
-    for ( MFIter mfi(S_stage_data[IntVars::cons],TileNoZ()); mfi.isValid(); ++mfi)
+    for ( MFIter mfi(S_stage_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::FastRhs, level, true)); mfi.isValid(); ++mfi)
     {
         Box bx  = mfi.tilebox();
         Box tbz = surroundingNodes(bx,2);
@@ -342,7 +346,7 @@ void erf_fast_rhs_N (int step, int nrk,
             (flx_arr[0])(i,j,k,1) = (flx_arr[0])(i  ,j,k,0) * 0.5 * (prim(i,j,k,0) + prim(i-1,j,k,0));
 
             (flx_arr[1])(i,j,k,0) = yflux_lo;
-            (flx_arr[1])(i,j,k,1) = (flx_arr[0])(i,j  ,k,0) * 0.5 * (prim(i,j,k,0) + prim(i,j-1,k,0));
+            (flx_arr[1])(i,j,k,1) = (flx_arr[1])(i,j  ,k,0) * 0.5 * (prim(i,j,k,0) + prim(i,j-1,k,0));
 
             if (i == vbx_hi.x) {
                 (flx_arr[0])(i+1,j,k,0) = xflux_hi;
@@ -514,8 +518,7 @@ void erf_fast_rhs_N (int step, int nrk,
         // We only add to the flux registers in the final RK step
         if (l_reflux && nrk == 2) {
             int strt_comp_reflux = 0;
-            // For now we don't reflux (rho theta) because it seems to create issues at c/f boundaries
-            int  num_comp_reflux = 1;
+            int  num_comp_reflux = 2;
             if (level < finest_level) {
                 fr_as_crse->CrseAdd(mfi,
                     {{AMREX_D_DECL(&(flux[0]), &(flux[1]), &(flux[2]))}},
@@ -533,7 +536,7 @@ void erf_fast_rhs_N (int step, int nrk,
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-    for ( MFIter mfi(S_stage_data[IntVars::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for ( MFIter mfi(S_stage_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::FastRhs, level, false)); mfi.isValid(); ++mfi)
     {
         const Box& bx = mfi.tilebox();
 
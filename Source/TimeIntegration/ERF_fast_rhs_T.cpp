@@ -1,5 +1,6 @@
 
 #include <TI_fast_headers.H>
+#include <TileTuning.H>
 
 using namespace amrex;
 
@@ -61,6 +62,9 @@ void erf_fast_rhs_T (int step, int nrk,
 {
     BL_PROFILE_REGION("erf_fast_rhs_T()");
 
+    // Time the loops of this kernel family while the tile sizes are being tuned
+    TileTuningTimer tile_timer(TileTuning::Family::FastRhs, level);
+
     Real beta_1 = 0.5 * (1.0 - beta_s);  // multiplies explicit terms
     Real beta_2 = 0.5 * (1.0 + beta_s);  // multiplies implicit terms
 
@@ -105,7 +109,7 @@ void erf_fast_rhs_T (int step, int nrk,
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-    for ( MFIter mfi(S_stage_data[IntVars::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for ( MFIter mfi(S_stage_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::FastRhs, level, false)); mfi.isValid(); ++mfi)
     {
         const Array4<Real>       & cur_cons  = S_data[IntVars::cons].array(mfi);
         const Array4<const Real>& prev_cons  = S_prev[IntVars::cons].const_array(mfi);
@@ -167,7 +171,7 @@ void erf_fast_rhs_T (int step, int nrk,
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-    for ( MFIter mfi(S_stage_data[IntVars::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for ( MFIter mfi(S_stage_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::FastRhs, level, false)); mfi.isValid(); ++mfi)
     {
         // We define lagged_delta_rt for our next step as the current delta_rt
         Box gbx = mfi.tilebox(); gbx.grow(1);
@@ -185,7 +189,7 @@ void erf_fast_rhs_T (int step, int nrk,
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-    for ( MFIter mfi(S_stage_data[IntVars::cons],TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for ( MFIter mfi(S_stage_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::FastRhs, level, false)); mfi.isValid(); ++mfi)
     {
         Box tbx = mfi.nodaltilebox(0);
         Box tby = mfi.nodaltilebox(1);
@@ -300,7 +304,7 @@ void erf_fast_rhs_T (int step, int nrk,
 #endif
     {
     std::array<FArrayBox,AMREX_SPACEDIM> flux;
-    for ( MFIter mfi(S_stage_data[IntVars::cons],TileNoZ()); mfi.isValid(); ++mfi)
+    for ( MFIter mfi(S_stage_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::FastRhs, level, true)); mfi.isValid(); ++mfi)
     {
         Box bx  = mfi.tilebox();
         Box tbz = surroundingNodes(bx,2);
@@ -412,7 +416,7 @@ void erf_fast_rhs_T (int step, int nrk,
             (flx_arr[0])(i,j,k,1) = (flx_arr[0])(i  ,j,k,0) * 0.5 * (prim(i,j,k,0) + prim(i-1,j,k,0));
 
             (flx_arr[1])(i,j,k,0) = yflux_lo;
-            (flx_arr[1])(i,j,k,1) = (flx_arr[0])(i,j  ,k,0) * 0.5 * (prim(i,j,k,0) + prim(i,j-1,k,0));
+            (flx_arr[1])(i,j,k,1) = (flx_arr[1])(i,j  ,k,0) * 0.5 * (prim(i,j,k,0) + prim(i,j-1,k,0));
 
             if (i == vbx_hi.x) {
                 (flx_arr[0])(i+1,j,k,0) = xflux_hi;
@@ -627,8 +631,7 @@ void erf_fast_rhs_T (int step, int nrk,
         // We only add to the flux registers in the final RK step
         if (l_reflux && nrk == 2) {
             int strt_comp_reflux = 0;
-            // For now we don't reflux (rho theta) because it seems to create issues at c/f boundaries
-            int  num_comp_reflux = 1;
+            int  num_comp_reflux = 2;
             if (level < finest_level) {
                 fr_as_crse->CrseAdd(mfi,
                     {{AMREX_D_DECL(&(flux[0]), &(flux[1]), &(flux[2]))}},
@@ -6,6 +6,7 @@
 #include <TI_slow_headers.H>
 #include <EOS.H>
 #include <Utils.H>
+#include <TileTuning.H>
 
 using namespace amrex;
 
@@ -32,6 +33,9 @@ void erf_make_tau_terms (int level, int nrk,
 {
     BL_PROFILE_REGION("erf_make_tau_terms()");
 
+    // Time the loops of this kernel family while the tile sizes are being tuned
+    TileTuningTimer tile_timer(TileTuning::Family::Diffusion, level);
+
     const BCRec* bc_ptr_h = domain_bcs_type_h.data();
 
     DiffChoice dc = solverChoice.diffChoice;
@@ -86,7 +90,7 @@ void erf_make_tau_terms (int level, int nrk,
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-        for ( MFIter mfi(S_data[IntVars::cons],TileNoZ()); mfi.isValid(); ++mfi)
+        for ( MFIter mfi(S_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::Diffusion, level, true)); mfi.isValid(); ++mfi)
         {
             const Box& bx = mfi.tilebox();
             const Box& valid_bx = mfi.validbox();
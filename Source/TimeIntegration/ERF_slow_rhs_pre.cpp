@@ -6,6 +6,8 @@
 #include <TI_slow_headers.H>
 #include <EOS.H>
 #include <Utils.H>
+#include <TileTuning.H>
+#include <BoxCosts.H>
 
 using namespace amrex;
 
@@ -114,6 +116,9 @@ void erf_slow_rhs_pre (int level, int finest_level,
 {
     BL_PROFILE_REGION("erf_slow_rhs_pre()");
 
+    // Time the loops of this kernel family while the tile sizes are being tuned
+    TileTuningTimer tile_timer(TileTuning::Family::SlowRhs, level);
+
 #ifdef ERF_USE_EB
     amrex::ignore_unused(ax,ay,az,detJ);
 #endif
@@ -228,6 +233,9 @@ void erf_slow_rhs_pre (int level, int finest_level,
     Real* max_s_ptr = max_scal_d.data();
     Real* min_s_ptr = min_scal_d.data();
 
+    // Measured box costs for load balancing (nullptr unless load balancing is on)
+    LayoutData<Real>* costs = BoxCosts::find(S_data[IntVars::cons]);
+
     // *****************************************************************************
     // Define updates and fluxes in the current RK stage
     // *****************************************************************************
@@ -237,8 +245,10 @@ void erf_slow_rhs_pre (int level, int finest_level,
     {
     std::array<FArrayBox,AMREX_SPACEDIM> flux;
 
-    for ( MFIter mfi(S_data[IntVars::cons],TileNoZ()); mfi.isValid(); ++mfi)
+    for ( MFIter mfi(S_data[IntVars::cons],TileTuning::tile_size(TileTuning::Family::SlowRhs, level, true)); mfi.isValid(); ++mfi)
     {
+        BoxCostTimer cost_timer(costs, mfi);
+
         Box bx  = mfi.tilebox();
         Box tbx = mfi.nodaltilebox(0);
         Box tby = mfi.nodaltilebox(1);
@@ -734,12 +744,11 @@ void erf_slow_rhs_pre (int level, int finest_level,
 
         {
         BL_PROFILE("slow_rhs_pre_fluxreg");
-        // We only add to the flux registers in the final RK step
-        // NOTE: for now we are only refluxing density not (rho theta) since the latter seems to introduce
-        //       a problem at top and bottom boundaries
+        // We only add to the flux registers in the final RK step; these are the fluxes of
+        // density and (rho theta), the fast steps add the acoustic part of the same fluxes
         if (l_reflux && nrk == 2) {
             int strt_comp_reflux = (l_const_rho) ? 1 : 0;
-            int  num_comp_reflux = 1;
+            int  num_comp_reflux = RhoTheta_comp + 1 - strt_comp_reflux;
             if (level < finest_level) {
                 fr_as_crse->CrseAdd(mfi,
                     {{AMREX_D_DECL(&(flux[0]), &(flux[1]), &(flux[2]))}},
@@ -0,0 +1,47 @@
+#include <BoxCosts.H>
+
+using namespace amrex;
+
+Vector<std::unique_ptr<LayoutData<Real>>> BoxCosts::m_costs;
+
+void
+BoxCosts::define (int lev, const BoxArray& ba, const DistributionMapping& dm)
+{
+    if (m_costs.size() <= lev) m_costs.resize(lev+1);
+    m_costs[lev] = std::make_unique<LayoutData<Real>>(ba, dm);
+    reset(lev);
+}
+
+void
+BoxCosts::clear (int lev)
+{
+    if (lev < m_costs.size()) m_costs[lev].reset();
+}
+
+void
+BoxCosts::reset (int lev)
+{
+    if (lev < m_costs.size() && m_costs[lev]) {
+        for (MFIter mfi(*m_costs[lev]); mfi.isValid(); ++mfi) {
+            (*m_costs[lev])[mfi] = 0.0;
+        }
+    }
+}
+
+LayoutData<Real>*
+BoxCosts::get (int lev)
+{
+    return (lev < m_costs.size()) ? m_costs[lev].get() : nullptr;
+}
+
+LayoutData<Real>*
+BoxCosts::find (const FabArrayBase& fa)
+{
+    for (auto& costs : m_costs) {
+        if (costs && costs->DistributionMap() == fa.DistributionMap() &&
+                     costs->boxArray().CellEqual(fa.boxArray())) {
+            return costs.get();
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,327 @@
+#include <FieldStatistics.H>
+#include <IndexDefines.H>
+#include <EOS.H>
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_VisMF.H>
+
+#include <fstream>
+#include <sstream>
+
+using namespace amrex;
+
+namespace {
+    const char* source_names[] = {"density", "theta", "scalar", "qv", "qc",
+                                  "x_velocity", "y_velocity", "z_velocity", "magvel",
+                                  "pressure", "temp"};
+    constexpr int n_sources = sizeof(source_names) / sizeof(source_names[0]);
+}
+
+/**
+ * Read the variables and pairs to accumulate statistics for
+ *
+ * @param[in] pp_prefix    ParmParse prefix
+ * @param[in] nlevs_max    maximum number of levels
+ * @param[in] time_avg_vel add the cell-centered velocities and their magnitude
+ */
+void
+FieldStatistics::init (const std::string& pp_prefix, int nlevs_max, bool time_avg_vel)
+{
+    ParmParse pp(pp_prefix);
+
+    Vector<std::string> vars;
+    pp.queryarr("stats_vars", vars);
+    if (time_avg_vel) {
+        for (const auto& v : {"x_velocity", "y_velocity", "z_velocity", "magvel"}) {
+            vars.push_back(v);
+        }
+    }
+
+    Vector<std::string> covars;
+    pp.queryarr("stats_covars", covars);
+
+    // Every variable of a pair is accumulated too
+    for (const auto& pair : covars) {
+        auto sep = pair.find(':');
+        if (sep == std::string::npos) {
+            Abort("stats_covars entries must be of the form a:b, not " + pair);
+        }
+        vars.push_back(pair.substr(0,sep));
+        vars.push_back(pair.substr(sep+1));
+    }
+
+    m_vars.clear();
+    m_sources.clear();
+    for (const auto& v : vars) {
+        if (var_index(v) >= 0) continue;
+        int isrc = 0;
+        while (isrc < n_sources && v != source_names[isrc]) ++isrc;
+        if (isrc == n_sources) {
+            Abort("Statistics are not available for variable " + v);
+        }
+        m_vars.push_back(v);
+        m_sources.push_back(static_cast<Source>(isrc));
+    }
+
+    m_covars.clear();
+    for (const auto& pair : covars) {
+        auto sep = pair.find(':');
+        m_covars.emplace_back(var_index(pair.substr(0,sep)), var_index(pair.substr(sep+1)));
+    }
+
+    if (static_cast<int>(m_vars.size()) > max_vars || static_cast<int>(m_covars.size()) > max_vars) {
+        Abort("Statistics are limited to " + std::to_string(max_vars) + " variables and pairs");
+    }
+
+    m_plot_names.clear();
+    for (const auto& v : m_vars) {
+        m_plot_names.push_back(v + "_mean");
+        m_plot_names.push_back(v + "_var");
+        m_plot_names.push_back(v + "_min");
+        m_plot_names.push_back(v + "_max");
+    }
+    for (const auto& c : m_covars) {
+        m_plot_names.push_back(m_vars[c.first] + "_" + m_vars[c.second] + "_cov");
+    }
+
+    pp.query("stats_start_time", m_start_time);
+    pp.query("stats_window"    , m_window);
+
+    m_stats.resize(nlevs_max);
+    m_weight.resize(nlevs_max, 0.0);
+    m_window_start.resize(nlevs_max, 0.0);
+}
+
+int
+FieldStatistics::var_index (const std::string& var) const
+{
+    for (int n = 0; n < m_vars.size(); ++n) {
+        if (m_vars[n] == var) return n;
+    }
+    return -1;
+}
+
+void
+FieldStatistics::define (int lev, const BoxArray& ba, const DistributionMapping& dm)
+{
+    // The grids were only redistributed: keep the statistics
+    if (m_stats[lev] && m_stats[lev]->boxArray() == ba) {
+        if (m_stats[lev]->DistributionMap() != dm) {
+            auto stats_new = std::make_unique<MultiFab>(ba, dm, ncomp(), 0);
+            stats_new->ParallelCopy(*m_stats[lev], 0, 0, ncomp());
+            m_stats[lev] = std::move(stats_new);
+        }
+        return;
+    }
+
+    m_stats[lev] = std::make_unique<MultiFab>(ba, dm, ncomp(), 0);
+    m_stats[lev]->setVal(0.0);
+    m_weight[lev] = 0.0;
+    m_window_start[lev] = 0.0;
+}
+
+/**
+ * Weighted Welford update of the statistics with the state at the given time
+ *
+ * @param[in] lev  level of refinement
+ * @param[in] time time of the sample
+ * @param[in] dt   weight of the sample
+ * @param[in] cons conserved state
+ * @param[in] xvel x-velocity on faces
+ * @param[in] yvel y-velocity on faces
+ * @param[in] zvel z-velocity on faces
+ */
+void
+FieldStatistics::accumulate (int lev, Real time, Real dt,
+                             const MultiFab& cons,
+                             const MultiFab& xvel,
+                             const MultiFab& yvel,
+                             const MultiFab& zvel)
+{
+    if (!active() || time < m_start_time) return;
+
+    BL_PROFILE("FieldStatistics::accumulate()");
+
+    // Restart the statistics once the window has elapsed
+    if (m_window > 0. && m_weight[lev] > 0. && (time - m_window_start[lev]) >= m_window) {
+        m_weight[lev] = 0.0;
+    }
+    if (m_weight[lev] == 0.) {
+        m_window_start[lev] = time;
+    }
+
+    const bool first = (m_weight[lev] == 0.);
+    const Real w     = dt;
+    const Real a     = w / (m_weight[lev] + w);
+    m_weight[lev] += w;
+
+    const int nvars   = m_vars.size();
+    const int ncovars = m_covars.size();
+
+    GpuArray<int,max_vars> src;
+    GpuArray<int,max_vars> cov_a;
+    GpuArray<int,max_vars> cov_b;
+    for (int n = 0; n < nvars; ++n) {
+        src[n] = static_cast<int>(m_sources[n]);
+    }
+    for (int c = 0; c < ncovars; ++c) {
+        cov_a[c] = m_covars[c].first;
+        cov_b[c] = m_covars[c].second;
+    }
+
+    const int ncomp_cons = cons.nComp();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(*m_stats[lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& tbx = mfi.tilebox();
+
+        const Array4<Real      >& s = m_stats[lev]->array(mfi);
+        const Array4<Real const>& c = cons.const_array(mfi);
+        const Array4<Real const>& u = xvel.const_array(mfi);
+        const Array4<Real const>& v = yvel.const_array(mfi);
+        const Array4<Real const>& z = zvel.const_array(mfi);
+
+        ParallelFor(tbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            const Real rho      = c(i,j,k,Rho_comp);
+            const Real rhotheta = c(i,j,k,RhoTheta_comp);
+            const Real qv = (ncomp_cons > RhoQ1_comp) ? c(i,j,k,RhoQ1_comp)/rho : 0.0;
+            const Real qc = (ncomp_cons > RhoQ2_comp) ? c(i,j,k,RhoQ2_comp)/rho : 0.0;
+            const Real u_cc = 0.5 * (u(i,j,k) + u(i+1,j  ,k  ));
+            const Real v_cc = 0.5 * (v(i,j,k) + v(i  ,j+1,k  ));
+            const Real w_cc = 0.5 * (z(i,j,k) + z(i  ,j  ,k+1));
+
+            Real x[max_vars];
+            Real d[max_vars];
+            for (int n = 0; n < nvars; ++n) {
+                switch (src[n]) {
+                    case static_cast<int>(Source::Density):  x[n] = rho;                   break;
+                    case static_cast<int>(Source::Theta):    x[n] = rhotheta / rho;        break;
+                    case static_cast<int>(Source::Scalar):   x[n] = c(i,j,k,RhoScalar_comp) / rho; break;
+                    case static_cast<int>(Source::Qv):       x[n] = qv;                    break;
+                    case static_cast<int>(Source::Qc):       x[n] = qc;                    break;
+                    case static_cast<int>(Source::XVel):     x[n] = u_cc;                  break;
+                    case static_cast<int>(Source::YVel):     x[n] = v_cc;                  break;
+                    case static_cast<int>(Source::ZVel):     x[n] = w_cc;                  break;
+                    case static_cast<int>(Source::MagVel):
+                        x[n] = std::sqrt(u_cc*u_cc + v_cc*v_cc + w_cc*w_cc);
+                        break;
+                    case static_cast<int>(Source::Pressure): x[n] = getPgivenRTh(rhotheta, qv); break;
+                    default:                                 x[n] = getTgivenRandRTh(rho, rhotheta, qv);
+                }
+            }
+
+            for (int n = 0; n < nvars; ++n) {
+                if (first) {
+                    d[n] = 0.0;
+                    s(i,j,k,4*n  ) = x[n];
+                    s(i,j,k,4*n+1) = 0.0;
+                    s(i,j,k,4*n+2) = x[n];
+                    s(i,j,k,4*n+3) = x[n];
+                } else {
+                    d[n] = x[n] - s(i,j,k,4*n);
+                    s(i,j,k,4*n  ) += a * d[n];
+                    s(i,j,k,4*n+1) += w * d[n] * (x[n] - s(i,j,k,4*n));
+                    s(i,j,k,4*n+2)  = amrex::min(s(i,j,k,4*n+2), x[n]);
+                    s(i,j,k,4*n+3)  = amrex::max(s(i,j,k,4*n+3), x[n]);
+                }
+            }
+
+            // Co-moments use the old mean of the first and the new mean of the second variable
+            for (int n = 0; n < ncovars; ++n) {
+                const int ia = cov_a[n];
+                const int ib = cov_b[n];
+                if (first) {
+                    s(i,j,k,4*nvars+n) = 0.0;
+                } else {
+                    s(i,j,k,4*nvars+n) += w * d[ia] * (x[ib] - s(i,j,k,4*ib));
+                }
+            }
+        });
+    }
+}
+
+void
+FieldStatistics::get_plot_var (int lev, const std::string& name, MultiFab& mf, int dcomp) const
+{
+    const int nvars = m_vars.size();
+
+    int scomp = -1;
+    bool normalize = false;
+    for (int n = 0; n < nvars; ++n) {
+        if (name == m_vars[n] + "_mean") { scomp = 4*n;                     }
+        if (name == m_vars[n] + "_var" ) { scomp = 4*n+1; normalize = true; }
+        if (name == m_vars[n] + "_min" ) { scomp = 4*n+2;                   }
+        if (name == m_vars[n] + "_max" ) { scomp = 4*n+3;                   }
+    }
+    for (int n = 0; n < m_covars.size(); ++n) {
+        if (name == m_vars[m_covars[n].first] + "_" + m_vars[m_covars[n].second] + "_cov") {
+            scomp = 4*nvars+n; normalize = true;
+        }
+    }
+    AMREX_ALWAYS_ASSERT(scomp >= 0);
+
+    if (!m_stats[lev] || m_weight[lev] == 0.) {
+        mf.setVal(0.0, dcomp, 1, 0);
+        return;
+    }
+
+    MultiFab::Copy(mf, *m_stats[lev], scomp, dcomp, 1, 0);
+    if (normalize) {
+        mf.mult(1.0/m_weight[lev], dcomp, 1, 0);
+    }
+}
+
+void
+FieldStatistics::get_mean (int lev, const std::string& var, MultiFab& mf, int dcomp) const
+{
+    get_plot_var(lev, var + "_mean", mf, dcomp);
+}
+
+/**
+ * Write the statistics of a level, together with the accumulated weight
+ * and the start of the current window, to the checkpoint
+ */
+void
+FieldStatistics::WriteCheckpoint (int lev, const std::string& checkpointname) const
+{
+    if (!active()) return;
+
+    VisMF::Write(*m_stats[lev], MultiFabFileFullPrefix(lev, checkpointname, "Level_", "Stats"));
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream info(MultiFabFileFullPrefix(lev, checkpointname, "Level_", "StatsInfo"));
+        info.precision(17);
+        info << ncomp() << "\n" << m_weight[lev] << "\n" << m_window_start[lev] << "\n";
+    }
+}
+
+void
+FieldStatistics::ReadCheckpoint (int lev, const std::string& checkpointname)
+{
+    if (!active()) return;
+
+    const std::string info_file = MultiFabFileFullPrefix(lev, checkpointname, "Level_", "StatsInfo");
+    if (!FileSystem::Exists(info_file)) {
+        Warning("No statistics in the checkpoint; starting them from scratch");
+        return;
+    }
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(info_file, fileCharPtr);
+    std::istringstream is(fileCharPtr.dataPtr(), std::istringstream::in);
+
+    int chk_ncomp;
+    is >> chk_ncomp;
+    if (chk_ncomp != ncomp()) {
+        Warning("Statistics in the checkpoint do not match stats_vars; starting them from scratch");
+        return;
+    }
+    is >> m_weight[lev] >> m_window_start[lev];
+
+    VisMF::Read(*m_stats[lev], MultiFabFileFullPrefix(lev, checkpointname, "Level_", "Stats"));
+}
@@ -0,0 +1,73 @@
+#include <Utils.H>
+
+using namespace amrex;
+
+/**
+ * Average components [icomp, icomp+ncomp) of mf over the horizontal planes of domain.
+ *
+ * All components are summed into one table of ncomp x nz partial sums in a single
+ * kernel per box, with one thread per column and a block reduction per level, and
+ * the table is summed across ranks with a single reduction, so the cost is
+ * independent of the number of profiles requested.
+ *
+ * @param[in] mf     data to average; cell-centered or nodal in z to match domain
+ * @param[in] icomp  first component to average
+ * @param[in] ncomp  number of components to average
+ * @param[in] domain box whose xy-extent defines the planes and z-extent the profile
+ * @return profile n at level k is stored at [n*nz + k-klo]
+ */
+Gpu::HostVector<Real>
+HorizontalAverages (const MultiFab& mf, int icomp, int ncomp, const Box& domain)
+{
+    const int klo  = domain.smallEnd(2);
+    const int nz   = domain.length(2);
+    const int ntot = nz * ncomp;
+
+    Gpu::DeviceVector<Real> d_sum(ntot, Real(0.0));
+    Real* sum_ptr = d_sum.data();
+
+    // Points shared by boxes of nodal data are only counted by their owner
+    std::unique_ptr<iMultiFab> owner_mask;
+    if (!mf.ixType().cellCentered()) {
+        owner_mask = mf.OwnerMask();
+    }
+
+    // No tiling and no OpenMP here: on the host the boxes are visited one at a
+    // time and the adds below need not be atomic
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const Box bx = mfi.validbox() & domain;
+        if (!bx.ok()) continue;
+        const Array4<Real const>& fab = mf.const_array(mfi, icomp);
+        const Array4<int  const>& msk = (owner_mask) ? owner_mask->const_array(mfi) :
+                                                        Array4<int const>{};
+
+        // One thread per column; each level of the column is summed within the
+        // block first, so a block makes one atomic add per level and component
+        // rather than one per cell (as in PlaneAverage)
+        const Box bx2d = makeSlab(bx, 2, bx.smallEnd(2));
+        const int kb = bx.smallEnd(2);
+        const int ke = bx.bigEnd(2);
+        ParallelFor(Gpu::KernelInfo().setReduction(true), bx2d,
+        [=] AMREX_GPU_DEVICE (int i, int j, int, Gpu::Handler const& handler) noexcept
+        {
+            // NOTE: Masked points add zero so that all threads take part in the reduction
+            for (int k = kb; k <= ke; ++k) {
+                const Real fac = (!msk || msk(i,j,k)) ? 1.0 : 0.0;
+                for (int n = 0; n < ncomp; ++n) {
+                    Gpu::deviceReduceSum(&sum_ptr[n*nz + k-klo], fac*fab(i,j,k,n), handler);
+                }
+            }
+        });
+    }
+
+    Gpu::HostVector<Real> h_avg(ntot);
+    Gpu::copy(Gpu::deviceToHost, d_sum.begin(), d_sum.end(), h_avg.begin());
+
+    ParallelDescriptor::ReduceRealSum(h_avg.data(), ntot);
+
+    const Real area_z = static_cast<Real>(domain.length(0)) * static_cast<Real>(domain.length(1));
+    for (auto& v : h_avg) { v /= area_z; }
+
+    return h_avg;
+}
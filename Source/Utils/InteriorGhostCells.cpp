@@ -544,15 +544,20 @@ realbdy_compute_interior_ghost_rhs (const std::string& /*init_type*/,
 /**
  * Compute the RHS in the fine relaxation zone
  *
+ * The target of the relaxation is the coarse data that the fill patchers have
+ * interpolated onto the band of the fine grids along the coarse-fine boundary,
+ * blended in time; the weight of each cell is the one the patchers computed when
+ * they were defined.  Each variable is then relaxed with one pass over the band,
+ * without any copy of the fine data.  The RHS is zeroed in the set zone.
+ *
  * @param[in]  time      current time
  * @param[in]  delta_t   timestep
  * @param[in]  width     number of cells in (relaxation+specified) zone
  * @param[in]  set_width number of cells in (specified) zone
  * @param[in]  FPr_c     cons fine patch container
- * @param[in]  FPr_u     uvel fine patch container
- * @param[in]  FPr_v     vvel fine patch container
- * @param[in]  FPr_w     wvel fine patch container
- * @param[in]  boxes_at_level boxes at current level
+ * @param[in]  FPr_u     xmom fine patch container
+ * @param[in]  FPr_v     ymom fine patch container
+ * @param[in]  FPr_w     zmom fine patch container
  * @param[in]  domain_bcs_type boundary condition types
  * @param[out] S_rhs     RHS to be computed here
  * @param[in]  S_data    current value of the solution
@@ -562,288 +567,85 @@ fine_compute_interior_ghost_rhs (const Real& time,
                                  const Real& delta_t,
                                  const int& width,
                                  const int& set_width,
-                                 const Geometry& geom,
+                                 const Geometry& /*geom*/,
                                  ERFFillPatcher* FPr_c,
                                  ERFFillPatcher* FPr_u,
                                  ERFFillPatcher* FPr_v,
                                  ERFFillPatcher* FPr_w,
-                                 Vector<BCRec>& domain_bcs_type,
+                                 Vector<BCRec>& /*domain_bcs_type*/,
                                  Vector<MultiFab>& S_rhs_f,
                                  Vector<MultiFab>& S_data_f)
 {
     BL_PROFILE_REGION("fine_compute_interior_ghost_RHS()");
 
+    // The weights of the relaxation zone already hold its width
+    amrex::ignore_unused(width, set_width);
+
     // Relaxation constants
     Real F1 = 1./(10.*delta_t);
     Real F2 = 1./(50.*delta_t);
 
-    // Vector of MFs to hold data (dm differs w/ fine patch)
-    Vector<MultiFab> fmf_p_v;
+    // The patchers hold the conserved variables: density-weighted scalars and momenta
+    Array<ERFFillPatcher*,IntVars::NumTypes> FPr = {FPr_c, FPr_u, FPr_v, FPr_w};
 
     // Loop over the variables
     for (int ivar_idx = 0; ivar_idx < IntVars::NumTypes; ++ivar_idx)
     {
-        // Fine mfs
-        MultiFab& fmf = S_data_f[ivar_idx];
-        MultiFab& rhs = S_rhs_f [ivar_idx];
-
-        // NOTE: These temporary MFs and copy operations are horrible
-        //       for memory usage and efficiency. However, we need to
-        //       have access to ghost cells in the cons array to convert
-        //       from primitive u/v/w to momentum. Furthermore, the BA
-        //       for the fine patches in ERFFillPatcher don't match the
-        //       BA for the data/RHS. For this reason, the data is copied
-        //       to a vector of MFs (with ghost cells) so the BAs match
-        //       the BA of data/RHS and we have access to rho to convert
-        //       prim to conserved.
-
-        // Temp MF on box (distribution map differs w/ fine patch)
-        int num_var = fmf.nComp();
-        fmf_p_v.emplace_back(fmf.boxArray(), fmf.DistributionMap(), num_var, fmf.nGrowVect());
-        MultiFab& fmf_p = fmf_p_v[ivar_idx];
-        MultiFab::Copy(fmf_p,fmf, 0, 0, num_var, fmf.nGrowVect());
-
-        // Integer mask MF
-        int set_mask_val;
-        int relax_mask_val;
-        iMultiFab* mask;
-
-        // Fill fine patch on interior halo region
-        //==========================================================
-        if (ivar_idx == IntVars::cons)
-        {
-            FPr_c->FillRelax(fmf_p, time, void_bc, domain_bcs_type);
-            mask           = FPr_c->GetMask();
-            set_mask_val   = FPr_c->GetSetMaskVal();
-            relax_mask_val = FPr_c->GetRelaxMaskVal();
-        }
-        else if (ivar_idx == IntVars::xmom)
-        {
-            FPr_u->FillRelax(fmf_p, time, void_bc, domain_bcs_type);
-            mask           = FPr_u->GetMask();
-            set_mask_val   = FPr_u->GetSetMaskVal();
-            relax_mask_val = FPr_u->GetRelaxMaskVal();
+        ERFFillPatcher* fpr = FPr[ivar_idx];
 
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(fmf_p,TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                Box vbx = mfi.validbox();
-
-                const Array4<Real>& prim_arr = fmf_p.array(mfi);
-                const Array4<const Real>& rho_arr  = fmf_p_v[0].const_array(mfi);
-                const Array4<const int>&  mask_arr = mask->const_array(mfi);
+        // No fine grid touches the coarse-fine boundary
+        if (!fpr->GetFineDataOld()) continue;
 
-                ParallelFor(vbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    if (mask_arr(i,j,k) == relax_mask_val) {
-                        Real rho_interp = 0.5 * ( rho_arr(i-1,j,k) + rho_arr(i,j,k) );
-                        prim_arr(i,j,k) *= rho_interp;
-                    }
-                });
-            } // mfi
-        }
-        else if (ivar_idx == IntVars::ymom)
-        {
-            FPr_v->FillRelax(fmf_p, time, void_bc, domain_bcs_type);
-            mask           = FPr_v->GetMask();
-            set_mask_val   = FPr_v->GetSetMaskVal();
-            relax_mask_val = FPr_v->GetRelaxMaskVal();
+        MultiFab& rhs        = S_rhs_f [ivar_idx];
+        const MultiFab& data = S_data_f[ivar_idx];
 
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(fmf_p,TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                Box vbx = mfi.validbox();
+        const MultiFab& fine_old = *fpr->GetFineDataOld();
+        const MultiFab& fine_new = *fpr->GetFineDataNew();
+        const MultiFab*      wgt = fpr->GetRelaxWeight();
+        const iMultiFab*    mask = fpr->GetMask();
+        int set_mask_val = fpr->GetSetMaskVal();
 
-                const Array4<Real>& prim_arr = fmf_p.array(mfi);
-                const Array4<const Real>& rho_arr  = fmf_p_v[0].const_array(mfi);
-                const Array4<const int>&  mask_arr = mask->const_array(mfi);
+        int num_var = std::min(rhs.nComp(), fine_old.nComp());
 
-                ParallelFor(vbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    if (mask_arr(i,j,k) == relax_mask_val) {
-                        Real rho_interp = 0.5 * ( rho_arr(i,j-1,k) + rho_arr(i,j,k) );
-                        prim_arr(i,j,k) *= rho_interp;
-                    }
-                });
-            } // mfi
-        }
-        else if (ivar_idx == IntVars::zmom)
-        {
-            FPr_w->FillRelax(fmf_p, time, void_bc, domain_bcs_type);
-            mask           = FPr_w->GetMask();
-            set_mask_val   = FPr_w->GetSetMaskVal();
-            relax_mask_val = FPr_w->GetRelaxMaskVal();
+        // Time interpolation factors
+        Real fac_old, fac_new;
+        fpr->GetTimeWeights(time, fac_old, fac_new);
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-            for ( MFIter mfi(fmf_p,TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                Box vbx = mfi.validbox();
-
-                const Array4<Real>& prim_arr = fmf_p.array(mfi);
-                const Array4<const Real>& rho_arr  = fmf_p_v[0].const_array(mfi);
-                const Array4<const int>&  mask_arr = mask->const_array(mfi);
-
-                ParallelFor(vbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    if (mask_arr(i,j,k) == relax_mask_val) {
-                        Real rho_interp = 0.5 * ( rho_arr(i,j,k-1) + rho_arr(i,j,k) );
-                        prim_arr(i,j,k) *= rho_interp;
-                    }
-                });
-            } // mfi
-        } else {
-            Abort("Dont recognize this variable type in fine_compute_interior_ghost_RHS");
-        }
-
-
-        // Zero RHS in set region
-        //==========================================================
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
         for ( MFIter mfi(rhs,TilingIfNotGPU()); mfi.isValid(); ++mfi)
         {
-            Box vbx = mfi.validbox();
-            const Array4<Real>& rhs_arr  = rhs.array(mfi);
-            const Array4<const int>& mask_arr = mask->const_array(mfi);
-
-            ParallelFor(vbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                if (mask_arr(i,j,k) == set_mask_val) {
-                    rhs_arr(i,j,k) = 0.0;
-                }
-            });
-        } // mfi
-
-        // For Laplacian stencil
-        rhs.FillBoundary(geom.periodicity());
-
-
-        // Compute RHS in relaxation region
-        //==========================================================
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-        for ( MFIter mfi(fmf_p,TilingIfNotGPU()); mfi.isValid(); ++mfi)
-        {
-            Box vbx = mfi.validbox();
+            const Box& tbx = mfi.tilebox();
             const Array4<Real>&        rhs_arr = rhs.array(mfi);
-            const Array4<const Real>& fine_arr = fmf_p.const_array(mfi);
-            const Array4<const Real>& data_arr = fmf.const_array(mfi);
+            const Array4<const Real>& data_arr = data.const_array(mfi);
             const Array4<const int>&  mask_arr = mask->const_array(mfi);
 
-            const auto& vbx_lo = lbound(vbx);
-            const auto& vbx_hi = ubound(vbx);
+            for (int ib : fpr->GetBandIndex(mfi.index()))
+            {
+                const Box bx = tbx & fine_old.box(ib);
+                if (!bx.ok()) continue;
 
-            int icomp = 0;
+                const Array4<const Real>& old_arr = fine_old.const_array(ib);
+                const Array4<const Real>& new_arr = fine_new.const_array(ib);
+                const Array4<const Real>& wgt_arr = (wgt) ? wgt->const_array(ib) : Array4<const Real>{};
 
-            int Spec_z  = set_width;
-            int Relax_z = width - Spec_z;
-            Real num   = Real(Spec_z + Relax_z);
-            Real denom = Real(Relax_z - 1);
-            ParallelFor(vbx, num_var, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-            {
-               if (mask_arr(i,j,k) == relax_mask_val) {
-
-                   // Indices
-                   Real n_ind(-1); // Set to -1 to quiet compiler warning
-                   int ii(width-1); int jj(width-1);
-                   bool near_x_lo_wall(false); bool near_x_hi_wall(false);
-                   bool near_y_lo_wall(false); bool near_y_hi_wall(false);
-                   bool mask_x_found(false);   bool mask_y_found(false);
-
-                   // Near x-wall
-                   if ((i-vbx_lo.x) < width) {
-                       near_x_lo_wall = true;
-                       ii = i-vbx_lo.x;
-                       if (mask_arr(vbx_lo.x,j,k) == 2) mask_x_found = true;
-                   } else if ((vbx_hi.x-i) < width) {
-                       near_x_hi_wall = true;
-                       ii = vbx_hi.x-i;
-                       if (mask_arr(vbx_hi.x,j,k) == 2) mask_x_found = true;
-                   }
-
-                   // Near y-wall
-                   if ((j-vbx_lo.y) < width) {
-                       near_y_lo_wall = true;
-                       jj = j-vbx_lo.y;
-                       if (mask_arr(i,vbx_lo.y,k) == 2) mask_y_found = true;
-                   } else if ((vbx_hi.y-j) < width) {
-                       near_y_hi_wall = true;
-                       jj = vbx_hi.y-j;
-                       if (mask_arr(i,vbx_hi.y,k) == 2) mask_y_found = true;
-                   }
-
-                   // Found a nearby masked cell (valid n_ind)
-                   if (mask_x_found && mask_y_found) {
-                       n_ind = std::min(ii,jj) + 1.0;
-                   } else if (mask_x_found) {
-                       n_ind = ii + 1.0;
-                   } else if (mask_y_found) {
-                       n_ind = jj + 1.0;
-                   // Pesky corner cell
-                   } else {
-                       if (near_x_lo_wall || near_x_hi_wall) {
-                           Real dj_min{width-1.0};
-                           int j_lb = std::max(vbx_lo.y,j-width);
-                           int j_ub = std::min(vbx_hi.y,j+width);
-                           int li   = (near_x_lo_wall) ? vbx_lo.x : vbx_hi.x;
-                           for (int lj(j_lb); lj<=j_ub; ++lj) {
-                               if (mask_arr(li,lj,k) == 2) {
-                                   mask_y_found = true;
-                                   dj_min = std::min(dj_min,(Real) std::abs(lj-j));
-                               }
-                           }
-                           if (mask_y_found) {
-                               Real mag = sqrt( Real(dj_min*dj_min + ii*ii) );
-                               n_ind = std::min(mag,width-1.0) + 1.0;
-                           } else {
-                               Abort("Mask not found near x wall!");
-                           }
-                       } else if (near_y_lo_wall || near_y_hi_wall) {
-                           Real di_min{width-1.0};
-                           int i_lb = std::max(vbx_lo.x,i-width);
-                           int i_ub = std::min(vbx_hi.x,i+width);
-                           int lj   = (near_y_lo_wall) ? vbx_lo.y : vbx_hi.y;
-                           for (int li(i_lb); li<=i_ub; ++li) {
-                               if (mask_arr(li,lj,k) == 2) {
-                                   mask_x_found = true;
-                                   di_min = std::min(di_min,(Real) std::abs(li-i));
-                               }
-                           }
-                           if (mask_x_found) {
-                               Real mag = sqrt( Real(di_min*di_min + jj*jj) );
-                               n_ind = std::min(mag,width-1.0) + 1.0;
-                           } else {
-                               Abort("Mask not found near y wall!");
-                           }
-                       } else {
-                           Abort("Relaxation cell must be near a wall!");
-                       }
-                   }
-
-                   Real Factor   = (num - n_ind)/denom;
-                   Real d        = data_arr(i  ,j  ,k  ,n+icomp) + delta_t*rhs_arr(i  , j  , k  ,n+icomp);
-                   Real d_ip1    = data_arr(i+1,j  ,k  ,n+icomp) + delta_t*rhs_arr(i+1, j  , k  ,n+icomp);
-                   Real d_im1    = data_arr(i-1,j  ,k  ,n+icomp) + delta_t*rhs_arr(i-1, j  , k  ,n+icomp);
-                   Real d_jp1    = data_arr(i  ,j+1,k  ,n+icomp) + delta_t*rhs_arr(i  , j+1, k  ,n+icomp);
-                   Real d_jm1    = data_arr(i  ,j-1,k  ,n+icomp) + delta_t*rhs_arr(i  , j-1, k  ,n+icomp);
-                   Real delta    = fine_arr(i  ,j  ,k,n) - d;
-                   Real delta_xp = fine_arr(i+1,j  ,k,n) - d_ip1;
-                   Real delta_xm = fine_arr(i-1,j  ,k,n) - d_im1;
-                   Real delta_yp = fine_arr(i  ,j+1,k,n) - d_jp1;
-                   Real delta_ym = fine_arr(i  ,j-1,k,n) - d_jm1;
-                   Real Laplacian = delta_xp + delta_xm + delta_yp + delta_ym - 4.0*delta;
-                   rhs_arr(i,j,k,n) += (F1*delta - F2*Laplacian) * Factor;
-               }
-            });
+                ParallelFor(bx, num_var, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+                {
+                    if (mask_arr(i,j,k) == set_mask_val) {
+                        rhs_arr(i,j,k,n) = 0.0;
+                    } else if (wgt_arr && wgt_arr(i,j,k) > 0.0) {
+                        // Departure of the solution from the target at the cell and its neighbors
+                        Real delta    = fac_old*old_arr(i  ,j  ,k,n) + fac_new*new_arr(i  ,j  ,k,n) - data_arr(i  ,j  ,k,n);
+                        Real delta_xp = fac_old*old_arr(i+1,j  ,k,n) + fac_new*new_arr(i+1,j  ,k,n) - data_arr(i+1,j  ,k,n);
+                        Real delta_xm = fac_old*old_arr(i-1,j  ,k,n) + fac_new*new_arr(i-1,j  ,k,n) - data_arr(i-1,j  ,k,n);
+                        Real delta_yp = fac_old*old_arr(i  ,j+1,k,n) + fac_new*new_arr(i  ,j+1,k,n) - data_arr(i  ,j+1,k,n);
+                        Real delta_ym = fac_old*old_arr(i  ,j-1,k,n) + fac_new*new_arr(i  ,j-1,k,n) - data_arr(i  ,j-1,k,n);
+                        Real Laplacian = delta_xp + delta_xm + delta_yp + delta_ym - 4.0*delta;
+                        rhs_arr(i,j,k,n) += (F1*delta - F2*Laplacian) * wgt_arr(i,j,k);
+                    }
+                });
+            } // ib
         } // mfi
     } // ivar_idx
 }
-
@@ -0,0 +1,129 @@
+#include <MemoryReport.H>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+    std::string to_mb (Long nbytes)
+    {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1) << static_cast<double>(nbytes) / (1024.0*1024.0);
+        return ss.str();
+    }
+}
+
+MemoryReport::MemoryReport (int nlevs)
+    : m_nlevs(nlevs), m_order(subsystems())
+{
+    for (const auto& name : m_order) {
+        m_bytes.emplace(name, Vector<Long>(m_nlevs, 0));
+    }
+}
+
+const Vector<std::string>&
+MemoryReport::subsystems ()
+{
+    static const Vector<std::string> names {
+        "state", "integrator scratch", "base state", "terrain", "map factors",
+        "diffusion", "surface layer", "microphysics", "land surface", "wind farm",
+        "radiation", "wave coupling", "thin body", "real boundary",
+        "coarse-fine patchers", "statistics"
+    };
+    return names;
+}
+
+void
+MemoryReport::add_bytes (const std::string& subsystem, int lev, Long bytes)
+{
+    auto it = m_bytes.find(subsystem);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(it != m_bytes.end(),
+                                     "MemoryReport: subsystem is not in MemoryReport::subsystems()");
+    it->second[lev] += bytes;
+}
+
+void
+MemoryReport::add (const std::string& subsystem, int lev, const MultiFab* mf)
+{
+    if (mf && mf->ok()) add_bytes(subsystem, lev, local_bytes(*mf));
+}
+
+void
+MemoryReport::add (const std::string& subsystem, int lev, const iMultiFab* mf)
+{
+    if (mf && mf->ok()) add_bytes(subsystem, lev, local_bytes(*mf));
+}
+
+void
+MemoryReport::add (const std::string& subsystem, int lev, const FArrayBox& fab)
+{
+    add_bytes(subsystem, lev, fab.nBytes());
+}
+
+Long
+MemoryReport::projected_bytes (const BoxArray& ba, const DistributionMapping& dm,
+                               int ncomp, const IntVect& ngrow)
+{
+    Long nbytes = 0;
+    const int myproc = ParallelDescriptor::MyProc();
+    for (int i = 0; i < ba.size(); ++i) {
+        if (dm[i] == myproc) {
+            nbytes += amrex::grow(ba[i],ngrow).numPts() * ncomp * sizeof(Real);
+        }
+    }
+    return nbytes;
+}
+
+Long
+MemoryReport::max_rank_bytes () const
+{
+    Long nbytes = TotalBytesAllocatedInFabs();
+    ParallelDescriptor::ReduceLongMax(nbytes);
+    return nbytes;
+}
+
+void
+MemoryReport::print () const
+{
+    // Local bytes of every row followed by the untracked and total bytes
+    const int nrows = m_order.size() * m_nlevs;
+    Vector<Long> local(nrows + 2, 0);
+    Long tracked = 0;
+    for (int s = 0; s < m_order.size(); ++s) {
+        const auto& b = m_bytes.at(m_order[s]);
+        for (int lev = 0; lev < m_nlevs; ++lev) {
+            local[s*m_nlevs+lev] = b[lev];
+            tracked += b[lev];
+        }
+    }
+    local[nrows  ] = std::max(Long(0), TotalBytesAllocatedInFabs() - tracked);
+    local[nrows+1] = TotalBytesAllocatedInFabs();
+
+    Vector<Long> sum(local);
+    Vector<Long> max(local);
+    ParallelDescriptor::ReduceLongSum(sum.data(), sum.size());
+    ParallelDescriptor::ReduceLongMax(max.data(), max.size());
+
+    Print() << "\nMemory of the persistent data (MB): total over "
+            << ParallelDescriptor::NProcs() << " ranks and maximum on one rank\n";
+    Print() << std::left << std::setw(24) << "subsystem" << std::right << std::setw(6) << "level"
+            << std::setw(14) << "total" << std::setw(14) << "max/rank" << "\n";
+    for (int s = 0; s < m_order.size(); ++s) {
+        for (int lev = 0; lev < m_nlevs; ++lev) {
+            const int row = s*m_nlevs + lev;
+            if (sum[row] == 0) continue;
+            Print() << std::left << std::setw(24) << m_order[s] << std::right << std::setw(6) << lev
+                    << std::setw(14) << to_mb(sum[row]) << std::setw(14) << to_mb(max[row]) << "\n";
+        }
+    }
+    Print() << std::left << std::setw(30) << "untracked fabs" << std::right
+            << std::setw(14) << to_mb(sum[nrows]) << std::setw(14) << to_mb(max[nrows]) << "\n";
+    Print() << std::left << std::setw(30) << "all fabs" << std::right
+            << std::setw(14) << to_mb(sum[nrows+1]) << std::setw(14) << to_mb(max[nrows+1]) << "\n"
+            << std::endl;
+}
@@ -1,11 +1,13 @@
 #include <Orbit.H>
 
 using namespace amrex;
+using yakl::fortran::parallel_for;
+using yakl::fortran::SimpleBounds;
 
 void
 zenith (int& calday,
-        amrex::MultiFab* clat,
-        amrex::MultiFab* clon,
+        const real1d& clat,
+        const real1d& clon,
         real1d& coszrs,
         int& ncol,
         const Real& eccen,
@@ -20,22 +22,12 @@ zenith (int& calday,
     // Populate delta & eccf
     shr_orb_decl(calday, eccen, mvelpp, lambm0, obliqr, delta, eccf);
 
-    // If we have a valid pointer, go through the whole machinery
-    if (clat) {
-        for (MFIter mfi(*clat); mfi.isValid(); ++mfi) {
-            const auto& tbx = mfi.tilebox();
-            auto nx = tbx.length(0);
-
-            auto lat_array = clat->array(mfi);
-            auto lon_array = clon->array(mfi);
-
-            // NOTE: lat/lon are 2D multifabs!
-            ParallelFor(tbx, [=] AMREX_GPU_DEVICE (int i, int j, int /*k*/)
-            {
-                auto icol = j*nx+i+1;
-                coszrs(icol) = shr_orb_cosz(calday, lat_array(i,j,0), lon_array(i,j,0), delta, uniform_angle);
-            });
-       }
+    // If we have the column positions, go through the whole machinery
+    if (clat.initialized()) {
+        parallel_for(SimpleBounds<1>(ncol), YAKL_LAMBDA (int icol)
+        {
+            coszrs(icol) = shr_orb_cosz(calday, clat(icol), clon(icol), delta, uniform_angle);
+        });
     }
     // Use constant value near center of USA or the uniform angle
     else {
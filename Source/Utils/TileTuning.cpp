@@ -0,0 +1,178 @@
+#include <TileTuning.H>
+
+#include <fstream>
+#include <sstream>
+
+#include <AMReX_FabArrayBase.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+int                 TileTuning::m_tuning_steps = 0;
+std::string         TileTuning::m_file;
+Vector<IntVect>     TileTuning::m_candidates;
+Vector<int>         TileTuning::m_step;
+Vector<std::array<IntVect,TileTuning::num_families>>        TileTuning::m_choice;
+Vector<std::array<Vector<Real>,TileTuning::num_families>>   TileTuning::m_time;
+Vector<Vector<int>> TileTuning::m_nsteps;
+
+namespace {
+    const char* family_names[] = {"slow_rhs", "fast_rhs", "diffusion"};
+
+    // Tile size that leaves a direction untiled
+    constexpr int untiled = 1024000;
+}
+
+void
+TileTuning::init (const std::string& pp_prefix, int nlevs_max)
+{
+    ParmParse pp(pp_prefix);
+    pp.query("tile_tuning_steps", m_tuning_steps);
+    pp.query("tile_tuning_file", m_file);
+
+    // Nothing to tune without tiling
+    if (!TilingIfNotGPU()) m_tuning_steps = 0;
+
+    Vector<int> cand;
+    pp.queryarr("tile_tuning_candidates", cand);
+    if (cand.empty()) {
+        cand = {untiled,  8,  8,
+                untiled, 16, 16,
+                untiled,  4,  4,
+                     64, 16, 16,
+                     32, 32,  8};
+    }
+    if (cand.size() % 3 != 0) {
+        Abort("erf.tile_tuning_candidates must have three integers per candidate");
+    }
+    m_candidates.clear();
+    for (int i = 0; i < cand.size(); i += 3) {
+        m_candidates.push_back(IntVect(cand[i], cand[i+1], cand[i+2]));
+    }
+    if (m_tuning_steps > 0 && m_tuning_steps < m_candidates.size()) {
+        Abort("erf.tile_tuning_steps must be at least the number of candidates");
+    }
+
+    m_step.assign(nlevs_max, 0);
+    m_choice.assign(nlevs_max, {});
+    m_time.assign(nlevs_max, {});
+    m_nsteps.assign(nlevs_max, Vector<int>(m_candidates.size(), 0));
+    for (auto& t : m_time) {
+        for (auto& tf : t) tf.assign(m_candidates.size(), 0.0);
+    }
+
+    // Use the shapes of an earlier tuning
+    if (m_tuning_steps == 0 && !m_file.empty() && TilingIfNotGPU())
+    {
+        std::ifstream is(m_file);
+        if (!is.good()) return;
+
+        std::string line;
+        while (std::getline(is, line)) {
+            std::istringstream ss(line);
+            std::string name; int lev; IntVect ts;
+            if (!(ss >> name >> lev >> ts[0] >> ts[1] >> ts[2])) continue;
+            if (lev < 0 || lev >= nlevs_max) continue;
+            for (int f = 0; f < num_families; ++f) {
+                if (name == family_names[f]) m_choice[lev][f] = ts;
+            }
+        }
+        Print() << "Read the tile sizes from " << m_file << std::endl;
+    }
+}
+
+int
+TileTuning::current_candidate (int lev)
+{
+    // The first step of a level is not timed; it includes setting up the level
+    return (m_step[lev] - 1) % m_candidates.size();
+}
+
+bool
+TileTuning::timing (int lev)
+{
+    return (m_tuning_steps > 0 && lev < m_step.size() &&
+            m_step[lev] >= 1 && m_step[lev] <= m_tuning_steps);
+}
+
+IntVect
+TileTuning::tile_size (Family family, int lev, bool no_z)
+{
+    if (!TilingIfNotGPU()) return IntVect::TheZeroVector();
+
+    IntVect ts(FabArrayBase::mfiter_tile_size);
+
+    if (lev < m_step.size()) {
+        const int f = static_cast<int>(family);
+        if (timing(lev)) {
+            ts = m_candidates[current_candidate(lev)];
+        } else if (m_choice[lev][f] != IntVect::TheZeroVector()) {
+            ts = m_choice[lev][f];
+        }
+    }
+
+    if (no_z) ts[2] = untiled;
+
+    return ts;
+}
+
+void
+TileTuning::add_time (Family family, int lev, Real elapsed)
+{
+    m_time[lev][static_cast<int>(family)][current_candidate(lev)] += elapsed;
+}
+
+void
+TileTuning::finish_step (int lev)
+{
+    if (m_tuning_steps <= 0 || lev >= m_step.size()) return;
+
+    if (timing(lev)) {
+        ++m_nsteps[lev][current_candidate(lev)];
+    }
+
+    ++m_step[lev];
+
+    if (m_step[lev] != m_tuning_steps+1) return;
+
+    // All ranks must pick the same shape; the slowest rank decides
+    const int ncand = m_candidates.size();
+    for (int f = 0; f < num_families; ++f)
+    {
+        Vector<Real>& t = m_time[lev][f];
+        ParallelDescriptor::ReduceRealMax(t.data(), ncand);
+
+        int best = -1;
+        Real tbest = 0.0;
+        for (int c = 0; c < ncand; ++c) {
+            if (m_nsteps[lev][c] == 0 || t[c] <= 0.0) continue;
+            Real tc = t[c] / m_nsteps[lev][c];
+            if (best < 0 || tc < tbest) { best = c; tbest = tc; }
+        }
+        if (best < 0) continue;
+
+        m_choice[lev][f] = m_candidates[best];
+        Print() << "Tile size at level " << lev << " for " << family_names[f] << ": "
+                << m_candidates[best] << " (" << tbest << " s per step)" << std::endl;
+    }
+
+    write_file();
+}
+
+void
+TileTuning::write_file ()
+{
+    if (m_file.empty() || !ParallelDescriptor::IOProcessor()) return;
+
+    std::ofstream os(m_file);
+    for (int lev = 0; lev < m_choice.size(); ++lev) {
+        for (int f = 0; f < num_families; ++f) {
+            const IntVect& ts = m_choice[lev][f];
+            if (ts == IntVect::TheZeroVector()) continue;
+            os << family_names[f] << " " << lev << " "
+               << ts[0] << " " << ts[1] << " " << ts[2] << "\n";
+        }
+    }
+}
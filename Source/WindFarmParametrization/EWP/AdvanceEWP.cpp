@@ -2,6 +2,7 @@
 #include <IndexDefines.H>
 #include <ERF_Constants.H>
 #include <Interpolation_1D.H>
+#include <BoxCosts.H>
 
 using namespace amrex;
 
@@ -27,7 +28,10 @@ EWP::update (const Real& dt_advance,
              const MultiFab& mf_vars_ewp)
 {
 
+    LayoutData<Real>* costs = BoxCosts::find(cons_in);
+
     for ( MFIter mfi(cons_in,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        BoxCostTimer cost_timer(costs, mfi);
 
         Box bx  = mfi.tilebox();
         Box tbx = mfi.nodaltilebox(0);
@@ -90,7 +94,10 @@ EWP::source_terms_cellcentered (const Geometry& geom,
   // The order of variables are - Vabs dVabsdt, dudt, dvdt, dTKEdt
   mf_vars_ewp.setVal(0.0);
 
+  LayoutData<Real>* costs = BoxCosts::find(cons_in);
+
   for ( MFIter mfi(cons_in,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        BoxCostTimer cost_timer(costs, mfi);
 
         const Box& gbx = mfi.growntilebox(1);
         auto ewp_array = mf_vars_ewp.array(mfi);
@@ -2,6 +2,7 @@
 #include <IndexDefines.H>
 #include <ERF_Constants.H>
 #include <Interpolation_1D.H>
+#include <BoxCosts.H>
 
 using namespace amrex;
 
@@ -66,7 +67,10 @@ Fitch::update (const Real& dt_advance,
                const MultiFab& mf_vars_fitch)
 {
 
+    LayoutData<Real>* costs = BoxCosts::find(cons_in);
+
     for ( MFIter mfi(cons_in,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        BoxCostTimer cost_timer(costs, mfi);
 
         Box bx  = mfi.tilebox();
         Box tbx = mfi.nodaltilebox(0);
@@ -128,7 +132,10 @@ Fitch::source_terms_cellcentered (const Geometry& geom,
     Gpu::copy(Gpu::hostToDevice, wind_speed.begin(), wind_speed.end(), d_wind_speed.begin());
     Gpu::copy(Gpu::hostToDevice, thrust_coeff.begin(), thrust_coeff.end(), d_thrust_coeff.begin());
 
+  LayoutData<Real>* costs = BoxCosts::find(cons_in);
+
   for ( MFIter mfi(cons_in,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        BoxCostTimer cost_timer(costs, mfi);
 
         const Box& gbx = mfi.growntilebox(1);
         auto fitch_array = mf_vars_fitch.array(mfi);
@@ -1,5 +1,6 @@
 #include <SimpleAD.H>
 #include <IndexDefines.H>
+#include <BoxCosts.H>
 
 using namespace amrex;
 
@@ -26,7 +27,10 @@ SimpleAD::update (const Real& dt_advance,
                   const MultiFab& mf_vars_simpleAD)
 {
 
+    LayoutData<Real>* costs = BoxCosts::find(cons_in);
+
     for ( MFIter mfi(cons_in,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        BoxCostTimer cost_timer(costs, mfi);
 
         Box tbx = mfi.nodaltilebox(0);
         Box tby = mfi.nodaltilebox(1);
@@ -87,7 +91,10 @@ SimpleAD::source_terms_cellcentered (const Geometry& geom,
       Real* d_yloc_ptr = d_yloc.data();
       long unsigned int nturbs = xloc.size();
 
+    LayoutData<Real>* costs = BoxCosts::find(cons_in);
+
     for ( MFIter mfi(cons_in,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        BoxCostTimer cost_timer(costs, mfi);
 
         const Box& gbx      = mfi.growntilebox(1);
         auto simpleAD_array = mf_vars_simpleAD.array(mfi);
@@ -73,6 +73,48 @@ function(add_test_0 TEST_NAME TEST_EXE PLTFILE)
     )
 endfunction(add_test_0)
 
+# Conservation test -- the multilevel sum of QUANTITY printed by sum_integrated_quantities
+# (erf.v = 1, erf.sum_interval = 1) must stay within the given relative tolerance of its first value
+function(add_test_m TEST_NAME TEST_EXE QUANTITY TOLERANCE)
+    setup_test()
+
+    set(TEST_EXE ${CMAKE_BINARY_DIR}/Exec/${TEST_EXE})
+    set(CHECK_SUM "awk -v tol=${TOLERANCE} '/${QUANTITY} *SL.ML =/ && !n++ { v0 = $NF } /${QUANTITY} *SL.ML =/ { v = $NF } END { exit !(n > 1 && ((v > v0) ? v - v0 : v0 - v) <= tol*v0) }' ${TEST_NAME}.log")
+    set(test_command sh -c "${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i ${RUNTIME_OPTIONS} > ${TEST_NAME}.log && ${CHECK_SUM}")
+
+    add_test(${TEST_NAME} ${test_command})
+    set_tests_properties(${TEST_NAME}
+        PROPERTIES
+        TIMEOUT 5400
+        PROCESSORS ${NP}
+        WORKING_DIRECTORY "${CURRENT_TEST_BINARY_DIR}/"
+        LABELS "regression"
+        ATTACHED_FILES_ON_FAIL "${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.log"
+    )
+endfunction(add_test_m)
+
+# Comparison test -- run once as is, into "ref" plotfiles, and once with the given
+# options, then compare the last plotfiles of both runs to the given relative tolerance
+function(add_test_c TEST_NAME TEST_EXE PLTFILE OPTIONS TOLERANCE)
+    setup_test()
+
+    set(TEST_EXE ${CMAKE_BINARY_DIR}/Exec/${TEST_EXE})
+    string(REPLACE "plt" "ref" REFFILE ${PLTFILE})
+    set(FCOMPARE_TOLERANCE "-r ${TOLERANCE} --abs_tol 1.0e-12")
+    set(FCOMPARE_FLAGS "--abort_if_not_all_found -a ${FCOMPARE_TOLERANCE}")
+    set(test_command sh -c "${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i erf.plot_file_1=ref ${RUNTIME_OPTIONS} > ${TEST_NAME}.log && ${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i ${OPTIONS} ${RUNTIME_OPTIONS} >> ${TEST_NAME}.log && ${MPI_FCOMP_COMMANDS} ${FCOMPARE_EXE} ${FCOMPARE_FLAGS} ${CURRENT_TEST_BINARY_DIR}/${REFFILE} ${CURRENT_TEST_BINARY_DIR}/${PLTFILE}")
+
+    add_test(${TEST_NAME} ${test_command})
+    set_tests_properties(${TEST_NAME}
+        PROPERTIES
+        TIMEOUT 5400
+        PROCESSORS ${NP}
+        WORKING_DIRECTORY "${CURRENT_TEST_BINARY_DIR}/"
+        LABELS "regression"
+        ATTACHED_FILES_ON_FAIL "${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.log"
+    )
+endfunction(add_test_c)
+
 #=============================================================================
 # Regression tests
 #=============================================================================
@@ -116,6 +158,16 @@ add_test_r(MoistBubble                       "RegTests/Bubble/*/erf_bubble.exe"
 
 add_test_0(Deardorff_stationary              "ABL/*/erf_abl.exe" "plt00010")
 
+add_test_c(MoistBubble_ZSplit                "RegTests/Bubble/*/erf_bubble.exe" "plt00010" "amr.max_grid_size_z=25" "1.0e-12")
+add_test_m(ScalarAdvection_AMR_Subcycle      "RegTests/ScalarAdvDiff/*/erf_scalar_advdiff.exe" "RHO SCALAR" "1.0e-12")
+add_test_c(ScalarAdvection_StaticNest        "RegTests/ScalarAdvDiff/*/erf_scalar_advdiff.exe" "plt00010" "amr.max_grid_size=16" "1.0e-12")
+
+add_test_c(MoistBubble_MicroInt              "RegTests/Bubble/*/erf_bubble.exe" "plt00010" "erf.micro_int=2" "5.0e-2")
+
+if(ERF_ENABLE_PARTICLES)
+add_test_r(SuperDropletBubble                "RegTests/Bubble/*/erf_bubble.exe" "plt00010")
+endif()
+
 else()
 #add_test_r(Bubble_DensityCurrent             "Bubble/bubble" "plt00010")
 add_test_r(CouetteFlow                       "RegTests/Couette_Poiseuille/erf_couette_poiseuille" "plt00050")
@@ -156,6 +208,16 @@ add_test_r(MoistBubble                       "RegTests/Bubble/erf_bubble" "plt00
 
 add_test_0(InitSoundingIdeal_stationary      "ABL/erf_abl" "plt00010")
 add_test_0(Deardorff_stationary              "ABL/erf_abl" "plt00010")
+
+add_test_c(MoistBubble_ZSplit                "RegTests/Bubble/erf_bubble" "plt00010" "amr.max_grid_size_z=25" "1.0e-12")
+add_test_m(ScalarAdvection_AMR_Subcycle      "RegTests/ScalarAdvDiff/erf_scalar_advdiff" "RHO SCALAR" "1.0e-12")
+add_test_c(ScalarAdvection_StaticNest        "RegTests/ScalarAdvDiff/erf_scalar_advdiff" "plt00010" "amr.max_grid_size=16" "1.0e-12")
+
+add_test_c(MoistBubble_MicroInt              "RegTests/Bubble/erf_bubble" "plt00010" "erf.micro_int=2" "5.0e-2")
+
+if(ERF_ENABLE_PARTICLES)
+add_test_r(SuperDropletBubble                "RegTests/Bubble/erf_bubble" "plt00010")
+endif()
 endif()
 #=============================================================================
 # Performance tests
@@ -0,0 +1,78 @@
+/*
+ * Unit test of the saturation table: the interpolated saturation pressures and
+ * their derivatives must stay within 2e-3 of the analytic fits, and the cost of
+ * a lookup is reported next to the fits and the EOS conversions it sits beside.
+ */
+#include <algorithm>
+
+#include <AMReX.H>
+#include <AMReX_Gpu.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <EOS.H>
+#include <SaturationTable.H>
+
+using namespace amrex;
+
+namespace {
+    // Run f on n points on the device and return the time per call in ns
+    template <typename F>
+    Real time_kernel (int n, F const& f)
+    {
+        Gpu::DeviceVector<Real> out(n);
+        Real* out_ptr = out.data();
+        const Real trange = SatLookup::thi - SatLookup::tlo;
+
+        Real best = 1.e30;
+        for (int rep = 0; rep < 5; ++rep) {
+            Gpu::streamSynchronize();
+            Real t0 = second();
+            ParallelFor(n, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                Real t = SatLookup::tlo + trange * (Real(i) + 0.5) / Real(n);
+                out_ptr[i] = f(t);
+            });
+            Gpu::streamSynchronize();
+            best = std::min(best, second() - t0);
+        }
+        return best / n * 1.e9;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    int status = 0;
+    {
+        // Accuracy against the analytic fits
+        for (int order : {1, 3}) {
+            Real err = SaturationTable::max_relative_error(order);
+            Print() << "Saturation table, order " << order << ": max relative error " << err << std::endl;
+            if (err > 2.0e-3) {
+                Print() << "  FAILED: larger than 2e-3" << std::endl;
+                status = 1;
+            }
+        }
+
+        // Cost of a lookup, of the fits and of the EOS conversion with std::pow
+        const int n = 1 << 22;
+        SaturationTable linear, cubic;
+        linear.define(1);
+        cubic.define(3);
+        SatLookup sat1 = linear.lookup();
+        SatLookup sat3 = cubic.lookup();
+
+        Real t_fit = time_kernel(n, [=] AMREX_GPU_DEVICE (Real t) { return erf_esatw(t); });
+        Real t_lin = time_kernel(n, [=] AMREX_GPU_DEVICE (Real t) { return sat1.esatw(t); });
+        Real t_cub = time_kernel(n, [=] AMREX_GPU_DEVICE (Real t) { return sat3.esatw(t); });
+        Real t_eos = time_kernel(n, [=] AMREX_GPU_DEVICE (Real t) { return getTgivenRandRTh(1.0, t, 0.01); });
+
+        Print() << "ns per call: fit " << t_fit << ", linear table " << t_lin
+                << ", cubic table " << t_cub << ", getTgivenRandRTh " << t_eos << std::endl;
+    }
+
+    amrex::Finalize();
+    return status;
+}
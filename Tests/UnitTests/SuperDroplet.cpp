@@ -0,0 +1,82 @@
+/*
+ * Unit test of the superdroplet droplet physics: the condensation update must keep
+ * a droplet on the Koehler curve in place and solve its implicit equation off it,
+ * and the coalescence of a pair must conserve water and solute with integer
+ * multiplicities.
+ */
+#include <cmath>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+
+#include <SuperDroplet_Utils.H>
+
+using namespace amrex;
+using namespace SuperDropletConstants;
+
+namespace {
+    int check (bool ok, const char* what)
+    {
+        Print() << (ok ? "  passed: " : "  FAILED: ") << what << std::endl;
+        return ok ? 0 : 1;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    int status = 0;
+    {
+        // Koehler coefficients of a NaCl aerosol of 0.05 micron at 283 K, one second step
+        const Real tabs = 283.0;
+        const Real rd   = 0.05e-6;
+        const Real m_s  = (4.0/3.0)*PI*rd*rd*rd*rho_solute;
+        const Real A    = 3.3e-7/tabs;
+        const Real B    = van_t_hoff*m_s*mw_water / ((4.0/3.0)*PI*rhor*mw_solute);
+        const Real c    = 2.0*1.0/1.0e10;
+
+        Print() << "Koehler growth" << std::endl;
+
+        // On the Koehler curve the droplet stays where it is
+        const Real r_eq = 1.0e-6;
+        const Real S_eq = 1.0 + A/r_eq - B/(r_eq*r_eq*r_eq);
+        Real R = sd_koehler_r2(r_eq*r_eq, m_s, S_eq, A, B, c);
+        status += check(std::abs(R/(r_eq*r_eq) - 1.0) < 1.0e-8, "equilibrium radius kept");
+
+        // Off it the update solves R - R_old = c (S - 1 - A/r + B/r^3)
+        for (Real S : {0.90, 1.01}) {
+            const Real R_old = r_eq*r_eq;
+            R = sd_koehler_r2(R_old, m_s, S, A, B, c);
+            const Real r = std::sqrt(R);
+            const Real res = R - R_old - c*(S - 1.0 - A/r + B/(R*r));
+            status += check(std::abs(res) <= 1.0e-8*R, "implicit equation solved");
+            status += check((S > S_eq) == (R > R_old), "grows when supersaturated, shrinks otherwise");
+            status += check(r*r*r >= sd_dry_r3(m_s), "wet radius not below the dry radius");
+        }
+
+        Print() << "Shima coalescence" << std::endl;
+
+        // Both branches: a keeps droplets, and a would be used up
+        struct Pair { Real gamma, mult_a, mult_b; };
+        for (Pair pr : {Pair{3.0, 100.0, 10.0}, Pair{2.0, 10.0, 10.0}, Pair{5.0, 7.0, 3.0}}) {
+            Real mult_a = pr.mult_a, rad_a = 10.0e-6, sol_a = m_s;
+            Real mult_b = pr.mult_b, rad_b = 30.0e-6, sol_b = 2.0*m_s;
+
+            const Real water  = mult_a*std::pow(rad_a,3) + mult_b*std::pow(rad_b,3);
+            const Real solute = mult_a*sol_a + mult_b*sol_b;
+
+            sd_coalesce_pair(pr.gamma, mult_a, rad_a, sol_a, mult_b, rad_b, sol_b);
+
+            const Real water_new  = mult_a*std::pow(rad_a,3) + mult_b*std::pow(rad_b,3);
+            const Real solute_new = mult_a*sol_a + mult_b*sol_b;
+            status += check(std::abs(water_new/water - 1.0) < 1.0e-12, "water conserved");
+            status += check(std::abs(solute_new/solute - 1.0) < 1.0e-12, "solute conserved");
+            status += check(mult_a == std::floor(mult_a) && mult_b == std::floor(mult_b) &&
+                            mult_a >= 0.0 && mult_b >= 1.0, "integer multiplicities");
+        }
+    }
+
+    amrex::Finalize();
+    return (status > 0) ? 1 : 0;
+}